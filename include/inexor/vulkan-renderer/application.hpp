@@ -2,6 +2,8 @@
 
 #include "inexor/vulkan-renderer/input/keyboard_mouse_data.hpp"
 #include "inexor/vulkan-renderer/renderer.hpp"
+#include "inexor/vulkan-renderer/world/collision.hpp"
+#include "inexor/vulkan-renderer/world/octree_mesher.hpp"
 
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan_core.h>
@@ -9,6 +11,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 // forward declarations
@@ -33,6 +36,13 @@ class Application : public VulkanRenderer {
 
     std::unique_ptr<input::KeyboardMouseInputData> m_input_data;
 
+    /// Keeps the octree geometry up to date, only edited regions are remeshed.
+    std::unique_ptr<world::OctreeMesher> m_octree_mesher;
+    /// Key and first index of every region in the octree index buffer, ordered by the keys.
+    std::vector<std::pair<world::OctreeMesher::RegionKey, std::uint32_t>> m_octree_region_indices;
+    /// Keeps the camera out of the octree geometry.
+    std::unique_ptr<world::OctreeCollider> m_camera_collider;
+
     // If the user specified command line argument "--stop-on-validation-message", the program will call std::abort();
     // after reporting a validation layer (error) message.
     bool m_stop_on_validation_message{false};
@@ -48,6 +58,8 @@ class Application : public VulkanRenderer {
     void update_imgui_overlay();
     void check_application_specific_features();
     void update_uniform_buffers();
+    /// Only draw the octree regions inside of the view frustum of the camera.
+    void update_octree_draw_ranges();
     void process_mouse_input();
     // TODO: Implement a method for processing keyboard input.
 
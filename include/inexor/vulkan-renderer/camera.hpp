@@ -40,6 +40,8 @@ private:
     glm::vec3 m_world_up{directions::DEFAULT_UP};
     glm::mat4 m_view_matrix;
     glm::mat4 m_perspective_matrix;
+    /// The planes of the view frustum, see frustum_planes().
+    std::array<glm::vec4, 6> m_frustum_planes;
 
     /// The camera's yaw angle.
     float m_yaw{0.0f};
@@ -82,6 +84,7 @@ private:
     void update_vectors();
 
     void update_matrices();
+    void update_frustum_planes();
 
     [[nodiscard]] bool is_moving() const;
 
@@ -224,5 +227,15 @@ public:
         }
         return m_perspective_matrix;
     }
+
+    /// @brief The planes of the view frustum in world space, extracted from the view and perspective matrix.
+    /// The order is left, right, bottom, top, near, far. The xyz components are the normalized normal pointing into
+    /// the frustum and w is the distance, a point p is inside of a plane if ``dot(plane.xyz, p) + plane.w >= 0``.
+    [[nodiscard]] const std::array<glm::vec4, 6> &frustum_planes() {
+        if (m_update_needed) {
+            update_matrices();
+        }
+        return m_frustum_planes;
+    }
 };
 }; // namespace inexor::vulkan_renderer
@@ -2,36 +2,49 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <vector>
 
+// forward declaration
+namespace inexor::vulkan_renderer::tools {
+class MappedFile;
+} // namespace inexor::vulkan_renderer::tools
+
 namespace inexor::vulkan_renderer::io {
 
 class ByteStream {
 protected:
     std::vector<std::uint8_t> m_buffer;
-
-    /// Read from file.
-    [[nodiscard]] static std::vector<std::uint8_t> read_file(const std::filesystem::path &path);
+    /// The content of the stream instead of m_buffer if it was read from a file. Copies of the stream share it.
+    std::shared_ptr<const tools::MappedFile> m_file;
 
 public:
     ByteStream() = default;
     explicit ByteStream(std::vector<std::uint8_t> buffer);
-    /// Read from file.
+    /// Read from file, the file is memory mapped and not copied.
+    /// @throws InexorException if the file could not be opened or read.
     explicit ByteStream(const std::filesystem::path &path);
+    /// View the content of a file.
+    explicit ByteStream(std::shared_ptr<const tools::MappedFile> file);
 
     [[nodiscard]] std::size_t size() const;
-    [[nodiscard]] const std::vector<std::uint8_t> &buffer() const;
+    [[nodiscard]] const std::uint8_t *data() const;
+    /// Write to file. The content is written to a temporary file next to it, which then replaces the file. Streams
+    /// which have mapped the old file keep reading its old content.
+    /// @throws IoException if the file could not be written.
+    void write_file(const std::filesystem::path &path) const;
 };
 
 class ByteStreamReader {
 private:
-    const ByteStream &m_stream;
     /// Stream iterator.
-    std::vector<std::uint8_t>::const_iterator m_iter;
+    const std::uint8_t *m_iter;
+    const std::uint8_t *m_end;
 
     void check_end(std::size_t size) const;
 
 public:
+    /// The stream must outlive the reader.
     explicit ByteStreamReader(const ByteStream &stream);
 
     [[nodiscard]] std::size_t remaining() const;
@@ -45,8 +58,6 @@ public:
 
 class ByteStreamWriter : public ByteStream {
 public:
-    using ByteStream::ByteStream;
-
     /// Generic write method.
     template <typename T>
     void write(const T &value);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace inexor::vulkan_renderer::io {
+
+/// Exchanges encoded EditDelta streams with another editor instance or a server, in the order in which they were sent.
+class DeltaTransport {
+public:
+    DeltaTransport() = default;
+    DeltaTransport(const DeltaTransport &) = delete;
+    DeltaTransport(DeltaTransport &&) = delete;
+    virtual ~DeltaTransport() = default;
+
+    DeltaTransport &operator=(const DeltaTransport &) = delete;
+    DeltaTransport &operator=(DeltaTransport &&) = delete;
+
+    /// Send a delta to the other side.
+    virtual void send(const ByteStream &delta) = 0;
+    /// Receive the next delta of the other side without waiting.
+    /// @return std::nullopt if no delta has arrived.
+    [[nodiscard]] virtual std::optional<ByteStream> receive() = 0;
+};
+
+/// One end of a connection within the process, for a server which runs in the editor process and for tests.
+/// Both ends can be used by different threads.
+class LoopbackTransport final : public DeltaTransport {
+private:
+    struct Channel {
+        std::mutex mutex;
+        std::deque<ByteStream> deltas;
+    };
+
+    std::shared_ptr<Channel> m_incoming;
+    std::shared_ptr<Channel> m_outgoing;
+
+    LoopbackTransport(std::shared_ptr<Channel> incoming, std::shared_ptr<Channel> outgoing);
+
+public:
+    /// Create both ends of a connection, what one end sends the other one receives.
+    [[nodiscard]] static std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> connect();
+
+    void send(const ByteStream &delta) override;
+    [[nodiscard]] std::optional<ByteStream> receive() override;
+};
+
+/// Appends the sent deltas to one file and reads the received deltas from another file, which the other side appends
+/// to. Every delta is stored with its size in front of it, deltas which are not completely written yet are received
+/// later. One file can also be replayed, for example to load the edits of a session.
+class FileTransport final : public DeltaTransport {
+public:
+    /// Maximum size of one delta, larger sizes in the received file are rejected before they are allocated.
+    static constexpr std::uint32_t MAX_DELTA_SIZE{std::uint32_t{1} << 26U};
+
+private:
+    std::filesystem::path m_send_path;
+    std::filesystem::path m_receive_path;
+    /// Position of the next delta in the received file.
+    std::uint64_t m_receive_offset{0};
+
+public:
+    /// @param send_path The file to append sent deltas to, it is created if it does not exist.
+    /// @param receive_path The file to read received deltas from, it may not exist yet.
+    FileTransport(std::filesystem::path send_path, std::filesystem::path receive_path);
+
+    /// @throws IoException if the delta is larger than MAX_DELTA_SIZE or the file could not be written.
+    void send(const ByteStream &delta) override;
+    /// @throws IoException if the size of the next delta is larger than MAX_DELTA_SIZE.
+    [[nodiscard]] std::optional<ByteStream> receive() override;
+};
+
+} // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// forward declaration
+namespace inexor::vulkan_renderer::world {
+class EditBatch;
+} // namespace inexor::vulkan_renderer::world
+
+// forward declaration
+namespace inexor::vulkan_renderer::io {
+class ByteStream;
+} // namespace inexor::vulkan_renderer::io
+
+namespace inexor::vulkan_renderer::io {
+
+/// Edits of an octree, which are sent to other editor instances or to a server instead of the whole octree.
+/// The edits are addressed by Morton codes, so they can be applied to every copy of the octree.
+/// Version 0 encoding after the identifier "Inexor Delta" and the version:
+/// - edits on disjoint cubes are ordered in pre-order, the edits within one cube and its children keep their order,
+/// - consecutive edits with the same operation and payload on consecutive Morton codes of one grid level are coalesced
+///   into a run, which is stored as one record,
+/// - a record is a tag byte with the operation (and the type of a set_type), the Morton code of its first cube as
+///   variable length difference to the last code of the previous record, the variable length run length and the
+///   payload of the operation.
+/// A brush stroke over neighboring cubes is therefore a few runs of a few bytes each.
+class EditDelta {
+public:
+    static constexpr std::uint32_t LATEST_VERSION{0};
+    /// Maximum number of edits of a decoded delta, larger deltas are rejected.
+    static constexpr std::size_t MAX_EDITS{std::size_t{1} << 20U};
+    /// Maximum number of edits per byte of a decoded delta. Runs are expanded while decoding, so a few bytes must not
+    /// be able to allocate MAX_EDITS edits.
+    static constexpr std::size_t MAX_EDITS_PER_BYTE{256};
+
+private:
+    enum class Operation : std::uint8_t { SET_TYPE, SET_INDENTATIONS, SET_INDENT, INDENT };
+
+    struct Edit {
+        world::MortonCode code;
+        Operation operation;
+        world::Cube::Type type;
+        std::uint8_t edge_id;
+        bool positive_direction;
+        std::uint8_t steps;
+        /// All indentations of SET_INDENTATIONS, the first one of SET_INDENT.
+        std::array<world::Indentation, world::Cube::EDGES> indentations;
+
+        /// Same operation and payload.
+        [[nodiscard]] bool same_operation(const Edit &other) const noexcept;
+    };
+
+    std::vector<Edit> m_edits;
+
+    [[nodiscard]] Edit &add(world::MortonCode code, Operation operation);
+    /// The edits in the order in which they are encoded.
+    [[nodiscard]] std::vector<Edit> encoding_order() const;
+
+public:
+    EditDelta() = default;
+    /// Decode a delta.
+    /// @throws IoException if the delta is invalid and std::runtime_error if it is truncated.
+    explicit EditDelta(const ByteStream &stream);
+
+    /// Record CubePool::set_type(), the cube is created if it does not exist.
+    void set_type(world::MortonCode code, world::Cube::Type new_type);
+    /// Record CubePool::set_indentations().
+    void set_indentations(world::MortonCode code,
+                          const std::array<world::Indentation, world::Cube::EDGES> &indentations);
+    /// Record CubePool::set_indent().
+    void set_indent(world::MortonCode code, std::uint8_t edge_id, world::Indentation indentation);
+    /// Record CubePool::indent().
+    void indent(world::MortonCode code, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+
+    /// Number of edits.
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    /// Drop all edits.
+    void clear() noexcept;
+
+    /// Encode the edits.
+    [[nodiscard]] ByteStream serialize(std::uint32_t version = LATEST_VERSION) const;
+    /// Add the edits to a batch, which applies them to the octree in one pass.
+    void apply(world::EditBatch &batch) const;
+};
+
+} // namespace inexor::vulkan_renderer::io
@@ -2,6 +2,7 @@
 
 #include "inexor/vulkan-renderer/io/octree_parser.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 
@@ -18,20 +19,21 @@ class ByteStream;
 namespace inexor::vulkan_renderer::io {
 
 class NXOCParser : public OctreeParser {
-private:
-    static constexpr std::uint32_t LATEST_VERSION{0};
+public:
+    static constexpr std::uint32_t LATEST_VERSION{1};
 
+private:
     /// Specific version serialization.
     template <std::size_t version>
-    [[nodiscard]] ByteStream serialize_impl(std::shared_ptr<const world::Cube> cube);
+    [[nodiscard]] ByteStream serialize_impl(const world::Cube &cube);
     /// Specific version deserialization.
     template <std::size_t version>
-    [[nodiscard]] std::shared_ptr<world::Cube> deserialize_impl(const ByteStream &stream);
+    [[nodiscard]] world::Cube deserialize_impl(const ByteStream &stream);
 
 public:
     /// Serialization of an octree.
-    [[nodiscard]] ByteStream serialize(std::shared_ptr<const world::Cube> cube, std::uint32_t version) final;
+    [[nodiscard]] ByteStream serialize(const world::Cube &cube, std::uint32_t version) final;
     /// Deserialization of an octree.
-    [[nodiscard]] std::shared_ptr<world::Cube> deserialize(const ByteStream &stream) final;
+    [[nodiscard]] world::Cube deserialize(const ByteStream &stream) final;
 };
 } // namespace inexor::vulkan_renderer::io
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 
@@ -18,9 +19,9 @@ namespace inexor::vulkan_renderer::io {
 class OctreeParser {
 public:
     /// Serialization of an octree.
-    [[nodiscard]] virtual ByteStream serialize(std::shared_ptr<const world::Cube> cube, std::uint32_t version) = 0;
+    [[nodiscard]] virtual ByteStream serialize(const world::Cube &cube, std::uint32_t version) = 0;
     /// Deserialization of an octree.
-    [[nodiscard]] virtual std::shared_ptr<world::Cube> deserialize(const ByteStream &stream) = 0;
+    [[nodiscard]] virtual world::Cube deserialize(const ByteStream &stream) = 0;
 };
 
 } // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+
+// forward declaration
+namespace inexor::vulkan_renderer::world {
+struct PreviewImage;
+} // namespace inexor::vulkan_renderer::world
+
+namespace inexor::vulkan_renderer::io {
+
+/// Encode an image as PNG, for example a preview of an octree. Use ByteStream::write_file() to store it.
+/// @throws IoException if the image could not be encoded.
+[[nodiscard]] ByteStream encode_png(const world::PreviewImage &image);
+
+} // namespace inexor::vulkan_renderer::io
@@ -370,6 +370,12 @@ private:
     std::vector<RenderStage *> m_stage_stack;
     std::vector<PhysicalStage *> m_phys_stage_stack;
 
+    // Fence for every swapchain image, signaled when the last submission of its command buffers finished.
+    std::vector<wrapper::Fence> m_frame_fences;
+
+    // Swapchain images whose command buffers must be recorded again before they are submitted the next time.
+    std::vector<bool> m_outdated_frames;
+
     // Resource to physical resource map.
     std::unordered_map<const RenderResource *, std::unique_ptr<PhysicalResource>> m_resource_map;
 
@@ -404,7 +410,7 @@ private:
     // Functions for building stage related vulkan objects.
     void alloc_command_buffers(const RenderStage *, PhysicalStage *) const;
     void build_pipeline_layout(const RenderStage *, PhysicalStage *) const;
-    void record_command_buffers(const RenderStage *, PhysicalStage *) const;
+    void record_command_buffer(const RenderStage *, PhysicalStage *, std::size_t image_index) const;
 
     // Functions for building graphics stage related vulkan objects.
     void build_render_pass(const GraphicsStage *, PhysicalGraphicsStage *) const;
@@ -434,10 +440,15 @@ public:
     /// @param target The resource to start the depth first search from
     void compile(const RenderResource &target);
 
+    /// @brief Records the command buffers of every swapchain image again before they are submitted the next time, e.g.
+    /// after data used by the on record callbacks changed
+    /// @note This does not wait for the device, only the command buffers of the frame being rendered are recorded
+    void invalidate_command_buffers();
+
     /// @brief Submits the command frame's command buffers for drawing
+    /// @note Waits until the previous submission of the frame's command buffers finished
     /// @param image_index The current frame, typically retrieved from vkAcquireNextImageKhr
-    void render(int image_index, VkSemaphore signal_semaphore, VkSemaphore wait_semaphore,
-                VkQueue graphics_queue) const;
+    void render(int image_index, VkSemaphore signal_semaphore, VkSemaphore wait_semaphore, VkQueue graphics_queue);
 };
 
 template <typename T>
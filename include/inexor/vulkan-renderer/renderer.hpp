@@ -31,6 +31,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace inexor::vulkan_renderer {
@@ -80,6 +81,8 @@ protected:
     std::vector<wrapper::ResourceDescriptor> m_descriptors;
     std::vector<OctreeGpuVertex> m_octree_vertices;
     std::vector<std::uint16_t> m_octree_indices;
+    /// First index and index count of the octree index ranges which are drawn.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> m_octree_draw_ranges;
 
     void setup_render_graph();
     void generate_octree_indices();
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "inexor/vulkan-renderer/tools/mapped_file.hpp"
+
 #include <cstdint>
+#include <optional>
 #include <string>
-#include <vector>
 
 namespace inexor::vulkan_renderer::tools {
 
@@ -10,11 +12,8 @@ namespace inexor::vulkan_renderer::tools {
 /// @todo Refactor into an RAII wrapper.
 class File {
 private:
-    /// The file data.
-    std::vector<char> m_file_data;
-
-    /// The size of the file.
-    std::size_t m_file_size{0};
+    /// The file data, memory mapped if possible.
+    std::optional<MappedFile> m_file;
 
 public:
     File() = default;
@@ -22,10 +21,10 @@ public:
     ~File() = default;
 
     /// @brief Return the size of the file.
-    [[nodiscard]] const std::size_t file_size() const;
+    [[nodiscard]] std::size_t file_size() const;
 
-    /// @brief Return the file's data.
-    [[nodiscard]] const std::vector<char> &file_data() const;
+    /// @brief Return the file's data, ``nullptr`` if no file is loaded.
+    [[nodiscard]] const char *file_data() const;
 
     /// @brief Load the entire file into memory.
     /// @param file_name The name of the file.
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// Read only view of the content of a file.
+/// The file is memory mapped, so it is neither copied nor read at once, the operating system loads the pages on their
+/// first access. If the platform does not support memory mapping or mapping fails, for example for an empty file, the
+/// file is read into memory with one read call instead. A mapped file must not be truncated while it is in use, a
+/// file has to be replaced instead like io::ByteStream::write_file() does. On Windows a mapped file cannot be replaced.
+class MappedFile {
+private:
+    const std::uint8_t *m_data{nullptr};
+    std::size_t m_size{0};
+    /// The content of the file if it is not mapped.
+    std::vector<std::uint8_t> m_buffer;
+    bool m_mapped{false};
+
+    /// Map the file, leaves the object unchanged if this fails.
+    void map(const std::filesystem::path &path);
+    /// Read the file into m_buffer.
+    void read(const std::filesystem::path &path);
+
+public:
+    /// @throws InexorException if the file could not be opened or read.
+    explicit MappedFile(const std::filesystem::path &path);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) noexcept;
+    ~MappedFile();
+
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    /// The content of the file, aligned for every fundamental type.
+    [[nodiscard]] const std::uint8_t *data() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    /// Is the file memory mapped or was it read into memory.
+    [[nodiscard]] bool mapped() const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::tools
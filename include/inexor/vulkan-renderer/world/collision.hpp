@@ -0,0 +1,79 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// The shape of a moving body, all points within the radius of the segment from start to end.
+/// A sphere is a capsule whose start and end are equal.
+struct Capsule {
+    glm::vec3 start;
+    glm::vec3 end;
+    float radius;
+};
+
+/// The first contact of a moving body with the octree.
+struct Contact {
+    Cube cube;
+    /// Fraction of the motion until the contact, in [0, 1].
+    float time;
+    /// Unit normal of the touched geometry, pointing towards the body.
+    glm::vec3 normal;
+};
+
+/// Maximum number of contacts of OctreeCollider::slide().
+constexpr std::size_t MAX_SLIDE_CONTACTS{4};
+
+struct SlideResult {
+    /// Displacement of the body, which slides along the touched geometry instead of entering it.
+    glm::vec3 motion;
+    /// Normals of the contacts in the order in which they were touched.
+    std::array<glm::vec3, MAX_SLIDE_CONTACTS> normals;
+    std::size_t contact_count;
+};
+
+/// Swept collision of capsules with the polygons of an octree.
+/// Only the geometry cubes within the bounds of the swept body are found with query_cubes(), and only their triangles
+/// which overlap these bounds are tested. A capsule is tested as a sphere at its start against the Minkowski sum of
+/// each triangle and the reversed capsule segment, which are eight triangles, so the contacts are exact for faces,
+/// edges and corners. The triangles are stored as structure of arrays and their planes are tested for four triangles
+/// per SSE2 instruction, the remaining triangles and all triangles on other platforms by scalar code. Edges and corners
+/// are only tested if the plane of a triangle is reached.
+/// Contacts which the body moves away from are ignored, so a body which is stuck in geometry can leave it.
+/// The collider keeps its buffers between calls, use one collider per thread for many bodies.
+class OctreeCollider {
+public:
+    /// Fraction of the radius which slide() keeps between the body and the geometry.
+    static constexpr float SKIN{0.01F};
+
+private:
+    Cube m_world;
+    /// The coordinate on axis a of corner c of the triangles is stored in m_corners[3 * c + a].
+    std::array<std::vector<float>, 9> m_corners;
+    /// The cube of each triangle.
+    std::vector<std::uint32_t> m_cubes;
+
+    void add_triangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, std::uint32_t cube);
+    /// Collect the triangles which the body may touch during the motion.
+    void collect_triangles(const Capsule &body, const glm::vec3 &motion);
+
+public:
+    /// @param world The cube to collide with, usually the root cube.
+    explicit OctreeCollider(Cube world);
+
+    /// Find the first contact of the body with the octree while it moves.
+    [[nodiscard]] std::optional<Contact> sweep(const Capsule &body, const glm::vec3 &motion);
+    /// Move the body up to the first contact and slide the rest of the motion along the touched geometry.
+    /// The motion stops after MAX_SLIDE_CONTACTS contacts.
+    [[nodiscard]] SlideResult slide(const Capsule &body, const glm::vec3 &motion);
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Vector whose elements are stored in pages which are shared between copies. Copying only copies the page table and
+/// a page is copied on the first write through a copy which shares it.
+/// Reading never copies, writing requires writable().
+/// @warning Copies can be used by different threads, but a single copy must not be written by multiple threads unless
+/// they write different elements of pages which are not shared.
+template <typename T, std::size_t PAGE_SIZE = 1024>
+class CowVector {
+private:
+    using Page = std::array<T, PAGE_SIZE>;
+
+    std::vector<std::shared_ptr<Page>> m_pages;
+    std::size_t m_size{0};
+
+public:
+    [[nodiscard]] const T &operator[](const std::size_t index) const noexcept {
+        assert(index < m_size);
+        return (*m_pages[index / PAGE_SIZE])[index % PAGE_SIZE];
+    }
+
+    /// Get the element for writing, copies its page if it is shared.
+    [[nodiscard]] T &writable(const std::size_t index) {
+        assert(index < m_size);
+        std::shared_ptr<Page> &page = m_pages[index / PAGE_SIZE];
+        if (page.use_count() > 1) {
+            page = std::make_shared<Page>(*page);
+        } else {
+            // A copy on another thread may just have released the page, its reads must be finished before writing.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return (*page)[index % PAGE_SIZE];
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    /// Grow the vector, new elements are default constructed.
+    void resize(const std::size_t size) {
+        assert(size >= m_size);
+        while (m_pages.size() * PAGE_SIZE < size) {
+            m_pages.push_back(std::make_shared<Page>());
+        }
+        m_size = size;
+    }
+
+    void push_back(T value) {
+        resize(m_size + 1);
+        writable(m_size - 1) = std::move(value);
+    }
+
+    /// Number of pages which are shared with other copies.
+    [[nodiscard]] std::size_t shared_pages() const noexcept {
+        std::size_t count = 0;
+        for (const auto &page : m_pages) {
+            count += page.use_count() > 1 ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -7,11 +7,13 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 // forward declaration
 namespace inexor::vulkan_renderer::world {
-class Cube;
+class CubePool;
 } // namespace inexor::vulkan_renderer::world
 
 // forward declaration
@@ -20,17 +22,47 @@ class ByteStream;
 class NXOCParser;
 } // namespace inexor::vulkan_renderer::io
 
-void swap(inexor::vulkan_renderer::world::Cube &lhs, inexor::vulkan_renderer::world::Cube &rhs) noexcept;
-
 namespace inexor::vulkan_renderer::world {
 
 /// std::vector<Polygon> can probably replaced with an array.
 using Polygon = std::array<glm::vec3, 3>;
 
-using PolygonCache = std::shared_ptr<std::vector<Polygon>>;
+/// Polygons of a geometry cube, two per face in the order x = 0, x = 1, y = 0, y = 1, z = 0, z = 1.
+using CubePolygons = std::array<Polygon, 12>;
+
+/// Read only view of contiguously stored polygons, like std::span.
+class PolygonSpan {
+private:
+    const Polygon *m_data{nullptr};
+    std::size_t m_size{0};
+
+public:
+    PolygonSpan() = default;
+    PolygonSpan(const Polygon *data, std::size_t size) noexcept : m_data(data), m_size(size) {}
+
+    [[nodiscard]] const Polygon *data() const noexcept {
+        return m_data;
+    }
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+    [[nodiscard]] const Polygon &operator[](const std::size_t index) const noexcept {
+        return m_data[index];
+    }
+    [[nodiscard]] const Polygon *begin() const noexcept {
+        return m_data;
+    }
+    [[nodiscard]] const Polygon *end() const noexcept {
+        return m_data + m_size;
+    }
+};
 
-class Cube : public std::enable_shared_from_this<Cube> {
-    friend void ::swap(Cube &lhs, Cube &rhs) noexcept;
+/// Handle to a cube stored in a CubePool.
+/// Copies of a handle refer to the same cube, use clone() to create an independent copy.
+class Cube {
     friend class io::NXOCParser;
 
 public:
@@ -39,7 +71,7 @@ public:
     /// Cube edges.
     static constexpr std::size_t EDGES{12};
     /// Cube Type.
-    enum class Type { EMPTY = 0b00U, SOLID = 0b01U, NORMAL = 0b10U, OCTANT = 0b11U };
+    enum class Type : std::uint8_t { EMPTY = 0b00U, SOLID = 0b01U, NORMAL = 0b10U, OCTANT = 0b11U };
 
     /// IDs of the children and edges which will be swapped to receive the rotation.
     /// To achieve a 90 degree rotation the 0th index have to be swapped with the 1st and the 1st with the 2nd, etc.
@@ -56,59 +88,49 @@ public:
     };
 
 private:
-    Type m_type{Type::SOLID};
-    float m_size{32};
-    glm::vec3 m_position{0.0F, 0.0F, 0.0F};
-
-    /// Root cube is empty.
-    std::weak_ptr<Cube> m_parent{};
-
-    /// Indentations, should only be used if it is a geometry cube.
-    std::array<Indentation, Cube::EDGES> m_indentations;
-    std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> m_childs;
-
-    /// Only geometry cube (Type::SOLID and Type::Normal) have a polygon cache.
-    mutable PolygonCache m_polygon_cache;
-    mutable bool m_polygon_cache_valid{false};
-
-    /// Removes all childs recursive.
-    void remove_childs();
-
-    /// Get the root to this cube.
-    [[nodiscard]] std::shared_ptr<Cube> root() noexcept;
-    /// Get the vertices of this cube. Use only on geometry cubes.
-    [[nodiscard]] std::array<glm::vec3, 8> vertices() const noexcept;
-
-    /// Optimized implementations of 90°, 180° and 270° rotations.
-    template <int Rotations>
-    void rotate(const RotationAxis::Type &axis);
+    std::shared_ptr<CubePool> m_pool;
+    std::uint32_t m_index{0};
 
 public:
-    /// Create a solid cube.
-    Cube() = default;
-    /// Create a solid cube.
+    /// Create a solid root cube.
+    Cube();
+    /// Create a solid root cube.
     Cube(float size, const glm::vec3 &position);
-    /// Create a solid cube.
-    Cube(std::weak_ptr<Cube> parent, float size, const glm::vec3 &position);
-    /// Use clone() to create an independent copy of a cube.
-    Cube(const Cube &rhs) = delete;
-    Cube(Cube &&rhs) noexcept;
-    ~Cube() = default;
-    Cube &operator=(Cube rhs);
-    /// Get child.
-    std::shared_ptr<Cube> operator[](std::size_t idx);
+    /// Create a handle to an existing cube of the pool.
+    Cube(std::shared_ptr<CubePool> pool, std::uint32_t index);
+    /// Do the handles refer to the same cube.
+    bool operator==(const Cube &rhs) const noexcept;
+    bool operator!=(const Cube &rhs) const noexcept;
     /// Get child.
-    const std::shared_ptr<const Cube> operator[](std::size_t idx) const;
+    [[nodiscard]] Cube operator[](std::size_t idx) const;
 
     /// Clone a cube, which has no relations to the current one or its children.
-    /// It will be a root cube.
-    [[nodiscard]] std::shared_ptr<Cube> clone() const;
+    /// It will be a root cube. Cloning a root cube is cheap, the clone shares its memory copy on write.
+    [[nodiscard]] Cube clone() const;
 
+    /// The pool which stores this cube.
+    [[nodiscard]] const std::shared_ptr<CubePool> &pool() const noexcept;
+    /// Index of this cube in its pool.
+    [[nodiscard]] std::uint32_t index() const noexcept;
+
+    /// Get the root to this cube.
+    [[nodiscard]] Cube root() const noexcept;
     /// Is the current cube root.
     [[nodiscard]] bool is_root() const noexcept;
     /// At which child level this cube is.
     /// root cube = 0
     [[nodiscard]] std::size_t grid_level() const noexcept;
+    /// Edge length of this cube.
+    [[nodiscard]] float size() const noexcept;
+    /// Position of the (0, 0, 0) corner of this cube.
+    [[nodiscard]] glm::vec3 position() const noexcept;
+    /// Z-order address of this cube, see MortonCode. A code has room for 21 levels (MAX_MORTON_LEVEL), deeper cubes
+    /// have no address and cannot be edited through EditBatch, EditJournal or EditDelta.
+    /// @return std::nullopt if the cube is deeper than grid level 21.
+    [[nodiscard]] std::optional<std::uint64_t> morton_code() const noexcept;
+    /// Find the deepest cube of the octree which contains the position, but not deeper than max_level and level 21.
+    /// @return std::nullopt if the position is outside of the root cube.
+    [[nodiscard]] std::optional<Cube> cube_at(const glm::vec3 &position, std::size_t max_level) const;
     /// Count the number of Type::SOLID and Type::NORMAL cubes.
     [[nodiscard]] std::size_t count_geometry_cubes() const noexcept;
 
@@ -117,8 +139,8 @@ public:
     /// Get type.
     [[nodiscard]] Type type() const noexcept;
 
-    /// Get childs.
-    [[nodiscard]] const std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> &childs() const;
+    /// Get childs. Use only on octants.
+    [[nodiscard]] std::array<Cube, Cube::SUB_CUBES> childs() const;
     /// Get indentations.
     [[nodiscard]] std::array<Indentation, Cube::EDGES> indentations() const noexcept;
 
@@ -133,14 +155,16 @@ public:
     /// @param rotations Value does not need to be adjusted beforehand. (e.g. mod 4)
     void rotate(const RotationAxis::Type &axis, int rotations);
 
-    /// TODO: in special cases some polygons have no surface, if completely surrounded by others
+    /// The cache always contains all polygons, OctreeMesher removes the faces hidden by neighbors.
     /// \warning Will update the cache even if it is considered as valid.
     void update_polygon_cache() const;
     /// Invalidate polygon cache.
     void invalidate_polygon_cache() const;
     /// Recursive way to collect all the caches.
-    /// @param update_invalid If true it will update invalid polygon caches.
-    [[nodiscard]] std::vector<PolygonCache> polygons(bool update_invalid = false) const;
+    /// @param update_invalid If true it will update invalid polygon caches, otherwise cubes with invalid caches are
+    /// skipped.
+    /// @return Views into the polygon storage of the pool, which are valid until the octree is edited.
+    [[nodiscard]] std::vector<PolygonSpan> polygons(bool update_invalid = false) const;
 };
 
 } // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cow_vector.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Contiguous node storage of one octree, Cube is only a handle into it.
+/// All nodes are addressed by 32-bit indices. The eight children of an octant are allocated as one block of
+/// consecutive nodes, therefore every node only stores its type bits, the index of its parent and a single data index.
+/// The data index is the first child of a Type::OCTANT or the leaf payload (indentations and polygon cache) of a
+/// Type::SOLID or Type::NORMAL cube. Positions and sizes are not stored, they are derived from the path to the root.
+/// Every edit marks the cube and its parents as dirty and keeps the geometry counts of all parents up to date, which
+/// costs O(depth). Remeshing only has to visit dirty subtrees.
+/// All arrays are copy on write, a copy of a pool shares all memory with the original until either of them is edited.
+/// An edit only copies the pages of the arrays which it modifies.
+/// @warning Not thread safe!
+class CubePool {
+    friend class EditBatch;
+    friend class OctreeBuilder;
+
+public:
+    using Index = std::uint32_t;
+    /// Used for a missing parent or a missing data index.
+    static constexpr Index INVALID_INDEX{std::numeric_limits<Index>::max()};
+    /// The root cube is always the first node.
+    static constexpr Index ROOT_INDEX{0};
+    /// Faces in the order of the polygons: x = 0, x = 1, y = 0, y = 1, z = 0, z = 1.
+    static constexpr std::size_t FACES{6};
+    /// Memory of a node and of a leaf payload.
+    static constexpr std::size_t NODE_BYTES{sizeof(std::uint8_t) + 2 * sizeof(Index) + sizeof(std::uint32_t)};
+    static constexpr std::size_t PAYLOAD_BYTES{sizeof(std::array<Indentation, Cube::EDGES>) + sizeof(CubePolygons)};
+
+private:
+    /// The lowest two bits store the Cube::Type.
+    static constexpr std::uint8_t TYPE_MASK{0b11U};
+    static constexpr std::uint8_t POLYGON_CACHE_VALID_BIT{0b100U};
+    /// The cube or one of its children has been edited since the last clear_dirty().
+    static constexpr std::uint8_t DIRTY_BIT{0b1000U};
+
+    float m_size{32};
+    glm::vec3 m_position{0.0F, 0.0F, 0.0F};
+
+    /// Type and flag bits, the polygon cache flag is updated by const methods.
+    mutable CowVector<std::uint8_t> m_bits;
+    CowVector<Index> m_parents;
+    CowVector<Index> m_data;
+    /// Number of geometry cubes in the subtree.
+    CowVector<std::uint32_t> m_geometry_counts;
+    /// First nodes of unused child blocks.
+    std::vector<Index> m_free_blocks;
+
+    /// Leaf payload, only Type::SOLID and Type::NORMAL cubes have one.
+    CowVector<std::array<Indentation, Cube::EDGES>> m_indentations;
+    /// The polygon caches of all payloads in one arena, which is reused through the free list of the payloads.
+    /// Smaller pages, because the polygons are much larger than the other data.
+    mutable CowVector<CubePolygons, 64> m_polygon_caches;
+    std::vector<Index> m_free_payloads;
+
+    /// Merge uniform octants after every edit.
+    bool m_auto_compact{false};
+    /// Bytes returned to the free lists by merging octants.
+    std::size_t m_reclaimed_bytes{0};
+    /// Incremented whenever octants are created, removed or moved.
+    std::uint64_t m_structure_version{0};
+
+    [[nodiscard]] static bool is_geometry(Cube::Type type) noexcept;
+
+    /// The type of the children if the octant only has Type::EMPTY or only Type::SOLID children.
+    [[nodiscard]] std::optional<Cube::Type> uniform_children(Index idx) const noexcept;
+    /// Replace the uniform octant by a single cube.
+    void merge_octant(Index idx, Cube::Type type);
+
+    void set_bits(Index idx, Cube::Type type);
+    /// Change the type without updating the dirty flags, the neighbors and the geometry counts of the parents.
+    /// @return The difference of the geometry count of the cube, which has to be added to all of its parents.
+    [[nodiscard]] std::uint32_t change_type(Index idx, Cube::Type new_type);
+    /// Mark the cube and its parents as dirty.
+    void mark_dirty(Index idx);
+    [[nodiscard]] Index allocate_payload();
+    void free_payload(Index payload);
+    /// Allocate a block of eight solid children.
+    [[nodiscard]] Index allocate_block(Index parent);
+    /// Free a child block and everything below it.
+    void free_block(Index first_child);
+    /// Set the parent of the children of idx, use after a node moved.
+    void update_child_parents(Index idx);
+    /// Exchange the content of two nodes of the same child block.
+    void swap_nodes(Index lhs, Index rhs);
+    /// Copy the subtree at src_idx of src into dst_idx.
+    void copy_subtree(const CubePool &src, Index src_idx, Index dst_idx);
+
+    /// How much of a face is covered by solid cubes. The neighbors of a partially covered face see the solid cubes on
+    /// it, so they have to be updated whenever it changes.
+    enum class FaceCoverage : std::uint8_t { NONE, PARTIAL, FULL };
+
+    [[nodiscard]] FaceCoverage face_coverage(Index idx, std::size_t face) const noexcept;
+    [[nodiscard]] std::array<FaceCoverage, FACES> face_coverages(Index idx) const noexcept;
+    /// Mark the neighbors at the faces dirty whose coverage changed or is partial.
+    void mark_neighbors_dirty(Index idx, const std::array<FaceCoverage, FACES> &old_coverages);
+    /// Mark all cubes dirty which touch the face from the outside, their hidden faces may have changed.
+    void mark_neighbors_dirty(Index idx, std::size_t face);
+    /// Mark the cube and all children on the face dirty.
+    void mark_face_dirty(Index idx, std::size_t face);
+
+    /// Optimized implementations of 90°, 180° and 270° rotations.
+    template <int Rotations>
+    void rotate(Index idx, const Cube::RotationAxis::Type &axis);
+
+    /// Calculate position and size of a cube.
+    void locate(Index idx, glm::vec3 &position, float &size) const noexcept;
+    /// Invalidate the polygon caches and mark the whole subtree as dirty.
+    void invalidate_subtree(Index idx);
+
+public:
+    /// Create a pool with a solid root cube.
+    CubePool(float size, const glm::vec3 &position);
+
+    /// Size of the root cube.
+    [[nodiscard]] float root_size() const noexcept;
+    /// Position of the root cube.
+    [[nodiscard]] const glm::vec3 &root_position() const noexcept;
+    /// Number of allocated nodes, including unused ones.
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    /// Bytes of all allocated nodes and payloads, including unused ones.
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+    /// Move and scale the whole octree, all polygon caches become invalid.
+    void set_root_bounds(float size, const glm::vec3 &position);
+
+    [[nodiscard]] Cube::Type type(Index idx) const noexcept;
+    /// Parent index, INVALID_INDEX for the root cube.
+    [[nodiscard]] Index parent(Index idx) const noexcept;
+    /// Index of the child. Use only on octants.
+    [[nodiscard]] Index child(Index idx, std::size_t child_id) const noexcept;
+    /// Index of the node within its child block, 0 for the root cube.
+    [[nodiscard]] std::size_t child_id(Index idx) const noexcept;
+    /// Number of parents up to the root cube.
+    [[nodiscard]] std::size_t grid_level(Index idx) const noexcept;
+    [[nodiscard]] float size(Index idx) const noexcept;
+    [[nodiscard]] glm::vec3 position(Index idx) const noexcept;
+    /// Position of the child relative to the position of its parent.
+    [[nodiscard]] static glm::vec3 child_offset(std::size_t child_id, float child_size) noexcept;
+
+    /// Morton code of the cube, O(depth).
+    /// @return std::nullopt if the cube is deeper than MAX_MORTON_LEVEL.
+    [[nodiscard]] std::optional<MortonCode> morton_code(Index idx) const noexcept;
+    /// Morton code of the cell at the grid level which contains the position.
+    /// @return std::nullopt if the position is outside of the root cube or the level is deeper than MAX_MORTON_LEVEL.
+    [[nodiscard]] std::optional<MortonCode> morton_code(const glm::vec3 &position, std::size_t level) const noexcept;
+    /// Position of the (0, 0, 0) corner of the cell of a code.
+    [[nodiscard]] glm::vec3 morton_position(MortonCode code) const noexcept;
+    /// Edge length of the cell of a code.
+    [[nodiscard]] float morton_size(MortonCode code) const noexcept;
+    /// Find the cube at the code, or the leaf cube which contains it, O(level).
+    [[nodiscard]] Index find(MortonCode code) const noexcept;
+    /// Find the deepest cube which contains the position, but not deeper than max_level and MAX_MORTON_LEVEL.
+    /// @return INVALID_INDEX if the position is outside of the root cube.
+    [[nodiscard]] Index cube_at(const glm::vec3 &position, std::size_t max_level) const noexcept;
+    /// Changes whenever octants are created, removed or moved, so indices cached by position may be outdated.
+    [[nodiscard]] std::uint64_t structure_version() const noexcept;
+
+    /// The face on the other side of the cube.
+    [[nodiscard]] static std::size_t opposite_face(std::size_t face) noexcept;
+    /// Is the child on the face of its parent.
+    [[nodiscard]] static bool child_on_face(std::size_t child_id, std::size_t face) noexcept;
+    /// Does the face of a geometry cube lie on the bounds of the cube, which is always true for solid cubes.
+    [[nodiscard]] static bool face_on_bounds(Cube::Type type, const std::array<Indentation, Cube::EDGES> &ind,
+                                             std::size_t face) noexcept;
+    /// Find the neighbor at the face, which is a cube of the same size or a bigger leaf cube.
+    /// @return INVALID_INDEX if the face is on the bounds of the root cube.
+    [[nodiscard]] Index neighbor(Index idx, std::size_t face) const noexcept;
+    /// Is the face completely covered by solid cubes.
+    [[nodiscard]] bool face_solid(Index idx, std::size_t face) const noexcept;
+    /// Is the face of the geometry cube covered by a solid neighbor. Only solid neighbors hide faces.
+    [[nodiscard]] bool face_hidden(Index idx, std::size_t face) const noexcept;
+
+    /// Count the number of Type::SOLID and Type::NORMAL cubes, O(1).
+    [[nodiscard]] std::size_t count_geometry_cubes(Index idx) const noexcept;
+    /// Was the cube or one of its children edited since the last clear_dirty().
+    [[nodiscard]] bool dirty(Index idx) const noexcept;
+    /// Clear the dirty flag of the cube and all of its children.
+    void clear_dirty(Index idx);
+
+    /// Set a new type. With auto compaction the parents are merged if they became uniform.
+    /// @warning With auto compaction handles to the cube might become invalid.
+    void set_type(Index idx, Cube::Type new_type);
+    /// Get the indentations. Use only on geometry cubes.
+    [[nodiscard]] const std::array<Indentation, Cube::EDGES> &indentations(Index idx) const noexcept;
+    void set_indentations(Index idx, const std::array<Indentation, Cube::EDGES> &indentations);
+    void set_indent(Index idx, std::uint8_t edge_id, Indentation indentation);
+    void indent(Index idx, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+    void rotate(Index idx, const Cube::RotationAxis::Type &axis, int rotations);
+
+    /// Get the vertices of a geometry cube.
+    [[nodiscard]] static std::array<glm::vec3, 8> vertices(Cube::Type type, const glm::vec3 &position, float size,
+                                                           const std::array<Indentation, Cube::EDGES> &ind) noexcept;
+    /// Build the polygons of a geometry cube.
+    [[nodiscard]] static CubePolygons build_polygons(Cube::Type type, const glm::vec3 &position, float size,
+                                                     const std::array<Indentation, Cube::EDGES> &ind);
+    /// Build the two polygons of a face of an axis aligned box, with the same winding as the faces of a solid cube.
+    /// The box may be flat along the axis of the face.
+    [[nodiscard]] static std::array<Polygon, 2> box_face_polygons(const glm::vec3 &min, const glm::vec3 &max,
+                                                                  std::size_t face) noexcept;
+
+    /// \warning Will update the cache even if it is considered as valid.
+    void update_polygon_cache(Index idx) const;
+    void invalidate_polygon_cache(Index idx) const;
+    /// Store a polygon cache which was built by build_polygons() for the current state of the cube.
+    void set_polygon_cache(Index idx, const CubePolygons &polygons) const;
+    [[nodiscard]] bool polygon_cache_valid(Index idx) const noexcept;
+    /// Get the polygon cache, the view is empty if the cube has no valid cache. It is valid until the pool is edited.
+    [[nodiscard]] PolygonSpan polygon_cache(Index idx) const noexcept;
+    /// Get the polygon cache, an invalid cache is updated with the given position and size of the cube.
+    [[nodiscard]] PolygonSpan polygon_cache(Index idx, const glm::vec3 &position, float size) const;
+    /// Recursive way to collect all the caches.
+    [[nodiscard]] std::vector<PolygonSpan> polygons(Index idx, bool update_invalid) const;
+
+    /// Merge all octants at and below idx whose children are all Type::EMPTY or all Type::SOLID into a single cube.
+    /// The unused nodes and payloads are kept in the free lists for new cubes.
+    /// @return The bytes of the nodes and payloads returned to the free lists.
+    /// @warning Handles to the children of merged octants become invalid.
+    std::size_t compact(Index idx);
+    /// Merge uniform parents whenever a cube was edited by set_type(). New octants are not merged until one of their
+    /// children is edited.
+    void set_auto_compact(bool auto_compact) noexcept;
+    [[nodiscard]] bool auto_compact() const noexcept;
+    /// Total bytes reclaimed by compaction so far.
+    [[nodiscard]] std::size_t reclaimed_bytes() const noexcept;
+
+    /// Create a new pool which contains a copy of the subtree at idx as root cube.
+    /// A copy of the root shares its memory with this pool until either of them is edited.
+    [[nodiscard]] std::shared_ptr<CubePool> clone(Index idx) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
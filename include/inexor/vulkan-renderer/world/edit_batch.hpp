@@ -0,0 +1,107 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+#include "inexor/vulkan-renderer/world/worker_pool.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Collects edits of an octree and applies them at once, for editor brushes which edit thousands of cubes.
+/// Edits are addressed by Morton codes, cubes which do not exist yet are created by subdividing the leaf cube which
+/// contains them, like EditJournal does. apply() sorts the edits in pre-order and walks the octree only once:
+/// - every edited cube is resolved from the path to the previous one instead of from the root,
+/// - the edits of a cube are applied together, its dirty flag and its neighbors are updated once,
+/// - the geometry counts of the parents are updated once per parent instead of once per edit,
+/// - edits which are overwritten by a new type of a parent are skipped,
+/// - with auto compaction the parents are merged once after all edits below them, octants are not merged and
+///   subdivided again in between.
+/// The result is the same as applying the edits one by one in the order of the calls, with auto compaction it can be
+/// merged further. The face coverages of the edited cubes before the batch, which are needed to update their neighbors
+/// and are expensive for large octants, are found on worker threads. The pool is only written by the calling thread:
+/// even edits of disjoint subtrees share the free lists of blocks and payloads, the geometry counts of their common
+/// parents, the neighbors which are marked dirty and the copy on write pages of the pool.
+class EditBatch {
+private:
+    enum class Operation : std::uint8_t { SET_TYPE, SET_INDENTATIONS, SET_INDENT, INDENT };
+
+    struct Edit {
+        MortonCode code;
+        std::uint8_t level;
+        /// Position in the order of the calls.
+        std::uint32_t sequence;
+        Operation operation;
+        Cube::Type type;
+        std::uint8_t edge_id;
+        bool positive_direction;
+        std::uint8_t steps;
+        /// All indentations of SET_INDENTATIONS, the first one of SET_INDENT.
+        std::array<Indentation, Cube::EDGES> indentations;
+    };
+
+    /// A cube on the path from the root cube to the current edit.
+    struct PathNode {
+        MortonCode code;
+        CubePool::Index index;
+        /// Difference of the geometry counts below the cube, added to it and its parents when the path leaves it.
+        std::uint32_t count_difference{0};
+        /// Edits below the cube with a smaller sequence were overwritten by a new type of the cube or of a parent.
+        std::uint32_t overwritten{0};
+        /// The cube or one of its parents has been edited by this batch.
+        bool edited{false};
+        /// A child has a new type, so the cube may have become uniform.
+        bool child_type_changed{false};
+    };
+
+    Cube m_root;
+    std::shared_ptr<WorkerPool> m_workers;
+    std::vector<Edit> m_edits;
+
+    [[nodiscard]] Edit &add(MortonCode code, Operation operation);
+    /// Subdivide the last cube of the path, which is a leaf cube. The children get its type.
+    static void subdivide(CubePool &pool, std::vector<PathNode> &path);
+    /// Leave the last cube of the path and add its geometry count difference to it.
+    /// @param compact Merge the cube if it became uniform.
+    static void pop(CubePool &pool, std::vector<PathNode> &path, bool compact);
+
+public:
+    /// @param root The root cube of the octree.
+    /// @param thread_count Number of threads which find the face coverages of the edited cubes.
+    explicit EditBatch(Cube root, std::size_t thread_count = 1);
+    /// @param root The root cube of the octree.
+    /// @param workers The threads which find the face coverages of the edited cubes, like OctreeMesher::workers().
+    EditBatch(Cube root, std::shared_ptr<WorkerPool> workers);
+
+    /// Collect CubePool::set_type(), the cube is created if it does not exist.
+    void set_type(MortonCode code, Cube::Type new_type);
+    /// @return false if the cube is deeper than MAX_MORTON_LEVEL, the edit is not collected.
+    bool set_type(const Cube &cube, Cube::Type new_type);
+    /// Collect CubePool::set_indentations().
+    void set_indentations(MortonCode code, const std::array<Indentation, Cube::EDGES> &indentations);
+    bool set_indentations(const Cube &cube, const std::array<Indentation, Cube::EDGES> &indentations);
+    /// Collect CubePool::set_indent().
+    void set_indent(MortonCode code, std::uint8_t edge_id, Indentation indentation);
+    bool set_indent(const Cube &cube, std::uint8_t edge_id, Indentation indentation);
+    /// Collect CubePool::indent().
+    void indent(MortonCode code, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+    bool indent(const Cube &cube, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+
+    /// Number of collected edits.
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    /// Drop all collected edits.
+    void clear() noexcept;
+
+    /// Apply all collected edits and clear the batch.
+    /// @warning Handles to cubes within the edited cubes might become invalid.
+    void apply();
+};
+
+} // namespace inexor::vulkan_renderer::world
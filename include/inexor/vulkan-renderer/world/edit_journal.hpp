@@ -0,0 +1,92 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Undo and redo of octree edits. The edits are applied through the journal, which records every edit together with
+/// the state it overwrote. Records are addressed by the Morton code of the edited cube, therefore they stay valid when
+/// the indices of the pool change.
+/// The records are stored back to back in a byte ring buffer: 9 bytes for the operation and its address plus the
+/// prior state, which is one byte for indentations, nothing for rotations, which are undone by the inverse rotation,
+/// and the pre-order encoded subtree for a new type. Undo and redo cost O(size of the edit) and only the polygon caches
+/// of the edited cubes are invalidated.
+/// When the records exceed the memory budget, the oldest ones are dropped.
+/// @warning The octree must only be edited through the journal, otherwise undo restores outdated states.
+class EditJournal {
+private:
+    enum class Operation : std::uint8_t { SET_TYPE, SET_INDENT, INDENT, ROTATE };
+
+    Cube m_root;
+    std::size_t m_memory_budget;
+    /// All records, the undone records follow the applied ones.
+    std::deque<std::uint8_t> m_buffer;
+    /// Size of every record in m_buffer.
+    std::deque<std::uint32_t> m_record_sizes;
+    /// Number and total size of the records which can be undone.
+    std::size_t m_applied{0};
+    std::size_t m_applied_bytes{0};
+
+    [[nodiscard]] CubePool &pool() const noexcept;
+    /// Find the cube at the code, leaf cubes which have been merged by auto compaction are subdivided again.
+    [[nodiscard]] CubePool::Index resolve(MortonCode code) const;
+    /// Append the subtree in pre-order: the type and, for Type::NORMAL cubes, the packed indentations.
+    void write_subtree(CubePool::Index idx, std::deque<std::uint8_t>::iterator &out) const;
+    [[nodiscard]] std::size_t subtree_bytes(CubePool::Index idx) const;
+    /// Overwrite the subtree at idx with an encoded subtree.
+    void read_subtree(CubePool::Index idx, std::deque<std::uint8_t>::const_iterator &in) const;
+
+    /// Address of a cube of this octree, std::nullopt if it is deeper than MAX_MORTON_LEVEL.
+    [[nodiscard]] std::optional<MortonCode> address(const Cube &cube) const noexcept;
+    /// Replace all undone records by a new record of the given size and return its first byte. Drops old records if
+    /// the budget is exceeded, which may drop the new record as well.
+    [[nodiscard]] std::deque<std::uint8_t>::iterator begin_record(Operation operation, MortonCode code,
+                                                                  std::size_t size);
+    void end_record();
+    /// Apply the recorded operation, without the prior state.
+    void apply(std::deque<std::uint8_t>::const_iterator record) const;
+
+public:
+    /// @param root The root cube of the octree.
+    /// @param memory_budget The maximum memory usage of the records in bytes, see memory_usage().
+    EditJournal(Cube root, std::size_t memory_budget);
+
+    /// Record and apply Cube::set_type().
+    /// @return false if the cube is deeper than MAX_MORTON_LEVEL, such cubes cannot be recorded and are not edited.
+    bool set_type(const Cube &cube, Cube::Type new_type);
+    /// Record and apply Cube::set_indent().
+    /// @return false if the cube is deeper than MAX_MORTON_LEVEL.
+    bool set_indent(const Cube &cube, std::uint8_t edge_id, Indentation indentation);
+    /// Record and apply Cube::indent().
+    /// @return false if the cube is deeper than MAX_MORTON_LEVEL.
+    bool indent(const Cube &cube, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+    /// Record and apply Cube::rotate(). Only Cube::RotationAxis::X, Y and Z are supported.
+    /// @return false if the cube is deeper than MAX_MORTON_LEVEL.
+    bool rotate(const Cube &cube, const Cube::RotationAxis::Type &axis, int rotations);
+
+    /// Revert the last applied edit.
+    /// @return false if there is no edit to undo.
+    bool undo();
+    /// Apply the last undone edit again.
+    /// @return false if there is no edit to redo.
+    bool redo();
+    /// Drop all records.
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t undo_count() const noexcept;
+    [[nodiscard]] std::size_t redo_count() const noexcept;
+    /// Size of all records in bytes, including the record sizes kept to step through them.
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+    [[nodiscard]] std::size_t memory_budget() const noexcept;
+    /// Change the budget, drops the oldest records if they do not fit anymore.
+    void set_memory_budget(std::size_t memory_budget);
+};
+
+} // namespace inexor::vulkan_renderer::world
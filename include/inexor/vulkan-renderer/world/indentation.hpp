@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace inexor::vulkan_renderer::world {
@@ -7,6 +9,8 @@ namespace inexor::vulkan_renderer::world {
 class Indentation {
 public:
     static constexpr std::uint8_t MAX{8};
+    /// The uid of Indentation(MAX, MAX), which is the largest one.
+    static constexpr std::uint8_t MAX_UID{44};
 
 private:
     std::uint8_t m_start{0};
@@ -45,4 +49,39 @@ public:
     [[nodiscard]] std::uint8_t uid() const;
 };
 
+/// Number of bytes of twelve packed indentations, see pack_indentations().
+constexpr std::size_t PACKED_INDENTATIONS_BYTES{9};
+
+/// Pack the uids of twelve indentations with 6 bits each, four uids in every three bytes. This is the packing of the
+/// octree files, the edit journal and the edit deltas.
+/// @param out Output iterator receiving PACKED_INDENTATIONS_BYTES bytes.
+/// @return The output iterator behind the last written byte.
+template <typename OutputIt>
+OutputIt pack_indentations(const std::array<Indentation, 12> &indentations, OutputIt out) {
+    for (std::size_t i = 0; i < indentations.size(); i += 4) {
+        *out++ = static_cast<std::uint8_t>((indentations[i].uid() << 2U) | (indentations[i + 1].uid() >> 4U));
+        *out++ = static_cast<std::uint8_t>((indentations[i + 1].uid() << 4U) | (indentations[i + 2].uid() >> 2U));
+        *out++ = static_cast<std::uint8_t>((indentations[i + 2].uid() << 6U) | indentations[i + 3].uid());
+    }
+    return out;
+}
+
+/// Unpack the twelve uids written by pack_indentations(). The uids are not validated, they may exceed
+/// Indentation::MAX_UID if the bytes were not written by pack_indentations().
+/// @param in Input iterator providing PACKED_INDENTATIONS_BYTES bytes.
+/// @return The input iterator behind the last read byte.
+template <typename InputIt>
+InputIt unpack_indentation_uids(InputIt in, std::array<std::uint8_t, 12> &uids) {
+    for (std::size_t i = 0; i < uids.size(); i += 4) {
+        const std::uint8_t first = *in++;
+        const std::uint8_t second = *in++;
+        const std::uint8_t third = *in++;
+        uids[i] = first >> 2U;
+        uids[i + 1] = static_cast<std::uint8_t>(((first & 0b00000011U) << 4U) | (second >> 4U));
+        uids[i + 2] = static_cast<std::uint8_t>(((second & 0b00001111U) << 2U) | (third >> 6U));
+        uids[i + 3] = third & 0b00111111U;
+    }
+    return in;
+}
+
 } // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Address of a cube in Z-order: the Morton code of the cube's cell at its grid level with a leading 1 bit which marks
+/// the level. The three bits of each level are the child id (x = 0b100, y = 0b010, z = 0b001), so the code is the path
+/// from the root cube and the root cube has the code 1. Codes of all cubes inside of a cube share its code as prefix.
+using MortonCode = std::uint64_t;
+
+/// The deepest grid level which fits into a MortonCode.
+constexpr std::size_t MAX_MORTON_LEVEL{21};
+
+/// The code of the cell at the grid level, the cell coordinates must be smaller than 2^level.
+[[nodiscard]] MortonCode morton_code(const glm::uvec3 &cell, std::size_t level) noexcept;
+/// The grid level of a code.
+[[nodiscard]] std::size_t morton_level(MortonCode code) noexcept;
+/// The cell coordinates of a code at its grid level.
+[[nodiscard]] glm::uvec3 morton_cell(MortonCode code) noexcept;
+[[nodiscard]] MortonCode morton_parent(MortonCode code) noexcept;
+[[nodiscard]] MortonCode morton_child(MortonCode code, std::size_t child_id) noexcept;
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Hash index from Morton codes to the cubes of a pool for O(1) lookups.
+/// It contains all cubes up to its grid level. The index is rebuilt on the next lookup after
+/// the structure of the pool changed, which visits all cubes up to its grid level, O(n) in their number. It pays off
+/// for many lookups between structure changes, e.g. per frame; while the octree is edited, CubePool::find() walks
+/// from the root cube in O(level) without any rebuild.
+class MortonIndex {
+private:
+    std::shared_ptr<const CubePool> m_pool;
+    std::size_t m_level;
+    std::uint64_t m_structure_version{0};
+    bool m_built{false};
+    std::unordered_map<MortonCode, CubePool::Index> m_cubes;
+
+    void build();
+    void insert(CubePool::Index idx, MortonCode code);
+
+public:
+    /// @param pool The pool to index.
+    /// @param level The grid level of the index, deeper cubes are not indexed.
+    MortonIndex(std::shared_ptr<const CubePool> pool, std::size_t level);
+
+    /// Find the cube at the code, or the leaf cube which contains it. Codes deeper than the level of the index are
+    /// looked up at the level of the index.
+    /// @return CubePool::INVALID_INDEX if the cube does not exist.
+    [[nodiscard]] CubePool::Index find(MortonCode code);
+    [[nodiscard]] std::size_t level() const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::world
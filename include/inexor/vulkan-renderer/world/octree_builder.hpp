@@ -0,0 +1,103 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/worker_pool.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Dense grid of 2^level voxels along every axis, the input of OctreeBuilder.
+/// The voxels are stored in Morton order, so the voxels of every cube of the octree are a contiguous range.
+class VoxelGrid {
+    friend class OctreeBuilder;
+
+private:
+    std::size_t m_level;
+    std::vector<Cube::Type> m_types;
+    /// Indentations of the Type::NORMAL voxels by their Morton order.
+    std::unordered_map<std::size_t, std::array<Indentation, Cube::EDGES>> m_indentations;
+
+    /// Position of the voxel in Morton order.
+    [[nodiscard]] std::size_t voxel(const glm::uvec3 &cell) const noexcept;
+    void set_voxel(std::size_t voxel, Cube::Type type, const std::array<Indentation, Cube::EDGES> &indentations);
+
+public:
+    /// Create a grid of Type::EMPTY voxels.
+    explicit VoxelGrid(std::size_t level);
+
+    /// The grid level of the voxels in the octree.
+    [[nodiscard]] std::size_t level() const noexcept;
+    /// Number of voxels along every axis.
+    [[nodiscard]] std::uint32_t resolution() const noexcept;
+
+    [[nodiscard]] Cube::Type type(const glm::uvec3 &cell) const noexcept;
+    /// Get the indentations. Use only on Type::NORMAL voxels.
+    [[nodiscard]] const std::array<Indentation, Cube::EDGES> &indentations(const glm::uvec3 &cell) const;
+    /// Set a voxel, which must not be a Type::OCTANT. The indentations are only used for Type::NORMAL.
+    void set(const glm::uvec3 &cell, Cube::Type type, const std::array<Indentation, Cube::EDGES> &indentations = {});
+    /// Set count voxels starting at the first in the order x, y, z (x changes fastest), to decode run-length encoded
+    /// grids.
+    void set_run(std::size_t first, std::size_t count, Cube::Type type,
+                 const std::array<Indentation, Cube::EDGES> &indentations = {});
+};
+
+/// Builds an octree from a voxel grid at once, which is much faster than editing a pool cube by cube.
+/// The grid is split into parts which are encoded bottom-up on the worker threads, an octant whose children are all
+/// Type::EMPTY or all Type::SOLID is merged as soon as its children are encoded. The number of nodes of every part is
+/// known afterwards, so the parts are written into a new pool on the worker threads as well.
+/// The octree is equal to the one created by set_type() for every voxel followed by CubePool::compact().
+class OctreeBuilder {
+private:
+    /// Pre-order encoding of the subtree of a part.
+    struct Part {
+        std::vector<Cube::Type> types;
+        /// Indentations of the Type::NORMAL cubes in pre-order.
+        std::vector<std::array<Indentation, Cube::EDGES>> indentations;
+        std::size_t octants{0};
+        std::size_t geometry_cubes{0};
+        /// Node of the part, INVALID_INDEX if a parent has been merged.
+        CubePool::Index root{CubePool::INVALID_INDEX};
+        CubePool::Index first_block{0};
+        CubePool::Index first_payload{0};
+    };
+
+    std::shared_ptr<WorkerPool> m_workers;
+
+    /// Grow the arrays of the pool to the number of nodes and payloads.
+    static void grow(CubePool &pool, std::size_t nodes, std::size_t payloads);
+    /// Encode the cube with 8^levels voxels which start at the voxel in Morton order.
+    static void encode(const VoxelGrid &grid, std::size_t first_voxel, std::size_t levels, Part &part);
+    /// Write the cells above the split level, which are merged if the cells below them are uniform.
+    static void write_cells(CubePool &pool, CubePool::Index idx, std::size_t level, std::size_t cell,
+                            const std::vector<std::vector<Cube::Type>> &cell_types, std::vector<Part> &parts,
+                            CubePool::Index &next_block, CubePool::Index &next_payload);
+    /// Write a part into the nodes and payloads which are reserved for it.
+    static void write_part(CubePool &pool, const Part &part);
+    /// Add the geometry count of the cube to all of its parents.
+    static void add_to_parents(CubePool &pool, CubePool::Index idx);
+
+public:
+    /// @param thread_count Number of threads which encode and write the parts in parallel.
+    explicit OctreeBuilder(std::size_t thread_count = 1);
+    /// @param workers The threads which encode and write the parts in parallel, like OctreeMesher::workers().
+    explicit OctreeBuilder(std::shared_ptr<WorkerPool> workers);
+
+    [[nodiscard]] std::size_t thread_count() const noexcept;
+
+    /// Build a new octree, all of its cubes are dirty.
+    /// @param size The size of the root cube, the voxels have the size size / grid.resolution().
+    /// @param position The position of the root cube.
+    [[nodiscard]] Cube build(const VoxelGrid &grid, float size, const glm::vec3 &position) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
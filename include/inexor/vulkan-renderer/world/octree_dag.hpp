@@ -0,0 +1,105 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Compressed octree in which identical subtrees, including their indentations, are stored only once.
+/// Every node is hash-consed: a leaf is identified by its type and indentations and an octant by the ids of its
+/// children, so adding a node which exists already returns the existing one. Maps with many copies of the same walls,
+/// pillars or empty regions therefore need a fraction of the memory of a CubePool.
+/// Nodes are never modified, an edit copies the path from the root to the edited cube and leaves all other instances of
+/// a shared subtree unchanged. Nodes which are not used anymore are removed by collect_garbage().
+/// The DAG only stores the structure, use to_cube() to get an octree which can be meshed and edited directly.
+class OctreeDag {
+public:
+    using NodeId = std::uint32_t;
+    static constexpr NodeId INVALID_NODE{std::numeric_limits<NodeId>::max()};
+    /// The Type::EMPTY and Type::SOLID leaves always exist.
+    static constexpr NodeId EMPTY_NODE{0};
+    static constexpr NodeId SOLID_NODE{1};
+
+private:
+    struct Node {
+        Cube::Type type;
+        /// Index of the children of an octant or of the indentations of a Type::NORMAL leaf.
+        std::uint32_t data;
+        /// Number of cubes and of geometry cubes in the expanded subtree.
+        std::uint64_t cubes;
+        std::uint64_t geometry_cubes;
+    };
+
+    struct ChildrenHash {
+        std::size_t operator()(const std::array<NodeId, Cube::SUB_CUBES> &children) const noexcept;
+    };
+    struct IndentationsHash {
+        std::size_t operator()(const std::array<std::uint8_t, Cube::EDGES> &uids) const noexcept;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<std::array<NodeId, Cube::SUB_CUBES>> m_children;
+    std::vector<std::array<Indentation, Cube::EDGES>> m_indentations;
+    std::unordered_map<std::array<NodeId, Cube::SUB_CUBES>, NodeId, ChildrenHash> m_octants;
+    /// Type::NORMAL leaves by the ids of their indentations.
+    std::unordered_map<std::array<std::uint8_t, Cube::EDGES>, NodeId, IndentationsHash> m_normal_leaves;
+    NodeId m_root{SOLID_NODE};
+
+    /// Replace the cube at the code below the node, leaves on the path are split into eight equal children.
+    [[nodiscard]] NodeId replace(NodeId node, MortonCode code, std::size_t level, NodeId subtree);
+
+public:
+    /// Create a DAG with a solid root cube.
+    OctreeDag();
+    /// Compress the octree of the cube.
+    explicit OctreeDag(const Cube &cube);
+
+    /// Find or add a leaf, which must not be Type::OCTANT. The indentations are only used for Type::NORMAL.
+    [[nodiscard]] NodeId leaf(Cube::Type type, const std::array<Indentation, Cube::EDGES> &indentations = {});
+    /// Find or add an octant.
+    [[nodiscard]] NodeId octant(const std::array<NodeId, Cube::SUB_CUBES> &children);
+
+    [[nodiscard]] NodeId root() const noexcept;
+    void set_root(NodeId root);
+
+    [[nodiscard]] Cube::Type type(NodeId node) const noexcept;
+    /// Use only on octants.
+    [[nodiscard]] NodeId child(NodeId node, std::size_t child_id) const noexcept;
+    /// Use only on Type::NORMAL leaves.
+    [[nodiscard]] const std::array<Indentation, Cube::EDGES> &indentations(NodeId node) const noexcept;
+
+    /// Replace the cube at the code with a subtree of this DAG, only the path to the cube is copied.
+    void set(MortonCode code, NodeId subtree);
+    /// Set the type of the cube at the code like Cube::set_type().
+    void set_type(MortonCode code, Cube::Type type);
+    /// Set the indentations of the cube at the code, which becomes Type::NORMAL.
+    void set_indentations(MortonCode code, const std::array<Indentation, Cube::EDGES> &indentations);
+
+    /// Remove all nodes which are not used by the root, the ids of the remaining nodes change.
+    /// @return The number of removed nodes.
+    std::size_t collect_garbage();
+
+    /// Number of stored nodes.
+    [[nodiscard]] std::size_t node_count() const noexcept;
+    /// Number of cubes of the expanded octree.
+    [[nodiscard]] std::uint64_t cube_count() const noexcept;
+    /// Memory of the nodes, children, indentations and hash tables in bytes, the hash tables are estimated.
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+    /// Memory of the expanded octree in a CubePool without polygon caches, divided by memory_usage().
+    [[nodiscard]] double compression_ratio() const noexcept;
+
+    /// Expand the DAG into a new octree.
+    [[nodiscard]] Cube to_cube(float size, const glm::vec3 &position) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/polygon_batch.hpp"
+#include "inexor/vulkan-renderer/world/worker_pool.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Groups the polygons of an octree into regions and only remeshes the regions which contain edited cubes.
+/// A region is a cube at the region level or a leaf cube above it. Regions are identified by the path from the root
+/// cube to their first cube at the region level, which is a Morton code with 3 bits per level. Therefore all regions
+/// inside of a cube have keys within one contiguous range.
+/// Faces which are covered by solid neighbors are not emitted, also across octant boundaries and grid levels.
+/// With greedy meshing the visible faces of solid cubes in the same plane are merged into maximal rectangles, which
+/// works across cubes of different sizes. Faces are only merged within a region.
+/// Optionally every region also gets coarser levels of detail. At detail depth d all octants d levels below the region
+/// are replaced by a solid cube if they are at least half filled, which bounds the polygons of the region by the number
+/// of those cubes. To avoid cracks, a replaced octant is also solid if it has solid cubes on the bounds of the region,
+/// because neighbor regions might have culled their faces against them.
+/// Regions are meshed in parallel, every worker writes into the polygons of its own regions. The regions are ordered by
+/// their keys, so the output does not depend on the number of threads.
+/// @note The mesher consumes the dirty flags of the octree, use only one mesher per octree.
+class OctreeMesher {
+public:
+    using RegionKey = std::uint64_t;
+    /// 3 bits per level have to fit into a RegionKey.
+    static constexpr std::size_t MAX_REGION_LEVEL{21};
+
+    struct Region {
+        std::size_t grid_level;
+        glm::vec3 position;
+        float size;
+        std::vector<Polygon> polygons;
+        /// Coarser polygons, lods[d] replaces all octants at d levels below the region. Only contains the levels which
+        /// are coarser than the full detail polygons.
+        std::vector<std::vector<Polygon>> lods;
+    };
+
+    /// All regions with keys in [first, last) have been replaced by the regions in the same range.
+    struct ChangedRegion {
+        RegionKey first;
+        RegionKey last;
+        glm::vec3 position;
+        float size;
+    };
+
+    /// Keys [first, last) of a contiguous range of regions.
+    struct RegionRange {
+        RegionKey first;
+        RegionKey last;
+    };
+
+private:
+    /// Rectangle of a face in the plane coordinates, u and v are the two axes after the axis of the face.
+    struct FaceRect {
+        float u0;
+        float u1;
+        float v0;
+        float v1;
+    };
+    /// Visible faces of solid cubes by face and plane coordinate.
+    using FacePlanes = std::map<std::pair<std::size_t, float>, std::vector<FaceRect>>;
+
+    /// A region which has to be remeshed.
+    struct Job {
+        std::uint32_t idx;
+        ChangedRegion range;
+        Region region;
+        /// Polygon caches built by the worker, which are stored in the pool afterwards.
+        std::vector<std::pair<std::uint32_t, CubePolygons>> polygon_caches;
+    };
+
+    Cube m_root;
+    std::size_t m_region_level;
+    bool m_greedy_meshing;
+    std::shared_ptr<WorkerPool> m_workers;
+    std::size_t m_lod_levels;
+    std::map<RegionKey, Region> m_regions;
+
+    /// Add all geometry cubes below idx whose polygon caches are invalid and needed for meshing to the batch.
+    void collect_invalid_caches(std::uint32_t idx, const glm::vec3 &position, float size,
+                                std::vector<std::uint32_t> &indices, PolygonBatch &batch) const;
+    /// Build the invalid polygon caches of all geometry cubes below idx, which are needed for meshing.
+    void build_polygon_caches(std::uint32_t idx, const glm::vec3 &position, float size,
+                              std::vector<std::pair<std::uint32_t, CubePolygons>> &polygon_caches) const;
+
+    /// Append the visible polygons of all geometry cubes below idx.
+    /// @param planes If not nullptr, the visible faces of solid cubes are added to it instead of to the polygons.
+    void collect_visible_polygons(std::uint32_t idx, const glm::vec3 &position, float size,
+                                  std::vector<Polygon> &polygons, FacePlanes *planes) const;
+
+    /// Merge the faces of each plane into maximal rectangles and append their polygons.
+    static void merge_faces(const FacePlanes &planes, std::vector<Polygon> &polygons);
+
+    /// Build the polygons of the region with all octants at depth levels below it replaced by solid cubes.
+    /// @return std::nullopt if the region is not deeper than depth.
+    [[nodiscard]] std::optional<std::vector<Polygon>> build_lod(std::uint32_t idx, const glm::vec3 &position,
+                                                                float size, std::size_t depth) const;
+
+    /// Collect all dirty regions below idx and remove their old polygons.
+    /// @param force Remesh even if the cube is not dirty.
+    void collect_jobs(std::uint32_t idx, std::size_t level, RegionKey key, const glm::vec3 &position, float size,
+                      bool force, std::vector<Job> &jobs);
+
+    /// Mesh the jobs on the worker threads and insert the results.
+    std::vector<ChangedRegion> run_jobs(std::vector<Job> &jobs);
+
+    /// Append the key ranges of all regions below idx which intersect the frustum.
+    /// @param plane_mask Bit i is set if the cube intersects plane i, the cube is completely inside of all others.
+    void collect_visible_regions(std::uint32_t idx, std::size_t level, RegionKey key, const glm::vec3 &position,
+                                 float size, const std::array<glm::vec4, 6> &frustum_planes, std::uint8_t plane_mask,
+                                 std::vector<RegionRange> &ranges) const;
+
+public:
+    /// Mesh the whole octree.
+    /// @param root The root cube of the octree.
+    /// @param region_level The grid level of the regions, smaller regions are cheaper to remesh but cause more
+    /// regions.
+    /// @param greedy_meshing Merge coplanar faces of solid cubes.
+    /// @param thread_count Number of threads which mesh regions in parallel, they are started once by the mesher.
+    /// @param lod_levels Number of coarser levels of detail per region, 0 disables them.
+    OctreeMesher(Cube root, std::size_t region_level, bool greedy_meshing = false, std::size_t thread_count = 1,
+                 std::size_t lod_levels = 0);
+
+    /// Remesh all regions which contain dirty cubes. The cost is O(depth) per edited cube plus the size of the
+    /// changed regions.
+    /// @return The changed regions, the renderer has to patch its data in those ranges.
+    [[nodiscard]] std::vector<ChangedRegion> update();
+    /// Continue with another version of the octree, like the versions published by OctreeVersions, and remesh it.
+    /// @param root The root cube of the new version, its dirty flags have to contain all changes since the current
+    /// version.
+    /// @param remesh_all Remesh all regions, use this if the dirty flags are incomplete because versions were skipped.
+    [[nodiscard]] std::vector<ChangedRegion> update(Cube root, bool remesh_all = false);
+
+    [[nodiscard]] const Cube &root() const noexcept;
+    [[nodiscard]] std::size_t region_level() const noexcept;
+    [[nodiscard]] bool greedy_meshing() const noexcept;
+    [[nodiscard]] std::size_t thread_count() const noexcept;
+    /// The threads of the mesher, which can be shared with EditBatch, OctreeBuilder and PreviewRenderer.
+    [[nodiscard]] const std::shared_ptr<WorkerPool> &workers() const noexcept;
+    [[nodiscard]] std::size_t lod_levels() const noexcept;
+    /// All regions which have polygons, ordered by their keys.
+    [[nodiscard]] const std::map<RegionKey, Region> &regions() const noexcept;
+    /// Total number of polygons of all regions.
+    [[nodiscard]] std::size_t polygon_count() const noexcept;
+
+    /// Find the regions inside of the frustum. Octants are tested hierarchically, therefore invisible octants are
+    /// skipped as a whole and octants which are completely inside are not tested further.
+    /// @param frustum_planes The planes of the frustum pointing inwards, see Camera::frustum_planes().
+    /// @return Sorted and merged key ranges of the visible regions.
+    [[nodiscard]] std::vector<RegionRange> visible_regions(const std::array<glm::vec4, 6> &frustum_planes) const;
+
+    /// Select the level of detail of a region by its screen space error. The replacement cubes of a level must not be
+    /// larger than max_error times their distance to the camera.
+    /// @param max_error Roughly the tolerated error in radians of the field of view.
+    /// @return The polygons of the coarsest level which satisfies the error, or the full detail polygons.
+    [[nodiscard]] static const std::vector<Polygon> &select_lod(const Region &region, const glm::vec3 &camera_position,
+                                                                float max_error);
+};
+
+} // namespace inexor::vulkan_renderer::world
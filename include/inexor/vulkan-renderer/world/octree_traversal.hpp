@@ -0,0 +1,190 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// The number of levels below the start cube which the traversals keep on a fixed size stack, deeper levels are kept
+/// on the heap.
+constexpr std::size_t MAX_TRAVERSAL_DEPTH{64};
+
+/// The path of a traversal. The first MAX_TRAVERSAL_DEPTH frames are stored inline, so traversals of usual octrees
+/// never allocate memory, but octrees of any depth are supported.
+template <typename Frame>
+class TraversalStack {
+private:
+    std::array<Frame, MAX_TRAVERSAL_DEPTH> m_frames{};
+    std::vector<Frame> m_deep_frames;
+    std::size_t m_size{0};
+
+public:
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+    [[nodiscard]] Frame &top() noexcept {
+        return m_size > MAX_TRAVERSAL_DEPTH ? m_deep_frames.back() : m_frames[m_size - 1];
+    }
+    void push(const Frame &frame) {
+        if (m_size < MAX_TRAVERSAL_DEPTH) {
+            m_frames[m_size] = frame;
+        } else {
+            m_deep_frames.push_back(frame);
+        }
+        m_size++;
+    }
+    void pop() noexcept {
+        if (m_size > MAX_TRAVERSAL_DEPTH) {
+            m_deep_frames.pop_back();
+        }
+        m_size--;
+    }
+};
+
+/// A cube visited by a traversal.
+struct TraversalNode {
+    CubePool::Index index;
+    /// Number of levels below the start cube of the traversal.
+    std::size_t depth;
+    glm::vec3 position;
+    float size;
+};
+
+/// Visits all cubes of a subtree in pre-order, every octant before its children.
+/// The iterator keeps the path to the current cube on a TraversalStack.
+/// The type of a cube is read when the iterator advances from it, so the current cube may be turned into an octant to
+/// build an octree while iterating.
+class PreOrderIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TraversalNode;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TraversalNode *;
+    using reference = const TraversalNode &;
+
+private:
+    struct Frame {
+        CubePool::Index first_child;
+        std::uint8_t next_child;
+        glm::vec3 position;
+        float child_size;
+    };
+
+    const CubePool *m_pool{nullptr};
+    TraversalStack<Frame> m_stack;
+    TraversalNode m_node{CubePool::INVALID_INDEX, 0, {}, 0.0F};
+    bool m_skip_children{false};
+
+public:
+    /// The end of every traversal.
+    PreOrderIterator() = default;
+    /// Start at the cube, which is visited first.
+    PreOrderIterator(const CubePool &pool, CubePool::Index idx, const glm::vec3 &position, float size) noexcept;
+
+    [[nodiscard]] reference operator*() const noexcept;
+    [[nodiscard]] pointer operator->() const noexcept;
+    PreOrderIterator &operator++();
+    [[nodiscard]] bool operator==(const PreOrderIterator &rhs) const noexcept;
+    [[nodiscard]] bool operator!=(const PreOrderIterator &rhs) const noexcept;
+
+    /// Do not visit the children of the current cube.
+    void skip_children() noexcept;
+};
+
+/// Visits all cubes of a subtree in post-order, every octant after its children.
+/// The iterator keeps the path to the current cube on a TraversalStack.
+class PostOrderIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TraversalNode;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TraversalNode *;
+    using reference = const TraversalNode &;
+
+private:
+    struct Frame {
+        TraversalNode octant;
+        std::uint8_t next_child;
+    };
+
+    const CubePool *m_pool{nullptr};
+    TraversalStack<Frame> m_stack;
+    TraversalNode m_node{CubePool::INVALID_INDEX, 0, {}, 0.0F};
+
+    /// Go down to the first leaf of the subtree of the node.
+    void descend(TraversalNode node);
+
+public:
+    /// The end of every traversal.
+    PostOrderIterator() = default;
+    /// Start at the first leaf of the subtree of the cube, the cube itself is visited last.
+    PostOrderIterator(const CubePool &pool, CubePool::Index idx, const glm::vec3 &position, float size);
+
+    [[nodiscard]] reference operator*() const noexcept;
+    [[nodiscard]] pointer operator->() const noexcept;
+    PostOrderIterator &operator++();
+    [[nodiscard]] bool operator==(const PostOrderIterator &rhs) const noexcept;
+    [[nodiscard]] bool operator!=(const PostOrderIterator &rhs) const noexcept;
+};
+
+/// Range of a traversal for range-based for loops.
+template <typename Iterator>
+class TraversalRange {
+private:
+    Iterator m_begin;
+
+public:
+    explicit TraversalRange(Iterator begin) noexcept : m_begin(std::move(begin)) {}
+
+    [[nodiscard]] Iterator begin() const noexcept {
+        return m_begin;
+    }
+    [[nodiscard]] Iterator end() const noexcept {
+        return {};
+    }
+};
+
+/// Traverse the subtree at idx in pre-order.
+[[nodiscard]] TraversalRange<PreOrderIterator> pre_order(const CubePool &pool, CubePool::Index idx);
+/// Traverse the subtree at idx in post-order.
+[[nodiscard]] TraversalRange<PostOrderIterator> post_order(const CubePool &pool, CubePool::Index idx);
+
+/// Call the visitor for all cubes of the subtree at idx in pre-order.
+/// @param position The position of the cube at idx, the positions of the visited cubes are relative to it.
+/// @param size The size of the cube at idx.
+/// @param visitor Called with a const TraversalNode &, returns whether the children of an octant are visited.
+template <typename Visitor>
+void visit_pre_order(const CubePool &pool, const CubePool::Index idx, const glm::vec3 &position, const float size,
+                     Visitor &&visitor) {
+    for (PreOrderIterator iter(pool, idx, position, size); iter != PreOrderIterator(); ++iter) {
+        if (!visitor(*iter)) {
+            iter.skip_children();
+        }
+    }
+}
+
+/// Call the visitor for all cubes of the subtree at idx in pre-order.
+/// @param visitor Called with a const TraversalNode &, returns whether the children of an octant are visited.
+template <typename Visitor>
+void visit_pre_order(const CubePool &pool, const CubePool::Index idx, Visitor &&visitor) {
+    visit_pre_order(pool, idx, pool.position(idx), pool.size(idx), std::forward<Visitor>(visitor));
+}
+
+/// Call the visitor for all cubes of the subtree at idx in post-order.
+/// @param visitor Called with a const TraversalNode &.
+template <typename Visitor>
+void visit_post_order(const CubePool &pool, const CubePool::Index idx, Visitor &&visitor) {
+    for (PostOrderIterator iter(pool, idx, pool.position(idx), pool.size(idx)); iter != PostOrderIterator(); ++iter) {
+        visitor(*iter);
+    }
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Publishes immutable versions of an octree, so other threads can read the octree while it is edited.
+/// One writer thread edits the working octree and publishes it, which copies the copy on write page tables of its pool
+/// and swaps the copy in atomically. Readers acquire the latest version without blocking the writer.
+/// A replaced version is reclaimed as soon as the last reader released it, the pages it shares with newer versions
+/// stay alive.
+/// Every version contains the dirty flags of the changes since the previous version, see OctreeMesher::update().
+class OctreeVersions {
+private:
+    /// A published version, never modified.
+    struct Snapshot {
+        std::uint64_t number;
+        CubePool pool;
+    };
+
+public:
+    /// A published version of the octree.
+    struct Version {
+        /// Versions are numbered consecutively, starting with 1.
+        std::uint64_t number;
+        /// Root of a private copy of the version, which is also copy on write. Readers may update its polygon caches
+        /// and dirty flags, which does not affect other readers.
+        Cube root;
+        /// Keeps the version alive while it is read.
+        std::shared_ptr<const Snapshot> snapshot;
+    };
+
+private:
+    Cube m_root;
+    /// Only accessed through std::atomic_load and std::atomic_store.
+    std::shared_ptr<const Snapshot> m_published;
+    /// Replaced versions, which are alive until their readers are done.
+    std::vector<std::weak_ptr<const Snapshot>> m_retired;
+    mutable std::mutex m_retired_mutex;
+
+public:
+    /// Publishes the octree as the first version.
+    /// @param root The root cube of the working octree.
+    explicit OctreeVersions(Cube root);
+
+    /// The working octree, only the writer thread may access it.
+    [[nodiscard]] const Cube &root() const noexcept;
+
+    /// Publish the current state of the working octree and clear its dirty flags. Only the writer thread may publish.
+    /// @return The number of the new version.
+    std::uint64_t publish();
+
+    /// Get the latest version, can be called from any thread.
+    [[nodiscard]] Version acquire() const;
+    /// Number of the latest version, can be called from any thread.
+    [[nodiscard]] std::uint64_t version() const;
+
+    /// Number of replaced versions which are still used by readers, can be called from any thread.
+    [[nodiscard]] std::size_t retired_versions() const;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Builds the polygons of many geometry cubes at once, with the same result as CubePool::build_polygons().
+/// The cubes are stored as structure of arrays, so build() computes the corners and the diagonal of every face for
+/// four cubes per SSE2 instruction, with a scalar fallback on other platforms. The diagonals of the six faces form a
+/// 6 bit mask and the triangles of all 64 masks come from a table which is generated at compile time.
+class PolygonBatch {
+public:
+    /// Number of corners of a cube.
+    static constexpr std::size_t CORNERS{8};
+
+private:
+    /// Position and size of the cubes.
+    std::array<std::vector<float>, 3> m_positions;
+    std::vector<float> m_sizes;
+    /// Indentation::start() and Indentation::end() of the edges of the cubes.
+    std::array<std::vector<std::uint8_t>, Cube::EDGES> m_starts;
+    std::array<std::vector<std::uint8_t>, Cube::EDGES> m_ends;
+
+    /// The corners are stored in blocks of four cubes, each block contains the coordinates of every axis of every
+    /// corner for its four cubes.
+    std::vector<float> m_corners;
+    /// Bit f is set if face f uses the other diagonal.
+    std::vector<std::uint8_t> m_diagonals;
+
+    /// Offset of a coordinate in m_corners.
+    [[nodiscard]] static std::size_t corner_offset(std::size_t cube, std::size_t corner, std::size_t axis) noexcept;
+    void build_scalar(std::size_t cube);
+#if defined(__SSE2__)
+    void build_sse2(std::size_t first, std::size_t last);
+#endif
+
+public:
+    /// Add a Type::SOLID or Type::NORMAL cube.
+    void add(Cube::Type type, const glm::vec3 &position, float size, const std::array<Indentation, Cube::EDGES> &ind);
+    [[nodiscard]] std::size_t size() const noexcept;
+    void clear() noexcept;
+
+    /// Compute the corners and diagonals of all cubes.
+    void build();
+
+    /// The corners of a cube in the order of CubePool::vertices(). Use only after build().
+    [[nodiscard]] std::array<glm::vec3, CORNERS> vertices(std::size_t cube) const noexcept;
+    /// The polygons of a cube in the order of CubePool::build_polygons(). Use only after build().
+    [[nodiscard]] CubePolygons polygons(std::size_t cube) const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::world
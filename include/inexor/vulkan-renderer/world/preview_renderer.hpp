@@ -0,0 +1,65 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/worker_pool.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// forward declaration
+namespace inexor::vulkan_renderer {
+class Camera;
+} // namespace inexor::vulkan_renderer
+
+namespace inexor::vulkan_renderer::world {
+
+/// An image with 8 bit red, green, blue and alpha channels, the rows from top to bottom.
+struct PreviewImage {
+    std::uint32_t width{0};
+    std::uint32_t height{0};
+    std::vector<std::uint8_t> pixels;
+};
+
+/// Renders an octree on the CPU by casting a ray through every pixel, for thumbnails and image comparisons on machines
+/// without a GPU or window.
+/// The image is split into tiles which are rendered by all threads. Each tile casts packets of 2x2 rays, a packet
+/// traverses the octree once for all of its rays and intersects boxes and polygons with four rays per SSE2 instruction,
+/// with a scalar fallback on other platforms. Faces are lit by one directional light and fade into the background
+/// towards the far plane of the camera.
+class PreviewRenderer {
+public:
+    /// Width and height of the tiles in pixels.
+    static constexpr std::uint32_t TILE_SIZE{16};
+
+private:
+    std::shared_ptr<WorkerPool> m_workers;
+    /// Direction from the geometry to the light.
+    glm::vec3 m_light_direction{0.4F, 0.3F, 0.87F};
+    glm::vec3 m_geometry_color{0.8F, 0.78F, 0.72F};
+    glm::vec3 m_background_color{0.45F, 0.6F, 0.8F};
+
+public:
+    /// @param thread_count Number of threads rendering tiles, including the calling thread.
+    explicit PreviewRenderer(std::size_t thread_count = std::thread::hardware_concurrency());
+    /// @param workers The threads rendering tiles, like OctreeMesher::workers().
+    explicit PreviewRenderer(std::shared_ptr<WorkerPool> workers);
+
+    /// @param direction Direction from the geometry to the light, does not need to be normalized.
+    void set_light_direction(const glm::vec3 &direction);
+    /// Colors with components from 0 to 1.
+    void set_geometry_color(const glm::vec3 &color);
+    void set_background_color(const glm::vec3 &color);
+
+    /// Render the cube as seen by the camera. The field of view of the camera is the vertical one, the aspect ratio is
+    /// the one of the image.
+    /// @param cube The cube to render, usually the root cube. The octree must not be modified while rendering.
+    [[nodiscard]] PreviewImage render(const Cube &cube, const Camera &camera, std::uint32_t width,
+                                      std::uint32_t height) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Axis aligned box for range queries.
+struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+/// Sphere for range queries.
+struct Sphere {
+    glm::vec3 center;
+    float radius;
+};
+
+/// A triangle clipped by the six planes of a box has at most nine corners, which form up to seven triangles.
+constexpr std::size_t MAX_CLIPPED_TRIANGLES{7};
+
+/// Does the shape intersect or touch the cube at the position with the size.
+[[nodiscard]] bool intersects(const Box &box, const glm::vec3 &position, float size) noexcept;
+[[nodiscard]] bool intersects(const Sphere &sphere, const glm::vec3 &position, float size) noexcept;
+/// Does the sphere intersect or touch the triangle.
+[[nodiscard]] bool intersects(const Sphere &sphere, const Polygon &triangle) noexcept;
+/// Clip the triangle to the box.
+/// @return The number of triangles in clipped.
+[[nodiscard]] std::size_t clip(const Polygon &triangle, const Box &box,
+                               std::array<Polygon, MAX_CLIPPED_TRIANGLES> &clipped) noexcept;
+/// The polygon cache of a geometry cube, or its polygons built into polygons if the cache is invalid. Does not modify
+/// the pool.
+[[nodiscard]] PolygonSpan cube_polygons(const CubePool &pool, const TraversalNode &node, CubePolygons &polygons);
+
+/// Visit all geometry cubes whose bounds intersect the box or sphere.
+/// Octants outside of the shape and subtrees without geometry are skipped, so the cost depends on the number of
+/// results and the depth of the octree, not on the size of the map. Nothing is allocated.
+/// @param visitor Called with a const TraversalNode & for every geometry cube.
+template <typename Shape, typename Visitor>
+void query_cubes(const Cube &cube, const Shape &shape, Visitor &&visitor) {
+    const CubePool &pool = *cube.pool();
+    visit_pre_order(pool, cube.index(), [&](const TraversalNode &node) {
+        if (pool.count_geometry_cubes(node.index) == 0 || !intersects(shape, node.position, node.size)) {
+            return false;
+        }
+        if (pool.type(node.index) != Cube::Type::OCTANT) {
+            visitor(node);
+        }
+        return true;
+    });
+}
+
+/// Visit the triangles of all geometry cubes which lie in the box, clipped to the box.
+/// @param visitor Called with the const TraversalNode & of the cube and a const Polygon & for every clipped triangle.
+template <typename Visitor>
+void query_polygons(const Cube &cube, const Box &box, Visitor &&visitor) {
+    const CubePool &pool = *cube.pool();
+    CubePolygons built_polygons;
+    std::array<Polygon, MAX_CLIPPED_TRIANGLES> clipped;
+    query_cubes(cube, box, [&](const TraversalNode &node) {
+        for (const Polygon &polygon : cube_polygons(pool, node, built_polygons)) {
+            const std::size_t count = clip(polygon, box, clipped);
+            for (std::size_t i = 0; i < count; i++) {
+                visitor(node, clipped[i]);
+            }
+        }
+    });
+}
+
+/// Visit the triangles of all geometry cubes which intersect the sphere, a sphere cannot clip them to triangles.
+/// @param visitor Called with the const TraversalNode & of the cube and a const Polygon & for every triangle.
+template <typename Visitor>
+void query_polygons(const Cube &cube, const Sphere &sphere, Visitor &&visitor) {
+    const CubePool &pool = *cube.pool();
+    CubePolygons built_polygons;
+    query_cubes(cube, sphere, [&](const TraversalNode &node) {
+        for (const Polygon &polygon : cube_polygons(pool, node, built_polygons)) {
+            if (intersects(sphere, polygon)) {
+                visitor(node, polygon);
+            }
+        }
+    });
+}
+
+} // namespace inexor::vulkan_renderer::world
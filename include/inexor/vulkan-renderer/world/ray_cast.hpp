@@ -0,0 +1,39 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace inexor::vulkan_renderer::world {
+
+/// The closest geometry cube hit by a ray.
+struct RayHit {
+    Cube cube;
+    /// Hit face in the order of the polygons: x = 0, x = 1, y = 0, y = 1, z = 0, z = 1.
+    std::size_t face;
+    /// Hit polygon of the cube, 2 * face or 2 * face + 1.
+    std::size_t polygon;
+    /// Edge of the hit face which is closest to the hit position, the edge id of Cube::indent().
+    std::size_t edge;
+    /// Distance along the ray in units of the direction, 0 if the ray starts inside of a solid cube.
+    float distance;
+    glm::vec3 position;
+    std::size_t grid_level;
+};
+
+/// Find the closest geometry cube hit by a ray.
+/// Octants are traversed front to back and only the children pierced by the ray are visited, therefore the cost
+/// depends on the depth of the octree and not on the number of cubes. Indented Type::NORMAL cubes are intersected with
+/// their polygons.
+/// @param cube The cube to search in, usually the root cube.
+/// @param origin Start of the ray.
+/// @param direction Direction of the ray, does not need to be normalized.
+/// @param max_distance Ignore hits further away than this.
+[[nodiscard]] std::optional<RayHit> ray_cast(const Cube &cube, const glm::vec3 &origin, const glm::vec3 &direction,
+                                             float max_distance = std::numeric_limits<float>::infinity());
+
+} // namespace inexor::vulkan_renderer::world
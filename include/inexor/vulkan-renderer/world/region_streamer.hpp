@@ -0,0 +1,132 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_mesher.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// A world made of a grid of region root cubes, each stored in its own NXOC file in one directory.
+/// update() loads the regions around the camera on background threads, the nearest first, and unloads regions which
+/// are out of range or the farthest ones if the memory budget is exceeded. Every region is meshed by its own
+/// OctreeMesher on the loading thread, so the renderer uploads and frees regions one at a time. Starting and updating
+/// the world only costs time for the regions around the camera, independent of the size of the world.
+/// Regions without a file are empty.
+class RegionStreamer {
+public:
+    /// Position of a region in the grid, the region covers [coordinate, coordinate + 1) * region size.
+    using RegionCoordinate = std::array<std::int32_t, 3>;
+
+    struct Region {
+        Cube root;
+        std::unique_ptr<OctreeMesher> mesher;
+        /// Memory of the octree and of the polygons in bytes.
+        std::size_t memory_usage;
+    };
+
+    /// The regions which were loaded and unloaded by update().
+    struct Changes {
+        std::vector<RegionCoordinate> loaded;
+        std::vector<RegionCoordinate> unloaded;
+        /// Loaded regions whose file could not be read, they are resident as empty regions.
+        std::vector<RegionCoordinate> failed;
+    };
+
+    /// Regions are unloaded when they are this much further away than the load distance, so they are not loaded and
+    /// unloaded again and again while the camera moves along the border.
+    static constexpr float UNLOAD_DISTANCE_FACTOR{1.25F};
+
+private:
+    struct LoadedRegion {
+        RegionCoordinate coordinate;
+        Region region;
+        bool failed;
+    };
+
+    std::filesystem::path m_directory;
+    float m_region_size;
+    std::size_t m_memory_budget;
+    std::size_t m_region_memory_estimate;
+    std::size_t m_mesher_region_level;
+
+    std::map<RegionCoordinate, Region> m_regions;
+    std::size_t m_memory_usage{0};
+    /// Memory and number of all regions which finished loading, including unloaded ones.
+    std::size_t m_measured_memory_usage{0};
+    std::size_t m_measured_regions{0};
+    /// Regions which are requested or being loaded.
+    std::set<RegionCoordinate> m_pending;
+
+    /// Guards the members which are shared with the loading threads.
+    std::mutex m_mutex;
+    std::condition_variable m_requests_added;
+    /// The nearest region first.
+    std::deque<RegionCoordinate> m_requests;
+    std::vector<LoadedRegion> m_loaded_regions;
+    bool m_stop{false};
+    std::vector<std::thread> m_threads;
+
+    [[nodiscard]] LoadedRegion load(const RegionCoordinate &coordinate) const;
+    void run_thread();
+    /// Expected memory of a region which is not loaded yet.
+    [[nodiscard]] std::size_t expected_region_memory_usage() const noexcept;
+    /// Distance from the position to the closest point of the region.
+    [[nodiscard]] float distance(const RegionCoordinate &coordinate, const glm::vec3 &position) const noexcept;
+
+public:
+    /// @param directory The directory of the region files.
+    /// @param region_size Edge length of the root cube of every region.
+    /// @param memory_budget Maximum memory of all resident regions in bytes.
+    /// @param region_memory_estimate Expected memory of a region in bytes until regions have been loaded, afterwards
+    /// their average memory is expected.
+    /// @param thread_count Number of threads which load and mesh regions.
+    /// @param mesher_region_level The region level of the OctreeMesher of each region.
+    RegionStreamer(std::filesystem::path directory, float region_size, std::size_t memory_budget,
+                   std::size_t region_memory_estimate, std::size_t thread_count = 1,
+                   std::size_t mesher_region_level = 4);
+    RegionStreamer(const RegionStreamer &) = delete;
+    RegionStreamer(RegionStreamer &&) = delete;
+    ~RegionStreamer();
+
+    RegionStreamer &operator=(const RegionStreamer &) = delete;
+    RegionStreamer &operator=(RegionStreamer &&) = delete;
+
+    /// Take over the regions which finished loading, unload regions and request the missing regions around the camera.
+    /// @param camera_position The position of the camera.
+    /// @param load_distance Load all regions which are closer to the camera, as long as the memory budget allows it.
+    /// @return The renderer has to upload the polygons of the loaded regions and free the unloaded ones.
+    [[nodiscard]] Changes update(const glm::vec3 &camera_position, float load_distance);
+
+    [[nodiscard]] float region_size() const noexcept;
+    /// Position of the (0, 0, 0) corner of the region.
+    [[nodiscard]] glm::vec3 region_position(const RegionCoordinate &coordinate) const noexcept;
+    /// The region which contains the position.
+    [[nodiscard]] RegionCoordinate region_at(const glm::vec3 &position) const noexcept;
+    [[nodiscard]] std::filesystem::path region_path(const RegionCoordinate &coordinate) const;
+    /// The resident regions.
+    [[nodiscard]] const std::map<RegionCoordinate, Region> &regions() const noexcept;
+    /// Memory of all resident regions in bytes.
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+    /// Number of regions which are requested or being loaded.
+    [[nodiscard]] std::size_t pending_count() const noexcept;
+
+    /// Write the file of a region with the latest NXOC version, the size and position of the root cube are not stored.
+    /// A resident region is not reloaded. The file is replaced, so it can be saved while it is being loaded.
+    void save(const RegionCoordinate &coordinate, const Cube &root) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
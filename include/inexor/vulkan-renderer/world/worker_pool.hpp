@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Threads which are started once and run the iterations of parallel_for() calls, so a call only costs waking them.
+/// The pool can be shared by OctreeMesher, EditBatch, OctreeBuilder and PreviewRenderer, calls of different threads
+/// are run one after another.
+/// @warning parallel_for() must not be called from inside of an iteration on the same pool.
+class WorkerPool {
+private:
+    /// Calls the function of a parallel_for() with an iteration.
+    using Call = void (*)(const void *function, std::size_t i);
+
+    std::vector<std::thread> m_threads;
+    /// Serializes parallel_for() calls of different threads.
+    std::mutex m_run_mutex;
+    /// Guards the fields below, except for m_next.
+    std::mutex m_mutex;
+    std::condition_variable m_started;
+    std::condition_variable m_finished;
+    /// Incremented for every parallel_for() call which the threads take part in.
+    std::uint64_t m_generation{0};
+    bool m_stop{false};
+    Call m_call{nullptr};
+    const void *m_function{nullptr};
+    std::size_t m_count{0};
+    std::atomic<std::size_t> m_next{0};
+    /// Number of threads which have not finished the current call.
+    std::size_t m_busy_threads{0};
+    /// The first exception of the current call.
+    std::exception_ptr m_exception;
+
+    template <typename Function>
+    static void invoke(const void *function, const std::size_t i) {
+        (*static_cast<const Function *>(function))(i);
+    }
+    /// Run iterations of the current call until all have been started.
+    void work();
+    void thread_main();
+    void run(std::size_t count, Call call, const void *function);
+
+public:
+    /// @param thread_count Number of threads including the calling thread, which runs iterations as well.
+    explicit WorkerPool(std::size_t thread_count);
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool(WorkerPool &&) = delete;
+    ~WorkerPool();
+
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    WorkerPool &operator=(WorkerPool &&) = delete;
+
+    [[nodiscard]] std::size_t thread_count() const noexcept;
+
+    /// Call function(i) for all i in [0, count) on the threads of the pool.
+    /// The first exception thrown by an iteration is rethrown after all threads finished, the iterations which have not
+    /// been started yet are skipped.
+    template <typename Function>
+    void parallel_for(const std::size_t count, const Function &function) {
+        run(count, &WorkerPool::invoke<Function>, &function);
+    }
+};
+
+} // namespace inexor::vulkan_renderer::world
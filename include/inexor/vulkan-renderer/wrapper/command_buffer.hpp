@@ -75,7 +75,8 @@ public:
 
     /// @brief Call vkCmdDrawIndexed.
     /// @param index_count The number of indices to draw.
-    void draw_indexed(std::size_t index_count) const;
+    /// @param first_index The first index to draw.
+    void draw_indexed(std::size_t index_count, std::size_t first_index = 0) const;
 
     /// @brief Call vkCmdEndRenderPass.
     void end_render_pass() const;
@@ -2,9 +2,15 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
+// forward declaration
+namespace inexor::vulkan_renderer::tools {
+class MappedFile;
+} // namespace inexor::vulkan_renderer::tools
+
 namespace inexor::vulkan_renderer::wrapper {
 
 class Device;
@@ -17,6 +23,14 @@ class Shader {
     VkShaderStageFlagBits m_type;
     VkShaderModule m_shader_module{VK_NULL_HANDLE};
 
+    /// @brief Construct a shader module from SPIR-V code, which must be aligned to 4 bytes.
+    Shader(const Device &device, VkShaderStageFlagBits type, const std::string &name, const void *code,
+           std::size_t code_size, const std::string &entry_point);
+
+    /// @brief Construct a shader module from a mapped SPIR-V file.
+    Shader(const Device &device, VkShaderStageFlagBits type, const std::string &name, const tools::MappedFile &file,
+           const std::string &entry_point);
+
 public:
     /// @brief Construct a shader module from a block of SPIR-V memory.
     /// @param device The const reference to a device RAII wrapper instance.
@@ -15,6 +15,7 @@
 #include <spdlog/spdlog.h>
 #include <toml11/toml.hpp>
 
+#include <algorithm>
 #include <thread>
 
 namespace inexor::vulkan_renderer {
@@ -194,16 +195,23 @@ void Application::load_shaders() {
 void Application::load_octree_geometry() {
     spdlog::debug("Creating octree geometry.");
 
-    std::shared_ptr<world::Cube> cube = std::make_shared<world::Cube>(2.0f, glm::vec3{0, -1, -1});
-    cube->set_type(world::Cube::Type::OCTANT);
+    world::Cube cube(2.0f, glm::vec3{0, -1, -1});
+    cube.set_type(world::Cube::Type::OCTANT);
 
-    cube->childs()[3]->set_type(world::Cube::Type::EMPTY);
-    cube->childs()[5]->set_type(world::Cube::Type::EMPTY);
-    cube->childs()[6]->set_type(world::Cube::Type::EMPTY);
-    cube->childs()[7]->set_type(world::Cube::Type::EMPTY);
+    cube[3].set_type(world::Cube::Type::EMPTY);
+    cube[5].set_type(world::Cube::Type::EMPTY);
+    cube[6].set_type(world::Cube::Type::EMPTY);
+    cube[7].set_type(world::Cube::Type::EMPTY);
 
-    for (const auto &polygons : cube->polygons(true)) {
-        for (const auto &triangle : *polygons) {
+    m_octree_mesher = std::make_unique<world::OctreeMesher>(cube, 4, false, std::thread::hardware_concurrency());
+    m_camera_collider = std::make_unique<world::OctreeCollider>(cube);
+
+    m_octree_vertices.reserve(m_octree_mesher->polygon_count() * 3);
+    m_octree_region_indices.clear();
+    for (const auto &[key, region] : m_octree_mesher->regions()) {
+        // generate_octree_indices() keeps one index per vertex
+        m_octree_region_indices.emplace_back(key, static_cast<std::uint32_t>(m_octree_vertices.size()));
+        for (const auto &triangle : region.polygons) {
             for (const auto &vertex : triangle) {
                 glm::vec3 color = {
                     static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
@@ -516,6 +524,33 @@ void Application::update_uniform_buffers() {
     m_uniform_buffers[0].update(&ubo, sizeof(ubo));
 }
 
+void Application::update_octree_draw_ranges() {
+    const auto region_index = [&](const world::OctreeMesher::RegionKey key) {
+        const auto region = std::lower_bound(m_octree_region_indices.begin(), m_octree_region_indices.end(), key,
+                                             [](const auto &lhs, const auto rhs) { return lhs.first < rhs; });
+        return region == m_octree_region_indices.end() ? static_cast<std::uint32_t>(m_octree_indices.size())
+                                                       : region->second;
+    };
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> draw_ranges;
+    for (const auto &range : m_octree_mesher->visible_regions(m_camera->frustum_planes())) {
+        const std::uint32_t first_index = region_index(range.first);
+        const std::uint32_t last_index = region_index(range.last);
+        if (first_index < last_index) {
+            draw_ranges.emplace_back(first_index, last_index - first_index);
+        }
+    }
+    if (draw_ranges == m_octree_draw_ranges) {
+        return;
+    }
+
+    // The ranges are recorded into the command buffers, each frame records its command buffers again before its next
+    // submission once the device is done with them.
+    // TODO: Write the ranges into an indirect draw buffer, so changed ranges do not require recording again.
+    m_octree_draw_ranges = std::move(draw_ranges);
+    m_render_graph->invalidate_command_buffers();
+}
+
 void Application::update_imgui_overlay() {
     auto cursor_pos = m_input_data->get_cursor_pos();
 
@@ -577,10 +612,17 @@ void Application::run() {
     while (!m_window->should_close()) {
         m_window->poll();
         update_uniform_buffers();
+        update_octree_draw_ranges();
         update_imgui_overlay();
         render_frame();
         process_mouse_input();
+        const glm::vec3 camera_position = m_camera->position();
         m_camera->update(m_time_passed);
+        // the camera slides along walls instead of moving through them
+        constexpr float CAMERA_RADIUS{0.1f};
+        const world::SlideResult slide = m_camera_collider->slide(
+            {camera_position, camera_position, CAMERA_RADIUS}, m_camera->position() - camera_position);
+        m_camera->set_position(camera_position + slide.motion);
         m_time_passed = m_stopwatch.time_step();
     }
 }
@@ -30,10 +30,30 @@ void Camera::update_matrices() {
     if (m_type == CameraType::LOOK_AT) {
         m_view_matrix = glm::lookAt(m_position, m_position + m_front, m_up);
         m_perspective_matrix = glm::perspective(glm::radians(m_fov), m_aspect_ratio, m_near_plane, m_far_plane);
+        update_frustum_planes();
         m_update_needed = false;
     }
 }
 
+void Camera::update_frustum_planes() {
+    // Gribb/Hartmann plane extraction, glm matrices are column major.
+    const glm::mat4 matrix = m_perspective_matrix * m_view_matrix;
+    const auto row = [&](const int i) { return glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]); };
+    m_frustum_planes = {
+        row(3) + row(0), // left
+        row(3) - row(0), // right
+        row(3) + row(1), // bottom
+        row(3) - row(1), // top
+        row(2),          // near, the depth range is [0, 1] because of GLM_FORCE_DEPTH_ZERO_TO_ONE
+        // Far, row(3) - row(2) cancels out to the ratio of the near and the far plane, which is below the float
+        // precision for the default planes.
+        glm::vec4(-m_front, glm::dot(m_front, m_position) + m_far_plane),
+    };
+    for (auto &plane : m_frustum_planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+}
+
 bool Camera::is_moving() const {
     return m_keys[0] || m_keys[1] || m_keys[2] || m_keys[3];
 }
@@ -1,41 +1,60 @@
 #include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/exception.hpp"
+#include "inexor/vulkan-renderer/tools/mapped_file.hpp"
 #include "inexor/vulkan-renderer/world/cube.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <system_error>
 
 namespace inexor::vulkan_renderer::io {
-std::vector<std::uint8_t> ByteStream::read_file(const std::filesystem::path &path) {
-    std::ifstream stream(path, std::ios::in | std::ios::binary);
-    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
-}
-
 ByteStream::ByteStream(std::vector<std::uint8_t> buffer) : m_buffer(std::move(buffer)) {}
 
-ByteStream::ByteStream(const std::filesystem::path &path) : ByteStream(read_file(path)) {}
+ByteStream::ByteStream(const std::filesystem::path &path) : ByteStream(std::make_shared<tools::MappedFile>(path)) {}
+
+ByteStream::ByteStream(std::shared_ptr<const tools::MappedFile> file) : m_file(std::move(file)) {}
 
 std::size_t ByteStream::size() const {
-    return m_buffer.size();
+    return m_file ? m_file->size() : m_buffer.size();
 }
-const std::vector<std::uint8_t> &ByteStream::buffer() const {
-    return m_buffer;
+
+const std::uint8_t *ByteStream::data() const {
+    return m_file ? m_file->data() : m_buffer.data();
+}
+
+void ByteStream::write_file(const std::filesystem::path &path) const {
+    // Readers may have mapped the old file, truncating it would crash them on their next access.
+    std::filesystem::path temporary_path = path;
+    temporary_path += ".tmp";
+    std::ofstream stream(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char *>(data()), static_cast<std::streamsize>(size()));
+    stream.close();
+    std::error_code error;
+    if (stream) {
+        std::filesystem::rename(temporary_path, path, error);
+    }
+    if (!stream || error) {
+        std::filesystem::remove(temporary_path, error);
+        throw IoException("Could not write " + path.string() + ".");
+    }
 }
 
 void ByteStreamReader::check_end(const std::size_t size) const {
-    if (static_cast<std::size_t>(std::distance(m_iter, m_stream.buffer().end())) < size) {
+    if (remaining() < size) {
         throw std::runtime_error("end would be overrun");
     }
 }
 
-ByteStreamReader::ByteStreamReader(const ByteStream &stream) : m_stream(stream), m_iter(stream.buffer().begin()) {}
+ByteStreamReader::ByteStreamReader(const ByteStream &stream)
+    : m_iter(stream.data()), m_end(stream.data() + stream.size()) {}
 
 void ByteStreamReader::skip(const std::size_t size) {
-    const std::size_t skip = std::min(
-        size, std::size_t(std::distance<std::vector<std::uint8_t>::const_iterator>(m_iter, m_stream.buffer().end())));
-    std::advance(m_iter, skip);
+    m_iter += std::min(size, remaining());
 }
 
 std::size_t ByteStreamReader::remaining() const {
-    return std::distance<std::vector<std::uint8_t>::const_iterator>(m_iter, m_stream.buffer().end());
+    return static_cast<std::size_t>(m_end - m_iter);
 }
 
 template <>
@@ -47,33 +66,41 @@ std::uint8_t ByteStreamReader::read() {
 template <>
 std::uint32_t ByteStreamReader::read() {
     check_end(4);
-    return (*m_iter++ << 0U) | (*m_iter++ << 8U) | (*m_iter++ << 16U) | (*m_iter++ << 24U);
+    std::uint32_t value = 0;
+    for (std::uint32_t shift = 0; shift < 32; shift += 8) {
+        value |= static_cast<std::uint32_t>(*m_iter++) << shift;
+    }
+    return value;
 }
 
 template <>
 std::string ByteStreamReader::read(const std::size_t &size) {
     check_end(size);
-    auto start = m_iter;
-    std::advance(m_iter, size);
+    const auto *start = m_iter;
+    m_iter += size;
     return std::string(start, m_iter);
 }
 
 template <>
 world::Cube::Type ByteStreamReader::read() {
-    return static_cast<world::Cube::Type>(read<std::uint8_t>());
+    const auto type = read<std::uint8_t>();
+    if (type > static_cast<std::uint8_t>(world::Cube::Type::OCTANT)) {
+        throw IoException("Invalid cube type.");
+    }
+    return static_cast<world::Cube::Type>(type);
 }
 
 template <>
 std::array<world::Indentation, 12> ByteStreamReader::read() {
-    check_end(9);
+    check_end(world::PACKED_INDENTATIONS_BYTES);
+    std::array<std::uint8_t, 12> uids{};
+    m_iter = world::unpack_indentation_uids(m_iter, uids);
     std::array<world::Indentation, 12> indentations;
-    auto writer = indentations.begin();
-    const auto end = m_iter + 9;
-    while (m_iter != end) {
-        *writer++ = world::Indentation(*m_iter >> 2U);
-        *writer++ = world::Indentation(((*m_iter & 0b00000011U) << 4U) | (*(++m_iter) >> 4U));
-        *writer++ = world::Indentation(((*m_iter & 0b00001111U) << 2U) | (*(++m_iter) >> 6U));
-        *writer++ = world::Indentation(*m_iter++ & 0b00111111U);
+    for (std::size_t i = 0; i < uids.size(); i++) {
+        if (uids[i] > world::Indentation::MAX_UID) {
+            throw IoException("Invalid indentation.");
+        }
+        indentations[i] = world::Indentation(uids[i]);
     }
     return indentations;
 }
@@ -85,10 +112,11 @@ void ByteStreamWriter::write(const std::uint8_t &value) {
 
 template <>
 void ByteStreamWriter::write(const std::uint32_t &value) {
-    m_buffer.emplace_back(value >> 24U);
-    m_buffer.emplace_back(value >> 16U);
-    m_buffer.emplace_back(value >> 8U);
+    // little endian, like the reader
     m_buffer.emplace_back(value);
+    m_buffer.emplace_back(value >> 8U);
+    m_buffer.emplace_back(value >> 16U);
+    m_buffer.emplace_back(value >> 24U);
 }
 
 template <>
@@ -103,10 +131,6 @@ void ByteStreamWriter::write(const world::Cube::Type &value) {
 
 template <>
 void ByteStreamWriter::write(const std::array<world::Indentation, 12> &value) {
-    for (auto iter = value.begin(); iter != value.end(); iter++) {
-        write<std::uint8_t>((iter->uid() << 2U) | ((++iter)->uid() >> 4));
-        write<std::uint8_t>((iter->uid() << 4U) | ((++iter)->uid() >> 2));
-        write<std::uint8_t>((iter->uid() << 6U) | ((++iter)->uid()));
-    }
+    world::pack_indentations(value, std::back_inserter(m_buffer));
 }
 } // namespace inexor::vulkan_renderer::io
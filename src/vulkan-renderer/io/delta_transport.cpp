@@ -0,0 +1,91 @@
+#include "inexor/vulkan-renderer/io/delta_transport.hpp"
+
+#include "inexor/vulkan-renderer/io/exception.hpp"
+
+#include <fstream>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+/// The size in front of every delta of a file.
+constexpr std::size_t SIZE_BYTES{4};
+} // namespace
+
+LoopbackTransport::LoopbackTransport(std::shared_ptr<Channel> incoming, std::shared_ptr<Channel> outgoing)
+    : m_incoming(std::move(incoming)), m_outgoing(std::move(outgoing)) {}
+
+std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> LoopbackTransport::connect() {
+    auto first_to_second = std::make_shared<Channel>();
+    auto second_to_first = std::make_shared<Channel>();
+    // the constructor is private
+    return {std::unique_ptr<LoopbackTransport>(new LoopbackTransport(second_to_first, first_to_second)),
+            std::unique_ptr<LoopbackTransport>(new LoopbackTransport(first_to_second, second_to_first))};
+}
+
+void LoopbackTransport::send(const ByteStream &delta) {
+    std::scoped_lock lock(m_outgoing->mutex);
+    m_outgoing->deltas.push_back(delta);
+}
+
+std::optional<ByteStream> LoopbackTransport::receive() {
+    std::scoped_lock lock(m_incoming->mutex);
+    if (m_incoming->deltas.empty()) {
+        return std::nullopt;
+    }
+    ByteStream delta = std::move(m_incoming->deltas.front());
+    m_incoming->deltas.pop_front();
+    return delta;
+}
+
+FileTransport::FileTransport(std::filesystem::path send_path, std::filesystem::path receive_path)
+    : m_send_path(std::move(send_path)), m_receive_path(std::move(receive_path)) {}
+
+void FileTransport::send(const ByteStream &delta) {
+    if (delta.size() > MAX_DELTA_SIZE) {
+        throw IoException("The delta is too large to be sent.");
+    }
+    ByteStreamWriter writer;
+    writer.write(static_cast<std::uint32_t>(delta.size()));
+    std::ofstream stream(m_send_path, std::ios::out | std::ios::binary | std::ios::app);
+    stream.write(reinterpret_cast<const char *>(writer.data()), SIZE_BYTES);
+    stream.write(reinterpret_cast<const char *>(delta.data()), static_cast<std::streamsize>(delta.size()));
+    stream.flush();
+    if (!stream) {
+        throw IoException("Could not write " + m_send_path.string() + ".");
+    }
+}
+
+std::optional<ByteStream> FileTransport::receive() {
+    std::ifstream stream(m_receive_path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!stream) {
+        return std::nullopt;
+    }
+    const std::streamoff file_size = stream.tellg();
+    if (file_size < 0 || static_cast<std::uint64_t>(file_size) < m_receive_offset + SIZE_BYTES ||
+        !stream.seekg(static_cast<std::streamoff>(m_receive_offset))) {
+        return std::nullopt;
+    }
+    std::vector<std::uint8_t> size_bytes(SIZE_BYTES);
+    if (!stream.read(reinterpret_cast<char *>(size_bytes.data()), SIZE_BYTES)) {
+        return std::nullopt;
+    }
+    const ByteStream size_stream(std::move(size_bytes));
+    ByteStreamReader size_reader(size_stream);
+    const auto size = size_reader.read<std::uint32_t>();
+    if (size > MAX_DELTA_SIZE) {
+        throw IoException("Invalid delta size in " + m_receive_path.string() + ".");
+    }
+    // the delta is not completely written yet
+    if (static_cast<std::uint64_t>(file_size) - m_receive_offset - SIZE_BYTES < size) {
+        return std::nullopt;
+    }
+    std::vector<std::uint8_t> buffer(size);
+    if (!stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+        return std::nullopt;
+    }
+    m_receive_offset += SIZE_BYTES + buffer.size();
+    return ByteStream(std::move(buffer));
+}
+
+} // namespace inexor::vulkan_renderer::io
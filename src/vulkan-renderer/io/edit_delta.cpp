@@ -0,0 +1,281 @@
+#include "inexor/vulkan-renderer/io/edit_delta.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/exception.hpp"
+#include "inexor/vulkan-renderer/world/edit_batch.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <string>
+#include <utility>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+constexpr std::size_t IDENTIFIER_SIZE{12};
+
+/// A run of one cube is the most common case, so the type of a set_type is stored in the tag.
+constexpr std::uint8_t OPERATION_MASK{0b11U};
+constexpr std::uint8_t TYPE_SHIFT{2};
+
+/// Is the cube of other inside of the cube of code.
+bool contains(const world::MortonCode code, const std::size_t level, const world::MortonCode other,
+              const std::size_t other_level) {
+    return other_level >= level && other >> (3 * (other_level - level)) == code;
+}
+
+/// Seven bits per byte, the highest bit marks a following byte.
+void write_varint(ByteStreamWriter &writer, std::uint64_t value) {
+    while (value >= 0x80U) {
+        writer.write(static_cast<std::uint8_t>(value | 0x80U));
+        value >>= 7U;
+    }
+    writer.write(static_cast<std::uint8_t>(value));
+}
+
+std::uint64_t read_varint(ByteStreamReader &reader) {
+    std::uint64_t value = 0;
+    for (std::uint32_t shift = 0; shift < 64; shift += 7) {
+        const auto byte = reader.read<std::uint8_t>();
+        value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0) {
+            return value;
+        }
+    }
+    throw IoException("Invalid variable length number.");
+}
+
+/// Signed differences with small absolute values get short encodings.
+std::uint64_t zigzag(const world::MortonCode from, const world::MortonCode to) {
+    const std::uint64_t difference = to - from;
+    return difference >> 63U != 0 ? ~(difference << 1U) : difference << 1U;
+}
+
+world::MortonCode unzigzag(const world::MortonCode from, const std::uint64_t value) {
+    return from + ((value & 1U) != 0 ? ~(value >> 1U) : value >> 1U);
+}
+
+/// Is the code the one of a cube at the level.
+bool valid_code(const world::MortonCode code, const std::size_t level) {
+    return level <= world::MAX_MORTON_LEVEL && code >> (3 * level) == 1;
+}
+} // namespace
+
+bool EditDelta::Edit::same_operation(const Edit &other) const noexcept {
+    if (operation != other.operation) {
+        return false;
+    }
+    switch (operation) {
+    case Operation::SET_TYPE:
+        return type == other.type;
+    case Operation::SET_INDENTATIONS:
+        return indentations == other.indentations;
+    case Operation::SET_INDENT:
+        return edge_id == other.edge_id && indentations[0] == other.indentations[0];
+    case Operation::INDENT:
+        return edge_id == other.edge_id && positive_direction == other.positive_direction && steps == other.steps;
+    }
+    return false;
+}
+
+EditDelta::Edit &EditDelta::add(const world::MortonCode code, const Operation operation) {
+    assert(valid_code(code, world::morton_level(code)));
+    Edit &edit = m_edits.emplace_back();
+    edit.code = code;
+    edit.operation = operation;
+    return edit;
+}
+
+std::vector<EditDelta::Edit> EditDelta::encoding_order() const {
+    std::vector<std::size_t> levels(m_edits.size());
+    std::transform(m_edits.begin(), m_edits.end(), levels.begin(),
+                   [](const Edit &edit) { return world::morton_level(edit.code); });
+    // pre-order, the edits of one cube keep their order
+    std::vector<std::size_t> order(m_edits.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const std::size_t lhs, const std::size_t rhs) {
+        return std::make_pair(m_edits[lhs].code << (3 * (world::MAX_MORTON_LEVEL - levels[lhs])), levels[lhs]) <
+               std::make_pair(m_edits[rhs].code << (3 * (world::MAX_MORTON_LEVEL - levels[rhs])), levels[rhs]);
+    });
+    // The edits within the first cube of a subtree follow it in pre-order. They do not commute with each other, so
+    // they are restored to the order of the calls.
+    for (auto first = order.begin(); first != order.end();) {
+        auto last = std::find_if(first + 1, order.end(), [&](const std::size_t edit) {
+            return !contains(m_edits[*first].code, levels[*first], m_edits[edit].code, levels[edit]);
+        });
+        std::sort(first, last);
+        first = last;
+    }
+    std::vector<Edit> edits;
+    edits.reserve(order.size());
+    for (const std::size_t edit : order) {
+        edits.push_back(m_edits[edit]);
+    }
+    return edits;
+}
+
+EditDelta::EditDelta(const ByteStream &stream) {
+    ByteStreamReader reader(stream);
+    if (reader.read<std::string>(IDENTIFIER_SIZE) != "Inexor Delta") {
+        throw IoException("Wrong identifier.");
+    }
+    if (reader.read<std::uint32_t>() != 0) {
+        throw IoException("Unsupported delta version.");
+    }
+    const std::size_t max_edits = std::min(MAX_EDITS, stream.size() * MAX_EDITS_PER_BYTE);
+    world::MortonCode previous = 1;
+    while (reader.remaining() > 0) {
+        const auto tag = reader.read<std::uint8_t>();
+        const world::MortonCode first = unzigzag(previous, read_varint(reader));
+        const std::uint64_t count = read_varint(reader);
+        if (first == 0 || !valid_code(first, world::morton_level(first))) {
+            throw IoException("Invalid Morton code.");
+        }
+        const std::size_t level = world::morton_level(first);
+        if (count == 0 || count > max_edits - m_edits.size() || !valid_code(first + count - 1, level)) {
+            throw IoException("Invalid run length.");
+        }
+        Edit edit{};
+        edit.operation = static_cast<Operation>(tag & OPERATION_MASK);
+        if (edit.operation == Operation::SET_TYPE) {
+            if (tag >> TYPE_SHIFT > static_cast<std::uint8_t>(world::Cube::Type::OCTANT)) {
+                throw IoException("Invalid cube type.");
+            }
+            edit.type = static_cast<world::Cube::Type>(tag >> TYPE_SHIFT);
+        } else if (tag >> TYPE_SHIFT != 0) {
+            throw IoException("Invalid operation.");
+        }
+        switch (edit.operation) {
+        case Operation::SET_TYPE:
+            break;
+        case Operation::SET_INDENTATIONS:
+            edit.indentations = reader.read<std::array<world::Indentation, world::Cube::EDGES>>();
+            break;
+        case Operation::SET_INDENT:
+            edit.edge_id = reader.read<std::uint8_t>();
+            if (const auto uid = reader.read<std::uint8_t>(); uid <= world::Indentation::MAX_UID) {
+                edit.indentations[0] = world::Indentation(uid);
+            } else {
+                throw IoException("Invalid indentation.");
+            }
+            break;
+        case Operation::INDENT:
+            edit.edge_id = reader.read<std::uint8_t>();
+            edit.positive_direction = (edit.edge_id & 0x80U) != 0;
+            edit.edge_id &= 0x7FU;
+            edit.steps = reader.read<std::uint8_t>();
+            break;
+        }
+        if (edit.edge_id >= world::Cube::EDGES) {
+            throw IoException("Invalid edge.");
+        }
+        for (std::uint64_t i = 0; i < count; i++) {
+            edit.code = first + i;
+            m_edits.push_back(edit);
+        }
+        previous = first + count - 1;
+    }
+}
+
+void EditDelta::set_type(const world::MortonCode code, const world::Cube::Type new_type) {
+    add(code, Operation::SET_TYPE).type = new_type;
+}
+
+void EditDelta::set_indentations(const world::MortonCode code,
+                                 const std::array<world::Indentation, world::Cube::EDGES> &indentations) {
+    add(code, Operation::SET_INDENTATIONS).indentations = indentations;
+}
+
+void EditDelta::set_indent(const world::MortonCode code, const std::uint8_t edge_id,
+                           const world::Indentation indentation) {
+    assert(edge_id < world::Cube::EDGES);
+    Edit &edit = add(code, Operation::SET_INDENT);
+    edit.edge_id = edge_id;
+    edit.indentations[0] = indentation;
+}
+
+void EditDelta::indent(const world::MortonCode code, const std::uint8_t edge_id, const bool positive_direction,
+                       const std::uint8_t steps) {
+    assert(edge_id < world::Cube::EDGES);
+    Edit &edit = add(code, Operation::INDENT);
+    edit.edge_id = edge_id;
+    edit.positive_direction = positive_direction;
+    edit.steps = steps;
+}
+
+std::size_t EditDelta::size() const noexcept {
+    return m_edits.size();
+}
+
+bool EditDelta::empty() const noexcept {
+    return m_edits.empty();
+}
+
+void EditDelta::clear() noexcept {
+    m_edits.clear();
+}
+
+ByteStream EditDelta::serialize(const std::uint32_t version) const {
+    if (version != 0) {
+        throw IoException("Unsupported delta version.");
+    }
+    ByteStreamWriter writer;
+    writer.write<std::string>("Inexor Delta");
+    writer.write(version);
+
+    const std::vector<Edit> edits = encoding_order();
+    world::MortonCode previous = 1;
+    for (std::size_t first = 0; first < edits.size();) {
+        const Edit &edit = edits[first];
+        const std::size_t level = world::morton_level(edit.code);
+        std::size_t last = first + 1;
+        while (last < edits.size() && edits[last].code == edits[last - 1].code + 1 &&
+               valid_code(edits[last].code, level) && edits[last].same_operation(edit)) {
+            last++;
+        }
+        writer.write(static_cast<std::uint8_t>(
+            static_cast<std::uint8_t>(edit.operation) |
+            (edit.operation == Operation::SET_TYPE ? static_cast<std::uint8_t>(edit.type) << TYPE_SHIFT : 0)));
+        write_varint(writer, zigzag(previous, edit.code));
+        write_varint(writer, last - first);
+        switch (edit.operation) {
+        case Operation::SET_TYPE:
+            break;
+        case Operation::SET_INDENTATIONS:
+            writer.write(edit.indentations);
+            break;
+        case Operation::SET_INDENT:
+            writer.write(edit.edge_id);
+            writer.write(edit.indentations[0].uid());
+            break;
+        case Operation::INDENT:
+            writer.write(static_cast<std::uint8_t>(edit.edge_id | (edit.positive_direction ? 0x80U : 0)));
+            writer.write(edit.steps);
+            break;
+        }
+        previous = edits[last - 1].code;
+        first = last;
+    }
+    return writer;
+}
+
+void EditDelta::apply(world::EditBatch &batch) const {
+    for (const Edit &edit : m_edits) {
+        switch (edit.operation) {
+        case Operation::SET_TYPE:
+            batch.set_type(edit.code, edit.type);
+            break;
+        case Operation::SET_INDENTATIONS:
+            batch.set_indentations(edit.code, edit.indentations);
+            break;
+        case Operation::SET_INDENT:
+            batch.set_indent(edit.code, edit.edge_id, edit.indentations[0]);
+            break;
+        case Operation::INDENT:
+            batch.indent(edit.code, edit.edge_id, edit.positive_direction, edit.steps);
+            break;
+        }
+    }
+}
+
+} // namespace inexor::vulkan_renderer::io
@@ -3,78 +3,170 @@
 #include "inexor/vulkan-renderer/io/byte_stream.hpp"
 #include "inexor/vulkan-renderer/io/exception.hpp"
 #include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/octree_dag.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
 
 #include <fstream>
-#include <functional>
 #include <utility>
+#include <vector>
 
 namespace inexor::vulkan_renderer::io {
+namespace {
+/// Version 1: marks a copy of a subtree which has been written before, followed by the number of its first copy.
+constexpr std::uint8_t SUBTREE_REFERENCE{4};
+
+/// Read a version 1 subtree into the DAG.
+/// @param copies The DAG nodes of all subtrees which have been read so far, in pre-order.
+world::OctreeDag::NodeId read_subtree(ByteStreamReader &reader, world::OctreeDag &dag,
+                                      std::vector<world::OctreeDag::NodeId> &copies, const std::size_t depth) {
+    if (depth > world::MAX_TRAVERSAL_DEPTH) {
+        throw IoException("Octree is too deep.");
+    }
+    const auto tag = reader.read<std::uint8_t>();
+    if (tag == SUBTREE_REFERENCE) {
+        const auto copy = reader.read<std::uint32_t>();
+        if (copy >= copies.size() || copies[copy] == world::OctreeDag::INVALID_NODE) {
+            throw IoException("Invalid subtree reference.");
+        }
+        return copies[copy];
+    }
+    if (tag > static_cast<std::uint8_t>(world::Cube::Type::OCTANT)) {
+        throw IoException("Invalid cube type.");
+    }
+    const std::size_t copy = copies.size();
+    copies.push_back(world::OctreeDag::INVALID_NODE);
+    const auto type = static_cast<world::Cube::Type>(tag);
+    world::OctreeDag::NodeId node = world::OctreeDag::INVALID_NODE;
+    switch (type) {
+    case world::Cube::Type::EMPTY:
+    case world::Cube::Type::SOLID:
+        node = dag.leaf(type);
+        break;
+    case world::Cube::Type::NORMAL:
+        node = dag.leaf(type, reader.read<std::array<world::Indentation, world::Cube::EDGES>>());
+        break;
+    case world::Cube::Type::OCTANT:
+        std::array<world::OctreeDag::NodeId, world::Cube::SUB_CUBES> children{};
+        for (auto &child : children) {
+            child = read_subtree(reader, dag, copies, depth + 1);
+        }
+        node = dag.octant(children);
+        break;
+    }
+    copies[copy] = node;
+    return node;
+}
+} // namespace
+
 template <>
-ByteStream NXOCParser::serialize_impl<0>(const std::shared_ptr<const world::Cube> cube) {
+ByteStream NXOCParser::serialize_impl<0>(const world::Cube &cube) {
     ByteStreamWriter writer;
     writer.write<std::string>("Inexor Octree");
     writer.write<std::uint32_t>(0);
 
-    std::function<void(const std::shared_ptr<const world::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &writer](const std::shared_ptr<const world::Cube> &cube) {
-        writer.write(cube->type());
-        if (cube->type() == world::Cube::Type::OCTANT) {
-            for (const auto &child : cube->childs()) {
-                iter_func(child);
-            }
-            return;
+    const world::CubePool &pool = *cube.m_pool;
+    for (const world::TraversalNode &node : world::pre_order(pool, cube.m_index)) {
+        writer.write(pool.type(node.index));
+        if (pool.type(node.index) == world::Cube::Type::NORMAL) {
+            writer.write(pool.indentations(node.index));
         }
-        if (cube->type() == world::Cube::Type::NORMAL) {
-            writer.write(cube->indentations());
-        }
-    };
-
-    iter_func(cube);
+    }
     return writer;
 };
 
 template <>
-std::shared_ptr<world::Cube> NXOCParser::deserialize_impl<0>(const ByteStream &stream) {
+world::Cube NXOCParser::deserialize_impl<0>(const ByteStream &stream) {
     ByteStreamReader reader(stream);
-    std::shared_ptr<world::Cube> root = std::make_shared<world::Cube>();
+    world::Cube root;
 
     // Skip identifier, which is already checked.
     reader.skip(13);
     // Skip version.
     reader.skip(4);
 
-    std::function<void(std::shared_ptr<world::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &reader](std::shared_ptr<world::Cube> &cube) {
-        cube->set_type(reader.read<world::Cube::Type>());
-        if (cube->type() == world::Cube::Type::OCTANT) {
-            for (auto child : cube->childs()) {
-                iter_func(child);
-            }
-            return;
+    world::CubePool &pool = *root.m_pool;
+    // The iterator visits the children of a cube after it became an octant.
+    for (const world::TraversalNode &node : world::pre_order(pool, root.m_index)) {
+        const auto type = reader.read<world::Cube::Type>();
+        // the same depth limit as version 1, whose parser is recursive
+        if (type == world::Cube::Type::OCTANT && node.depth >= world::MAX_TRAVERSAL_DEPTH) {
+            throw IoException("Octree is too deep.");
         }
-        if (cube->type() == world::Cube::Type::NORMAL) {
-            cube->m_indentations = reader.read<std::array<world::Indentation, world::Cube::EDGES>>();
+        pool.set_type(node.index, type);
+        if (pool.type(node.index) == world::Cube::Type::NORMAL) {
+            pool.set_indentations(node.index, reader.read<std::array<world::Indentation, world::Cube::EDGES>>());
         }
-    };
-    iter_func(root);
+    }
     return root;
 }
 
-ByteStream NXOCParser::serialize(const std::shared_ptr<const world::Cube> cube, const std::uint32_t version) {
-    if (cube == nullptr) {
-        throw std::invalid_argument("cube cannot be a nullptr.");
+template <>
+ByteStream NXOCParser::serialize_impl<1>(const world::Cube &cube) {
+    ByteStreamWriter writer;
+    writer.write<std::string>("Inexor Octree");
+    writer.write<std::uint32_t>(1);
+
+    // Like version 0, but every further copy of a subtree is written as a reference to its first copy.
+    const world::OctreeDag dag(cube);
+    std::vector<std::uint32_t> first_copies(dag.node_count(), world::OctreeDag::INVALID_NODE);
+    std::uint32_t copy = 0;
+    std::vector<world::OctreeDag::NodeId> stack{dag.root()};
+    while (!stack.empty()) {
+        const world::OctreeDag::NodeId node = stack.back();
+        stack.pop_back();
+        const world::Cube::Type type = dag.type(node);
+        // a reference is larger than an empty or solid cube
+        if (first_copies[node] != world::OctreeDag::INVALID_NODE && type != world::Cube::Type::EMPTY &&
+            type != world::Cube::Type::SOLID) {
+            writer.write(SUBTREE_REFERENCE);
+            writer.write(first_copies[node]);
+            continue;
+        }
+        if (first_copies[node] == world::OctreeDag::INVALID_NODE) {
+            first_copies[node] = copy;
+        }
+        copy++;
+        writer.write(type);
+        if (type == world::Cube::Type::NORMAL) {
+            writer.write(dag.indentations(node));
+        } else if (type == world::Cube::Type::OCTANT) {
+            for (std::size_t child_id = world::Cube::SUB_CUBES; child_id-- > 0;) {
+                stack.push_back(dag.child(node, child_id));
+            }
+        }
     }
+    return writer;
+}
+
+template <>
+world::Cube NXOCParser::deserialize_impl<1>(const ByteStream &stream) {
+    ByteStreamReader reader(stream);
+
+    // Skip identifier, which is already checked.
+    reader.skip(13);
+    // Skip version.
+    reader.skip(4);
+
+    world::OctreeDag dag;
+    std::vector<world::OctreeDag::NodeId> copies;
+    dag.set_root(read_subtree(reader, dag, copies, 0));
+    const world::Cube root;
+    return dag.to_cube(root.size(), root.position());
+}
+
+ByteStream NXOCParser::serialize(const world::Cube &cube, const std::uint32_t version) {
     switch (version) {
     case 0:
         return serialize_impl<0>(cube);
+    case 1:
+        return serialize_impl<1>(cube);
     default:
         throw IoException("Unsupported octree version.");
     };
 }
 
-std::shared_ptr<world::Cube> NXOCParser::deserialize(const ByteStream &stream) {
+world::Cube NXOCParser::deserialize(const ByteStream &stream) {
     ByteStreamReader reader(stream);
     if (reader.read<std::string>(std::size_t(13)) != "Inexor Octree") {
         throw IoException("Wrong identifier.");
@@ -83,6 +175,8 @@ std::shared_ptr<world::Cube> NXOCParser::deserialize(const ByteStream &stream) {
     switch (version) {
     case 0:
         return deserialize_impl<0>(stream);
+    case 1:
+        return deserialize_impl<1>(stream);
     default:
         throw IoException("Unsupported octree version.");
     };
@@ -0,0 +1,37 @@
+#include "inexor/vulkan-renderer/io/png_encoder.hpp"
+
+#include "inexor/vulkan-renderer/io/exception.hpp"
+#include "inexor/vulkan-renderer/world/preview_renderer.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+
+ByteStream encode_png(const world::PreviewImage &image) {
+    assert(image.pixels.size() == std::size_t{4} * image.width * image.height);
+    constexpr auto MAX_EXTENT = static_cast<std::uint32_t>(std::numeric_limits<int>::max() / 4);
+    if (image.width == 0 || image.height == 0 || image.width > MAX_EXTENT || image.height > MAX_EXTENT) {
+        throw IoException("Invalid image size.");
+    }
+    std::vector<std::uint8_t> buffer;
+    const auto append = [](void *context, void *data, const int size) {
+        auto &bytes = *static_cast<std::vector<std::uint8_t> *>(context);
+        const auto *first = static_cast<const std::uint8_t *>(data);
+        bytes.insert(bytes.end(), first, first + size);
+    };
+    const int width = static_cast<int>(image.width);
+    if (stbi_write_png_to_func(append, &buffer, width, static_cast<int>(image.height), 4, image.pixels.data(),
+                               4 * width) == 0) {
+        throw IoException("Could not encode the image as PNG.");
+    }
+    return ByteStream(std::move(buffer));
+}
+
+} // namespace inexor::vulkan_renderer::io
@@ -129,61 +129,60 @@ void RenderGraph::build_pipeline_layout(const RenderStage *stage, PhysicalStage
                                    stage->m_name + " pipeline layout");
 }
 
-void RenderGraph::record_command_buffers(const RenderStage *stage, PhysicalStage *phys) const {
-    for (std::size_t i = 0; i < phys->m_command_buffers.size(); i++) {
-        // TODO: Remove simultaneous usage once we have proper max frames in flight control.
-        auto &cmd_buf = phys->m_command_buffers[i];
-        cmd_buf.begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
-
-        // Record render pass for graphics stages.
-        const auto *graphics_stage = stage->as<GraphicsStage>();
-        if (graphics_stage != nullptr) {
-            const auto *phys_graphics_stage = phys->as<PhysicalGraphicsStage>();
-            assert(phys_graphics_stage != nullptr);
-
-            auto render_pass_bi = wrapper::make_info<VkRenderPassBeginInfo>();
-            std::array<VkClearValue, 2> clear_values{};
-            if (graphics_stage->m_clears_screen) {
-                clear_values[0].color = {0, 0, 0, 0};
-                clear_values[1].depthStencil = {1.0F, 0};
-                render_pass_bi.clearValueCount = static_cast<std::uint32_t>(clear_values.size());
-                render_pass_bi.pClearValues = clear_values.data();
-            }
-            render_pass_bi.framebuffer = phys_graphics_stage->m_framebuffers[i].get();
-            render_pass_bi.renderArea.extent = m_swapchain.extent();
-            render_pass_bi.renderPass = phys_graphics_stage->m_render_pass;
-            cmd_buf.begin_render_pass(render_pass_bi);
+void RenderGraph::record_command_buffer(const RenderStage *stage, PhysicalStage *phys,
+                                        const std::size_t image_index) const {
+    // TODO: Remove simultaneous usage once we have proper max frames in flight control.
+    auto &cmd_buf = phys->m_command_buffers[image_index];
+    cmd_buf.begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
+
+    // Record render pass for graphics stages.
+    const auto *graphics_stage = stage->as<GraphicsStage>();
+    if (graphics_stage != nullptr) {
+        const auto *phys_graphics_stage = phys->as<PhysicalGraphicsStage>();
+        assert(phys_graphics_stage != nullptr);
+
+        auto render_pass_bi = wrapper::make_info<VkRenderPassBeginInfo>();
+        std::array<VkClearValue, 2> clear_values{};
+        if (graphics_stage->m_clears_screen) {
+            clear_values[0].color = {0, 0, 0, 0};
+            clear_values[1].depthStencil = {1.0F, 0};
+            render_pass_bi.clearValueCount = static_cast<std::uint32_t>(clear_values.size());
+            render_pass_bi.pClearValues = clear_values.data();
         }
+        render_pass_bi.framebuffer = phys_graphics_stage->m_framebuffers[image_index].get();
+        render_pass_bi.renderArea.extent = m_swapchain.extent();
+        render_pass_bi.renderPass = phys_graphics_stage->m_render_pass;
+        cmd_buf.begin_render_pass(render_pass_bi);
+    }
 
-        std::vector<VkBuffer> vertex_buffers;
-        for (const auto *resource : stage->m_reads) {
-            const auto *buffer_resource = resource->as<BufferResource>();
-            if (buffer_resource == nullptr) {
-                continue;
-            }
+    std::vector<VkBuffer> vertex_buffers;
+    for (const auto *resource : stage->m_reads) {
+        const auto *buffer_resource = resource->as<BufferResource>();
+        if (buffer_resource == nullptr) {
+            continue;
+        }
 
-            const auto *phys_buffer = m_resource_map.at(resource)->as<PhysicalBuffer>();
-            assert(phys_buffer != nullptr);
+        const auto *phys_buffer = m_resource_map.at(resource)->as<PhysicalBuffer>();
+        assert(phys_buffer != nullptr);
 
-            if (buffer_resource->m_usage == BufferUsage::INDEX_BUFFER) {
-                cmd_buf.bind_index_buffer(phys_buffer->m_buffer);
-            } else if (buffer_resource->m_usage == BufferUsage::VERTEX_BUFFER) {
-                vertex_buffers.push_back(phys_buffer->m_buffer);
-            }
+        if (buffer_resource->m_usage == BufferUsage::INDEX_BUFFER) {
+            cmd_buf.bind_index_buffer(phys_buffer->m_buffer);
+        } else if (buffer_resource->m_usage == BufferUsage::VERTEX_BUFFER) {
+            vertex_buffers.push_back(phys_buffer->m_buffer);
         }
+    }
 
-        if (!vertex_buffers.empty()) {
-            cmd_buf.bind_vertex_buffers(vertex_buffers);
-        }
+    if (!vertex_buffers.empty()) {
+        cmd_buf.bind_vertex_buffers(vertex_buffers);
+    }
 
-        cmd_buf.bind_graphics_pipeline(phys->m_pipeline);
-        stage->m_on_record(phys, cmd_buf);
+    cmd_buf.bind_graphics_pipeline(phys->m_pipeline);
+    stage->m_on_record(phys, cmd_buf);
 
-        if (graphics_stage != nullptr) {
-            cmd_buf.end_render_pass();
-        }
-        cmd_buf.end();
+    if (graphics_stage != nullptr) {
+        cmd_buf.end_render_pass();
     }
+    cmd_buf.end();
 }
 
 void RenderGraph::build_render_pass(const GraphicsStage *stage, PhysicalGraphicsStage *phys) const {
@@ -504,12 +503,37 @@ void RenderGraph::compile(const RenderResource &target) {
     for (const auto *stage : m_stage_stack) {
         auto *phys = m_stage_map[stage].get();
         alloc_command_buffers(stage, phys);
-        record_command_buffers(stage, phys);
+        for (std::uint32_t i = 0; i < m_swapchain.image_count(); i++) {
+            record_command_buffer(stage, phys, i);
+        }
+    }
+
+    // Create the frame fences in signaled state, the first wait in render() must not block.
+    m_log->trace("Creating fences for {} frames", m_swapchain.image_count());
+    for (std::uint32_t i = 0; i < m_swapchain.image_count(); i++) {
+        m_frame_fences.emplace_back(m_device, "Render graph frame " + std::to_string(i), true);
     }
+    m_outdated_frames.assign(m_swapchain.image_count(), false);
+}
+
+void RenderGraph::invalidate_command_buffers() {
+    m_outdated_frames.assign(m_outdated_frames.size(), true);
 }
 
 void RenderGraph::render(int image_index, VkSemaphore signal_semaphore, VkSemaphore wait_semaphore,
-                         VkQueue graphics_queue) const {
+                         VkQueue graphics_queue) {
+    // The command buffers of this frame may only be recorded again once the device finished executing them.
+    const auto &frame_fence = m_frame_fences[image_index];
+    frame_fence.block();
+    frame_fence.reset();
+
+    if (m_outdated_frames[image_index]) {
+        for (const auto *stage : m_stage_stack) {
+            record_command_buffer(stage, m_stage_map.at(stage).get(), image_index);
+        }
+        m_outdated_frames[image_index] = false;
+    }
+
     auto submit_info = wrapper::make_info<VkSubmitInfo>();
     submit_info.commandBufferCount = 1;
     submit_info.signalSemaphoreCount = 1;
@@ -526,6 +550,9 @@ void RenderGraph::render(int image_index, VkSemaphore signal_semaphore, VkSemaph
         submit_info.pCommandBuffers = &cmd_buf;
         vkQueueSubmit(graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
     }
+
+    // A submission without batches signals the fence once all previously submitted work on the queue completed.
+    vkQueueSubmit(graphics_queue, 0, nullptr, frame_fence.get());
 }
 
 } // namespace inexor::vulkan_renderer
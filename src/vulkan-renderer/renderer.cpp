@@ -43,7 +43,9 @@ void VulkanRenderer::setup_render_graph() {
     main_stage.set_clears_screen(true);
     main_stage.set_on_record([&](const PhysicalStage *phys, const wrapper::CommandBuffer &cmd_buf) {
         cmd_buf.bind_descriptor(m_descriptors[0], phys->pipeline_layout());
-        cmd_buf.draw_indexed(m_octree_indices.size());
+        for (const auto &[first_index, index_count] : m_octree_draw_ranges) {
+            cmd_buf.draw_indexed(index_count, first_index);
+        }
     });
 
     for (const auto &shader : m_shaders) {
@@ -67,6 +69,7 @@ void VulkanRenderer::generate_octree_indices() {
         m_octree_indices.push_back(vertex_map.at(vertex));
     }
     spdlog::trace("Reduced octree by {} vertices", old_vertices.size() - m_octree_vertices.size());
+    m_octree_draw_ranges = {{0, static_cast<std::uint32_t>(m_octree_indices.size())}};
 }
 
 void VulkanRenderer::recreate_swapchain() {
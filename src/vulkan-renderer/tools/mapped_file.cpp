@@ -0,0 +1,128 @@
+#include "inexor/vulkan-renderer/tools/mapped_file.hpp"
+
+#include "inexor/vulkan-renderer/exception.hpp"
+
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace inexor::vulkan_renderer::tools {
+
+#if defined(_WIN32)
+void MappedFile::map(const std::filesystem::path &path) {
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) != 0 && size.QuadPart > 0 &&
+        static_cast<std::uint64_t>(size.QuadPart) <= std::numeric_limits<std::size_t>::max()) {
+        // the view keeps the file and the mapping object open
+        if (const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+            if (const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) {
+                m_data = static_cast<const std::uint8_t *>(view);
+                m_size = static_cast<std::size_t>(size.QuadPart);
+                m_mapped = true;
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+}
+#elif defined(__unix__) || defined(__APPLE__)
+void MappedFile::map(const std::filesystem::path &path) {
+    const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return;
+    }
+    struct stat status {};
+    // mmap fails for empty files, and other files like pipes can not be mapped
+    if (fstat(file, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0 &&
+        static_cast<std::uint64_t>(status.st_size) <= std::numeric_limits<std::size_t>::max()) {
+        const auto size = static_cast<std::size_t>(status.st_size);
+        if (void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0); view != MAP_FAILED) {
+            m_data = static_cast<const std::uint8_t *>(view);
+            m_size = size;
+            m_mapped = true;
+        }
+    }
+    // the mapping keeps the file open
+    close(file);
+}
+#else
+void MappedFile::map(const std::filesystem::path &) {}
+#endif
+
+void MappedFile::read(const std::filesystem::path &path) {
+    std::ifstream stream(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!stream) {
+        throw InexorException("Could not open file " + path.string() + ".");
+    }
+    const std::streamoff size = stream.tellg();
+    if (size < 0) {
+        throw InexorException("Could not read file " + path.string() + ".");
+    }
+    m_buffer.resize(static_cast<std::size_t>(size));
+    stream.seekg(0);
+    if (!stream.read(reinterpret_cast<char *>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()))) {
+        throw InexorException("Could not read file " + path.string() + ".");
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    map(path);
+    if (!m_mapped) {
+        read(path);
+    }
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+      m_buffer(std::move(other.m_buffer)), m_mapped(std::exchange(other.m_mapped, false)) {}
+
+MappedFile::~MappedFile() {
+    if (!m_mapped) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+#elif defined(__unix__) || defined(__APPLE__)
+    munmap(const_cast<std::uint8_t *>(m_data), m_size);
+#endif
+}
+
+const std::uint8_t *MappedFile::data() const noexcept {
+    return m_data;
+}
+
+std::size_t MappedFile::size() const noexcept {
+    return m_size;
+}
+
+bool MappedFile::empty() const noexcept {
+    return m_size == 0;
+}
+
+bool MappedFile::mapped() const noexcept {
+    return m_mapped;
+}
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,355 @@
+#include "inexor/vulkan-renderer/world/collision.hpp"
+
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/range_query.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <xmmintrin.h>
+#endif
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// A sphere which moves from center to center + motion.
+struct SphereSweep {
+    glm::vec3 center;
+    glm::vec3 motion;
+    float radius;
+};
+
+/// Result of testing the plane of a triangle.
+struct PlaneTest {
+    /// The sphere touches the plane at the start or before the current first contact.
+    bool reaches;
+    /// Time at which the sphere touches the inside of the triangle, infinity if it touches an edge or corner first.
+    float face_time;
+    /// Unit normal of the triangle, pointing towards the start of the sphere.
+    glm::vec3 normal;
+};
+
+struct EdgeHit {
+    float time;
+    /// The touched point of the edge or corner.
+    glm::vec3 point;
+};
+
+constexpr float NO_CONTACT{std::numeric_limits<float>::infinity()};
+
+bool overlaps(const Box &box, const Polygon &triangle) noexcept {
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        const auto [min, max] = std::minmax({triangle[0][axis], triangle[1][axis], triangle[2][axis]});
+        if (max < box.min[axis] || min > box.max[axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// The first time in [0, max_time] at which a * t^2 + b * t + c, a squared distance minus the squared radius, is not
+/// positive. A sphere which touches already only counts if it approaches.
+std::optional<float> first_contact(const float a, const float b, const float c, const float max_time) {
+    if (c <= 0.0F) {
+        return b < 0.0F ? std::optional<float>(0.0F) : std::nullopt;
+    }
+    const float discriminant = b * b - 4.0F * a * c;
+    if (a <= 0.0F || discriminant < 0.0F) {
+        return std::nullopt;
+    }
+    const float time = (-b - std::sqrt(discriminant)) / (2.0F * a);
+    if (time < 0.0F || time > max_time) {
+        return std::nullopt;
+    }
+    return time;
+}
+
+/// Test the corners and edges of a triangle whose inside is not touched.
+std::optional<EdgeHit> test_edges(const SphereSweep &sweep, const std::array<glm::vec3, 3> &corners, float max_time) {
+    const float radius_squared = sweep.radius * sweep.radius;
+    const float speed_squared = glm::dot(sweep.motion, sweep.motion);
+    std::optional<EdgeHit> first;
+    for (const glm::vec3 &corner : corners) {
+        const glm::vec3 offset = sweep.center - corner;
+        if (const auto time = first_contact(speed_squared, 2.0F * glm::dot(sweep.motion, offset),
+                                            glm::dot(offset, offset) - radius_squared, max_time)) {
+            max_time = *time;
+            first = EdgeHit{*time, corner};
+        }
+    }
+    for (std::size_t i = 0; i < corners.size(); i++) {
+        const glm::vec3 &start = corners[i];
+        const glm::vec3 edge = corners[(i + 1) % corners.size()] - start;
+        const float edge_squared = glm::dot(edge, edge);
+        if (edge_squared == 0.0F) {
+            continue;
+        }
+        // the squared distance to the line of the edge, multiplied by edge_squared
+        const glm::vec3 offset = sweep.center - start;
+        const float edge_motion = glm::dot(edge, sweep.motion);
+        const float edge_offset = glm::dot(edge, offset);
+        const auto time = first_contact(
+            edge_squared * speed_squared - edge_motion * edge_motion,
+            2.0F * (edge_squared * glm::dot(sweep.motion, offset) - edge_motion * edge_offset),
+            edge_squared * (glm::dot(offset, offset) - radius_squared) - edge_offset * edge_offset, max_time);
+        if (!time) {
+            continue;
+        }
+        const float fraction = (edge_offset + edge_motion * *time) / edge_squared;
+        if (fraction >= 0.0F && fraction <= 1.0F) {
+            max_time = *time;
+            first = EdgeHit{*time, start + edge * fraction};
+        }
+    }
+    return first;
+}
+
+/// Test the plane of a triangle.
+PlaneTest test_plane(const SphereSweep &sweep, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c,
+                     const float max_time) {
+    const glm::vec3 ab = b - a;
+    const glm::vec3 ac = c - a;
+    const glm::vec3 cross = glm::cross(ab, ac);
+    const float length_squared = glm::dot(cross, cross);
+    if (length_squared == 0.0F) {
+        return {false, NO_CONTACT, {}};
+    }
+    glm::vec3 normal = cross / std::sqrt(length_squared);
+    float distance = glm::dot(normal, sweep.center - a);
+    if (distance < 0.0F) {
+        normal = -normal;
+        distance = -distance;
+    }
+    const float rate = glm::dot(normal, sweep.motion);
+    const bool embedded = distance <= sweep.radius;
+    const bool approaching = rate < 0.0F;
+    const float time = embedded || !approaching ? 0.0F : (distance - sweep.radius) / -rate;
+    if (!embedded && !(approaching && time <= max_time)) {
+        return {false, NO_CONTACT, normal};
+    }
+    // the point at which the sphere touches the plane
+    const glm::vec3 point = sweep.center + sweep.motion * time - normal * std::min(distance, sweep.radius);
+    const bool inside = glm::dot(glm::cross(ab, point - a), cross) >= 0.0F &&
+                        glm::dot(glm::cross(c - b, point - b), cross) >= 0.0F &&
+                        glm::dot(glm::cross(a - c, point - c), cross) >= 0.0F;
+    return {true, approaching && inside ? time : NO_CONTACT, normal};
+}
+
+#if defined(__SSE2__)
+/// The same coordinate of four vectors.
+struct Vectors {
+    __m128 x;
+    __m128 y;
+    __m128 z;
+};
+
+Vectors splat(const glm::vec3 &vector) {
+    return {_mm_set1_ps(vector.x), _mm_set1_ps(vector.y), _mm_set1_ps(vector.z)};
+}
+
+Vectors add(const Vectors &lhs, const Vectors &rhs) {
+    return {_mm_add_ps(lhs.x, rhs.x), _mm_add_ps(lhs.y, rhs.y), _mm_add_ps(lhs.z, rhs.z)};
+}
+
+Vectors sub(const Vectors &lhs, const Vectors &rhs) {
+    return {_mm_sub_ps(lhs.x, rhs.x), _mm_sub_ps(lhs.y, rhs.y), _mm_sub_ps(lhs.z, rhs.z)};
+}
+
+Vectors mul(const Vectors &lhs, const __m128 rhs) {
+    return {_mm_mul_ps(lhs.x, rhs), _mm_mul_ps(lhs.y, rhs), _mm_mul_ps(lhs.z, rhs)};
+}
+
+__m128 dot(const Vectors &lhs, const Vectors &rhs) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(lhs.x, rhs.x), _mm_mul_ps(lhs.y, rhs.y)), _mm_mul_ps(lhs.z, rhs.z));
+}
+
+Vectors cross(const Vectors &lhs, const Vectors &rhs) {
+    return {_mm_sub_ps(_mm_mul_ps(lhs.y, rhs.z), _mm_mul_ps(lhs.z, rhs.y)),
+            _mm_sub_ps(_mm_mul_ps(lhs.z, rhs.x), _mm_mul_ps(lhs.x, rhs.z)),
+            _mm_sub_ps(_mm_mul_ps(lhs.x, rhs.y), _mm_mul_ps(lhs.y, rhs.x))};
+}
+
+/// Test the planes of the four triangles starting at first.
+void test_planes(const SphereSweep &sweep, const std::array<std::vector<float>, 9> &corners, const std::size_t first,
+                 const float max_time, std::array<PlaneTest, 4> &tests) {
+    const auto load = [&](const std::size_t corner) {
+        return Vectors{_mm_loadu_ps(&corners[3 * corner][first]), _mm_loadu_ps(&corners[3 * corner + 1][first]),
+                       _mm_loadu_ps(&corners[3 * corner + 2][first])};
+    };
+    const Vectors a = load(0);
+    const Vectors b = load(1);
+    const Vectors c = load(2);
+    const Vectors ab = sub(b, a);
+    const Vectors ac = sub(c, a);
+    const Vectors cross_product = cross(ab, ac);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 length_squared = dot(cross_product, cross_product);
+    // degenerate triangles divide by zero, they are masked out by valid
+    const __m128 valid = _mm_cmpgt_ps(length_squared, zero);
+    Vectors normal = mul(cross_product, _mm_div_ps(_mm_set1_ps(1.0F), _mm_sqrt_ps(length_squared)));
+    const Vectors center = splat(sweep.center);
+    const Vectors motion = splat(sweep.motion);
+    __m128 distance = dot(normal, sub(center, a));
+    // flip the normals towards the center with the sign bit of the distance
+    const __m128 sign = _mm_and_ps(distance, _mm_set1_ps(-0.0F));
+    normal = {_mm_xor_ps(normal.x, sign), _mm_xor_ps(normal.y, sign), _mm_xor_ps(normal.z, sign)};
+    distance = _mm_xor_ps(distance, sign);
+    const __m128 rate = dot(normal, motion);
+    const __m128 radius = _mm_set1_ps(sweep.radius);
+    const __m128 embedded = _mm_cmple_ps(distance, radius);
+    const __m128 approaching = _mm_cmplt_ps(rate, zero);
+    const __m128 time = _mm_and_ps(_mm_andnot_ps(embedded, approaching),
+                                   _mm_div_ps(_mm_sub_ps(distance, radius), _mm_sub_ps(zero, rate)));
+    const __m128 reaches = _mm_and_ps(
+        valid, _mm_or_ps(embedded, _mm_and_ps(approaching, _mm_cmple_ps(time, _mm_set1_ps(max_time)))));
+    const Vectors point = sub(add(center, mul(motion, time)), mul(normal, _mm_min_ps(distance, radius)));
+    const __m128 inside =
+        _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(dot(cross(ab, sub(point, a)), cross_product), zero),
+                              _mm_cmpge_ps(dot(cross(sub(c, b), sub(point, b)), cross_product), zero)),
+                   _mm_cmpge_ps(dot(cross(sub(a, c), sub(point, c)), cross_product), zero));
+    const __m128 face = _mm_and_ps(_mm_and_ps(reaches, approaching), inside);
+    const __m128 face_time = _mm_or_ps(_mm_and_ps(face, time), _mm_andnot_ps(face, _mm_set1_ps(NO_CONTACT)));
+
+    alignas(16) std::array<float, 4> face_times;
+    alignas(16) std::array<std::array<float, 4>, 3> normals;
+    _mm_store_ps(face_times.data(), face_time);
+    _mm_store_ps(normals[0].data(), normal.x);
+    _mm_store_ps(normals[1].data(), normal.y);
+    _mm_store_ps(normals[2].data(), normal.z);
+    const int reaches_mask = _mm_movemask_ps(reaches);
+    for (std::size_t lane = 0; lane < tests.size(); lane++) {
+        tests[lane] = {((reaches_mask >> lane) & 1) != 0, face_times[lane],
+                       glm::vec3(normals[0][lane], normals[1][lane], normals[2][lane])};
+    }
+}
+#endif
+
+} // namespace
+
+OctreeCollider::OctreeCollider(Cube world) : m_world(std::move(world)) {}
+
+void OctreeCollider::add_triangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c,
+                                  const std::uint32_t cube) {
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        m_corners[axis].push_back(a[static_cast<int>(axis)]);
+        m_corners[3 + axis].push_back(b[static_cast<int>(axis)]);
+        m_corners[6 + axis].push_back(c[static_cast<int>(axis)]);
+    }
+    m_cubes.push_back(cube);
+}
+
+void OctreeCollider::collect_triangles(const Capsule &body, const glm::vec3 &motion) {
+    for (auto &coordinates : m_corners) {
+        coordinates.clear();
+    }
+    m_cubes.clear();
+    const glm::vec3 min = glm::min(body.start, body.end);
+    const glm::vec3 max = glm::max(body.start, body.end);
+    const glm::vec3 extent(body.radius);
+    const Box bounds{glm::min(min, min + motion) - extent, glm::max(max, max + motion) + extent};
+    // The capsule is a sphere at its start which is swept along the segment, so the triangles are swept the other way.
+    const glm::vec3 segment = body.end - body.start;
+    const bool sphere = glm::dot(segment, segment) == 0.0F;
+    const CubePool &pool = *m_world.pool();
+    CubePolygons built_polygons;
+    query_cubes(m_world, bounds, [&](const TraversalNode &node) {
+        for (const Polygon &polygon : cube_polygons(pool, node, built_polygons)) {
+            if (!overlaps(bounds, polygon)) {
+                continue;
+            }
+            add_triangle(polygon[0], polygon[1], polygon[2], node.index);
+            if (sphere) {
+                continue;
+            }
+            add_triangle(polygon[0] - segment, polygon[1] - segment, polygon[2] - segment, node.index);
+            for (std::size_t i = 0; i < polygon.size(); i++) {
+                const glm::vec3 &start = polygon[i];
+                const glm::vec3 &end = polygon[(i + 1) % polygon.size()];
+                add_triangle(start, end, end - segment, node.index);
+                add_triangle(start, end - segment, start - segment, node.index);
+            }
+        }
+    });
+}
+
+std::optional<Contact> OctreeCollider::sweep(const Capsule &body, const glm::vec3 &motion) {
+    collect_triangles(body, motion);
+    const auto corner = [&](const std::size_t triangle, const std::size_t corner) {
+        return glm::vec3(m_corners[3 * corner][triangle], m_corners[3 * corner + 1][triangle],
+                         m_corners[3 * corner + 2][triangle]);
+    };
+    const SphereSweep sweep{body.start, motion, body.radius};
+    std::optional<Contact> contact;
+    float max_time = 1.0F;
+    const auto test_triangle = [&](const std::size_t triangle, const PlaneTest &test) {
+        if (!test.reaches) {
+            return;
+        }
+        if (test.face_time != NO_CONTACT) {
+            // the inside of the triangle is touched before its edges and corners
+            if (test.face_time <= max_time) {
+                max_time = test.face_time;
+                contact = Contact{{m_world.pool(), m_cubes[triangle]}, max_time, test.normal};
+            }
+            return;
+        }
+        const std::array<glm::vec3, 3> corners{corner(triangle, 0), corner(triangle, 1), corner(triangle, 2)};
+        if (const auto hit = test_edges(sweep, corners, max_time)) {
+            max_time = hit->time;
+            const glm::vec3 offset = sweep.center + sweep.motion * hit->time - hit->point;
+            const float length = glm::length(offset);
+            contact =
+                Contact{{m_world.pool(), m_cubes[triangle]}, max_time, length > 0.0F ? offset / length : test.normal};
+        }
+    };
+
+    std::size_t first_scalar = 0;
+#if defined(__SSE2__)
+    first_scalar = m_cubes.size() - m_cubes.size() % 4;
+    std::array<PlaneTest, 4> tests;
+    for (std::size_t first = 0; first < first_scalar; first += tests.size()) {
+        test_planes(sweep, m_corners, first, max_time, tests);
+        for (std::size_t lane = 0; lane < tests.size(); lane++) {
+            test_triangle(first + lane, tests[lane]);
+        }
+    }
+#endif
+    for (std::size_t triangle = first_scalar; triangle < m_cubes.size(); triangle++) {
+        test_triangle(triangle,
+                      test_plane(sweep, corner(triangle, 0), corner(triangle, 1), corner(triangle, 2), max_time));
+    }
+    return contact;
+}
+
+SlideResult OctreeCollider::slide(const Capsule &body, const glm::vec3 &motion) {
+    SlideResult result{glm::vec3(0.0F), {}, 0};
+    glm::vec3 remaining = motion;
+    while (result.contact_count < MAX_SLIDE_CONTACTS) {
+        const float length = glm::length(remaining);
+        if (length == 0.0F) {
+            return result;
+        }
+        const std::optional<Contact> contact =
+            sweep({body.start + result.motion, body.end + result.motion, body.radius}, remaining);
+        if (!contact) {
+            result.motion += remaining;
+            return result;
+        }
+        // stop short of the contact to keep the skin between the body and the geometry
+        const float distance = std::max(contact->time * length - SKIN * body.radius, 0.0F);
+        result.motion += remaining * (distance / length);
+        // the rest of the motion without the part into the geometry
+        remaining *= 1.0F - contact->time;
+        remaining -= contact->normal * glm::dot(remaining, contact->normal);
+        result.normals[result.contact_count++] = contact->normal;
+    }
+    return result;
+}
+
+} // namespace inexor::vulkan_renderer::world
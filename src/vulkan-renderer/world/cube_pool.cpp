@@ -0,0 +1,878 @@
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+bool CubePool::is_geometry(const Cube::Type type) noexcept {
+    return type == Cube::Type::SOLID || type == Cube::Type::NORMAL;
+}
+
+std::optional<Cube::Type> CubePool::uniform_children(const Index idx) const noexcept {
+    if (type(idx) != Cube::Type::OCTANT) {
+        return std::nullopt;
+    }
+    const Cube::Type first_type = type(m_data[idx]);
+    if (first_type != Cube::Type::EMPTY && first_type != Cube::Type::SOLID) {
+        return std::nullopt;
+    }
+    for (std::size_t child_id = 1; child_id < Cube::SUB_CUBES; child_id++) {
+        if (type(m_data[idx] + static_cast<Index>(child_id)) != first_type) {
+            return std::nullopt;
+        }
+    }
+    return first_type;
+}
+
+void CubePool::merge_octant(const Index idx, const Cube::Type type) {
+    // a merged solid octant needs one payload instead of eight
+    m_reclaimed_bytes +=
+        Cube::SUB_CUBES * NODE_BYTES + (type == Cube::Type::SOLID ? (Cube::SUB_CUBES - 1) * PAYLOAD_BYTES : 0);
+    set_type(idx, type);
+}
+
+void CubePool::set_bits(const Index idx, const Cube::Type type) {
+    m_bits.writable(idx) = static_cast<std::uint8_t>(type);
+}
+
+void CubePool::mark_dirty(const Index idx) {
+    m_bits.writable(idx) |= DIRTY_BIT;
+    // If a parent is already dirty, all of its parents are dirty too.
+    for (Index parent_idx = m_parents[idx]; parent_idx != INVALID_INDEX && !dirty(parent_idx);
+         parent_idx = m_parents[parent_idx]) {
+        m_bits.writable(parent_idx) |= DIRTY_BIT;
+    }
+}
+
+CubePool::Index CubePool::allocate_payload() {
+    if (!m_free_payloads.empty()) {
+        const Index payload = m_free_payloads.back();
+        m_free_payloads.pop_back();
+        m_indentations.writable(payload) = {};
+        return payload;
+    }
+    m_indentations.resize(m_indentations.size() + 1);
+    m_polygon_caches.resize(m_polygon_caches.size() + 1);
+    return static_cast<Index>(m_indentations.size() - 1);
+}
+
+void CubePool::free_payload(const Index payload) {
+    m_free_payloads.push_back(payload);
+}
+
+CubePool::Index CubePool::allocate_block(const Index parent) {
+    Index first_child = static_cast<Index>(m_bits.size());
+    if (m_free_blocks.empty()) {
+        assert(m_bits.size() + Cube::SUB_CUBES < INVALID_INDEX);
+        m_bits.resize(m_bits.size() + Cube::SUB_CUBES);
+        m_parents.resize(m_parents.size() + Cube::SUB_CUBES);
+        m_data.resize(m_data.size() + Cube::SUB_CUBES);
+        m_geometry_counts.resize(m_geometry_counts.size() + Cube::SUB_CUBES);
+    } else {
+        first_child = m_free_blocks.back();
+        m_free_blocks.pop_back();
+    }
+    for (Index child = first_child; child < first_child + Cube::SUB_CUBES; child++) {
+        m_parents.writable(child) = parent;
+        // new cubes have never been meshed
+        m_bits.writable(child) = static_cast<std::uint8_t>(Cube::Type::SOLID) | DIRTY_BIT;
+        m_data.writable(child) = allocate_payload();
+        m_geometry_counts.writable(child) = 1;
+    }
+    return first_child;
+}
+
+void CubePool::free_block(const Index first_child) {
+    for (Index child = first_child; child < first_child + Cube::SUB_CUBES; child++) {
+        const Cube::Type child_type = type(child);
+        if (child_type == Cube::Type::OCTANT) {
+            free_block(m_data[child]);
+        } else if (is_geometry(child_type)) {
+            free_payload(m_data[child]);
+        }
+        set_bits(child, Cube::Type::EMPTY);
+        m_parents.writable(child) = INVALID_INDEX;
+        m_data.writable(child) = INVALID_INDEX;
+        m_geometry_counts.writable(child) = 0;
+    }
+    m_free_blocks.push_back(first_child);
+}
+
+CubePool::FaceCoverage CubePool::face_coverage(const Index idx, const std::size_t face) const noexcept {
+    const Cube::Type cube_type = type(idx);
+    if (cube_type != Cube::Type::OCTANT) {
+        return cube_type == Cube::Type::SOLID ? FaceCoverage::FULL : FaceCoverage::NONE;
+    }
+    bool any_solid = false;
+    bool all_solid = true;
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        if (!child_on_face(child_id, face)) {
+            continue;
+        }
+        const FaceCoverage coverage = face_coverage(m_data[idx] + static_cast<Index>(child_id), face);
+        any_solid = any_solid || coverage != FaceCoverage::NONE;
+        all_solid = all_solid && coverage == FaceCoverage::FULL;
+        if (any_solid && !all_solid) {
+            return FaceCoverage::PARTIAL;
+        }
+    }
+    return all_solid ? FaceCoverage::FULL : FaceCoverage::NONE;
+}
+
+std::array<CubePool::FaceCoverage, CubePool::FACES> CubePool::face_coverages(const Index idx) const noexcept {
+    std::array<FaceCoverage, FACES> coverages{};
+    for (std::size_t face = 0; face < FACES; face++) {
+        coverages[face] = face_coverage(idx, face);
+    }
+    return coverages;
+}
+
+void CubePool::mark_neighbors_dirty(const Index idx, const std::array<FaceCoverage, FACES> &old_coverages) {
+    for (std::size_t face = 0; face < FACES; face++) {
+        const FaceCoverage coverage = face_coverage(idx, face);
+        if (coverage != old_coverages[face] || coverage == FaceCoverage::PARTIAL) {
+            mark_neighbors_dirty(idx, face);
+        }
+    }
+}
+
+void CubePool::mark_neighbors_dirty(const Index idx, const std::size_t face) {
+    const Index neighbor_idx = neighbor(idx, face);
+    if (neighbor_idx != INVALID_INDEX) {
+        mark_face_dirty(neighbor_idx, opposite_face(face));
+    }
+}
+
+void CubePool::mark_face_dirty(const Index idx, const std::size_t face) {
+    mark_dirty(idx);
+    if (type(idx) != Cube::Type::OCTANT) {
+        return;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        if (child_on_face(child_id, face)) {
+            mark_face_dirty(m_data[idx] + static_cast<Index>(child_id), face);
+        }
+    }
+}
+
+void CubePool::update_child_parents(const Index idx) {
+    if (type(idx) != Cube::Type::OCTANT) {
+        return;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        m_parents.writable(m_data[idx] + child_id) = idx;
+    }
+}
+
+void CubePool::swap_nodes(const Index lhs, const Index rhs) {
+    assert(m_parents[lhs] == m_parents[rhs]);
+    std::swap(m_bits.writable(lhs), m_bits.writable(rhs));
+    std::swap(m_data.writable(lhs), m_data.writable(rhs));
+    std::swap(m_geometry_counts.writable(lhs), m_geometry_counts.writable(rhs));
+    update_child_parents(lhs);
+    update_child_parents(rhs);
+}
+
+void CubePool::copy_subtree(const CubePool &src, const Index src_idx, const Index dst_idx) {
+    const Cube::Type src_type = src.type(src_idx);
+    set_type(dst_idx, src_type);
+    if (src_type == Cube::Type::OCTANT) {
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            copy_subtree(src, src.child(src_idx, child_id), child(dst_idx, child_id));
+        }
+        return;
+    }
+    if (is_geometry(src_type)) {
+        // The cache stays valid, the cube has the same size in both octrees.
+        m_indentations.writable(m_data[dst_idx]) = src.m_indentations[src.m_data[src_idx]];
+        if (src.polygon_cache_valid(src_idx)) {
+            m_polygon_caches.writable(m_data[dst_idx]) = src.m_polygon_caches[src.m_data[src_idx]];
+        }
+        m_bits.writable(dst_idx) = src.m_bits[src_idx] | DIRTY_BIT;
+    }
+}
+
+/// 90 degree rotation.
+template <>
+void CubePool::rotate<1>(const Index idx, const Cube::RotationAxis::Type &axis) {
+    // the reorder function can be replaced by a lambda and used both cases.
+    // requires: constexpr vector
+    if (type(idx) == Cube::Type::NORMAL) {
+        std::array<Indentation, Cube::EDGES> &indentations = m_indentations.writable(m_data[idx]);
+        const Cube::RotationAxis::EdgeType &edge_rotation = std::get<1>(axis);
+        for (const auto &order : edge_rotation) {
+            std::swap(indentations[order[0]], indentations[order[1]]);
+            std::swap(indentations[order[1]], indentations[order[2]]);
+            std::swap(indentations[order[2]], indentations[order[3]]);
+        }
+        // Some indentations need to be mirrored, as the direction has changed.
+        // not the last array, as it contains the edges parallel to the axis around which we rotate
+        for (std::size_t order = 0; order < edge_rotation.size() - 1; order++) {
+            indentations[edge_rotation[order][0]].mirror();
+            indentations[edge_rotation[order][2]].mirror();
+        }
+        return;
+    }
+    if (type(idx) == Cube::Type::OCTANT) {
+        const Index first_child = m_data[idx];
+        const Cube::RotationAxis::ChildType &child_rotation = std::get<0>(axis);
+        for (const auto &order : child_rotation) {
+            swap_nodes(first_child + order[0], first_child + order[1]);
+            swap_nodes(first_child + order[1], first_child + order[2]);
+            swap_nodes(first_child + order[2], first_child + order[3]);
+        }
+        for (Index child = first_child; child < first_child + Cube::SUB_CUBES; child++) {
+            rotate<1>(child, axis);
+        }
+    }
+}
+
+/// 180 degree rotation.
+template <>
+void CubePool::rotate<2>(const Index idx, const Cube::RotationAxis::Type &axis) {
+    if (type(idx) == Cube::Type::NORMAL) {
+        std::array<Indentation, Cube::EDGES> &indentations = m_indentations.writable(m_data[idx]);
+        const Cube::RotationAxis::EdgeType &edge_rotation = std::get<1>(axis);
+        for (const auto &order : edge_rotation) {
+            std::swap(indentations[order[0]], indentations[order[2]]);
+            std::swap(indentations[order[1]], indentations[order[3]]);
+        }
+        // Some indentations need to be mirrored, as the direction has changed.
+        // not the last array, as it contains the edges parallel to the axis around which we rotate
+        for (std::size_t order = 0; order < edge_rotation.size() - 1; order++) {
+            indentations[edge_rotation[order][0]].mirror();
+            indentations[edge_rotation[order][1]].mirror();
+            indentations[edge_rotation[order][2]].mirror();
+            indentations[edge_rotation[order][3]].mirror();
+        }
+        return;
+    }
+    if (type(idx) == Cube::Type::OCTANT) {
+        const Index first_child = m_data[idx];
+        const Cube::RotationAxis::ChildType &child_rotation = std::get<0>(axis);
+        for (const auto &order : child_rotation) {
+            swap_nodes(first_child + order[0], first_child + order[2]);
+            swap_nodes(first_child + order[1], first_child + order[3]);
+        }
+        for (Index child = first_child; child < first_child + Cube::SUB_CUBES; child++) {
+            rotate<2>(child, axis);
+        }
+    }
+}
+
+/// 270 degree rotation.
+template <>
+void CubePool::rotate<3>(const Index idx, const Cube::RotationAxis::Type &axis) {
+    if (type(idx) == Cube::Type::NORMAL) {
+        std::array<Indentation, Cube::EDGES> &indentations = m_indentations.writable(m_data[idx]);
+        const Cube::RotationAxis::EdgeType &edge_rotation = std::get<1>(axis);
+        for (const auto &order : edge_rotation) {
+            std::swap(indentations[order[0]], indentations[order[3]]);
+            std::swap(indentations[order[3]], indentations[order[2]]);
+            std::swap(indentations[order[2]], indentations[order[1]]);
+        }
+        // Some indentations need to be mirrored, as the direction has changed.
+        // not the last array, as it contains the edges parallel to the axis around which we rotate
+        indentations[edge_rotation[0][1]].mirror();
+        indentations[edge_rotation[0][3]].mirror();
+        indentations[edge_rotation[1][1]].mirror();
+        indentations[edge_rotation[1][3]].mirror();
+        return;
+    }
+    if (type(idx) == Cube::Type::OCTANT) {
+        const Index first_child = m_data[idx];
+        const Cube::RotationAxis::ChildType &child_rotation = std::get<0>(axis);
+        for (const auto &order : child_rotation) {
+            swap_nodes(first_child + order[0], first_child + order[3]);
+            swap_nodes(first_child + order[3], first_child + order[2]);
+            swap_nodes(first_child + order[2], first_child + order[1]);
+        }
+        for (Index child = first_child; child < first_child + Cube::SUB_CUBES; child++) {
+            rotate<3>(child, axis);
+        }
+    }
+}
+
+void CubePool::invalidate_subtree(const Index idx) {
+    // the positions are not needed
+    visit_pre_order(*this, idx, m_position, m_size, [&](const TraversalNode &node) {
+        m_bits.writable(node.index) =
+            static_cast<std::uint8_t>((m_bits[node.index] & ~POLYGON_CACHE_VALID_BIT) | DIRTY_BIT);
+        return true;
+    });
+}
+
+void CubePool::locate(const Index idx, glm::vec3 &position, float &size) const noexcept {
+    const Index parent_idx = m_parents[idx];
+    if (parent_idx == INVALID_INDEX) {
+        position = m_position;
+        size = m_size;
+        return;
+    }
+    // top-down, such that the result is identical to the position used in traversals
+    locate(parent_idx, position, size);
+    size /= 2;
+    position += child_offset(child_id(idx), size);
+}
+
+CubePool::CubePool(const float size, const glm::vec3 &position) : m_size(size), m_position(position) {
+    m_bits.push_back(static_cast<std::uint8_t>(Cube::Type::SOLID));
+    m_parents.push_back(INVALID_INDEX);
+    m_data.push_back(INVALID_INDEX);
+    m_geometry_counts.push_back(1);
+    mark_dirty(ROOT_INDEX);
+    m_data.writable(ROOT_INDEX) = allocate_payload();
+}
+
+float CubePool::root_size() const noexcept {
+    return m_size;
+}
+
+const glm::vec3 &CubePool::root_position() const noexcept {
+    return m_position;
+}
+
+std::size_t CubePool::capacity() const noexcept {
+    return m_bits.size();
+}
+
+std::size_t CubePool::memory_usage() const noexcept {
+    return capacity() * NODE_BYTES + m_indentations.size() * PAYLOAD_BYTES;
+}
+
+void CubePool::set_root_bounds(const float size, const glm::vec3 &position) {
+    m_size = size;
+    m_position = position;
+    invalidate_subtree(ROOT_INDEX);
+    m_structure_version++;
+}
+
+Cube::Type CubePool::type(const Index idx) const noexcept {
+    return static_cast<Cube::Type>(m_bits[idx] & TYPE_MASK);
+}
+
+CubePool::Index CubePool::parent(const Index idx) const noexcept {
+    return m_parents[idx];
+}
+
+CubePool::Index CubePool::child(const Index idx, const std::size_t child_id) const noexcept {
+    assert(type(idx) == Cube::Type::OCTANT);
+    assert(child_id < Cube::SUB_CUBES);
+    return m_data[idx] + static_cast<Index>(child_id);
+}
+
+std::size_t CubePool::child_id(const Index idx) const noexcept {
+    const Index parent_idx = m_parents[idx];
+    if (parent_idx == INVALID_INDEX) {
+        return 0;
+    }
+    return idx - m_data[parent_idx];
+}
+
+std::size_t CubePool::grid_level(const Index idx) const noexcept {
+    std::size_t level = 0;
+    for (Index parent_idx = m_parents[idx]; parent_idx != INVALID_INDEX; parent_idx = m_parents[parent_idx]) {
+        level++;
+    }
+    return level;
+}
+
+float CubePool::size(const Index idx) const noexcept {
+    return std::ldexp(m_size, -static_cast<int>(grid_level(idx)));
+}
+
+glm::vec3 CubePool::position(const Index idx) const noexcept {
+    glm::vec3 position = m_position;
+    float size = m_size;
+    locate(idx, position, size);
+    return position;
+}
+
+std::optional<MortonCode> CubePool::morton_code(Index idx) const noexcept {
+    MortonCode path = 0;
+    std::size_t level = 0;
+    for (; m_parents[idx] != INVALID_INDEX; idx = m_parents[idx], level++) {
+        if (level == MAX_MORTON_LEVEL) {
+            return std::nullopt;
+        }
+        path |= MortonCode{child_id(idx)} << (3 * level);
+    }
+    return (MortonCode{1} << (3 * level)) | path;
+}
+
+std::optional<MortonCode> CubePool::morton_code(const glm::vec3 &position, const std::size_t level) const noexcept {
+    if (level > MAX_MORTON_LEVEL) {
+        return std::nullopt;
+    }
+    const auto resolution = static_cast<float>(std::uint32_t{1} << level);
+    glm::uvec3 cell;
+    for (int axis = 0; axis < 3; axis++) {
+        const float coordinate = (position[axis] - m_position[axis]) / m_size * resolution;
+        if (!(coordinate >= 0.0F && coordinate <= resolution)) {
+            return std::nullopt;
+        }
+        // the upper bounds belong to the last cell
+        cell[axis] = std::min(static_cast<std::uint32_t>(coordinate), (std::uint32_t{1} << level) - 1);
+    }
+    return world::morton_code(cell, level);
+}
+
+glm::vec3 CubePool::morton_position(const MortonCode code) const noexcept {
+    const glm::uvec3 cell = morton_cell(code);
+    const float cell_size = morton_size(code);
+    return m_position + glm::vec3(static_cast<float>(cell.x) * cell_size, static_cast<float>(cell.y) * cell_size,
+                                  static_cast<float>(cell.z) * cell_size);
+}
+
+float CubePool::morton_size(const MortonCode code) const noexcept {
+    return std::ldexp(m_size, -static_cast<int>(morton_level(code)));
+}
+
+CubePool::Index CubePool::find(const MortonCode code) const noexcept {
+    Index idx = ROOT_INDEX;
+    for (std::size_t level = morton_level(code); level > 0 && type(idx) == Cube::Type::OCTANT; level--) {
+        idx = child(idx, (code >> (3 * (level - 1))) & 0b111U);
+    }
+    return idx;
+}
+
+CubePool::Index CubePool::cube_at(const glm::vec3 &position, const std::size_t max_level) const noexcept {
+    const std::optional<MortonCode> code = morton_code(position, std::min(max_level, MAX_MORTON_LEVEL));
+    return code ? find(*code) : INVALID_INDEX;
+}
+
+std::uint64_t CubePool::structure_version() const noexcept {
+    return m_structure_version;
+}
+
+glm::vec3 CubePool::child_offset(const std::size_t child_id, const float child_size) noexcept {
+    // about the order look into the octree documentation
+    return {(child_id & 0b100U) != 0 ? child_size : 0.0F, (child_id & 0b010U) != 0 ? child_size : 0.0F,
+            (child_id & 0b001U) != 0 ? child_size : 0.0F};
+}
+
+std::size_t CubePool::opposite_face(const std::size_t face) noexcept {
+    return face ^ 1U;
+}
+
+bool CubePool::child_on_face(const std::size_t child_id, const std::size_t face) noexcept {
+    // x is the highest bit of the child id, see child_offset
+    const std::size_t axis_bit = 0b100U >> (face / 2);
+    return ((child_id & axis_bit) != 0) == ((face & 1U) != 0);
+}
+
+bool CubePool::face_on_bounds(const Cube::Type type, const std::array<Indentation, Cube::EDGES> &ind,
+                              const std::size_t face) noexcept {
+    if (type != Cube::Type::NORMAL) {
+        return type == Cube::Type::SOLID;
+    }
+    // the indentations along the face normal of the four corners of the face, see vertices()
+    switch (face) {
+    case 0:
+        return ind[0].start() == 0 && ind[9].start() == 0 && ind[3].start() == 0 && ind[6].start() == 0;
+    case 1:
+        return ind[0].end() == 0 && ind[9].end() == 0 && ind[3].end() == 0 && ind[6].end() == 0;
+    case 2:
+        return ind[1].start() == 0 && ind[4].start() == 0 && ind[10].start() == 0 && ind[7].start() == 0;
+    case 3:
+        return ind[1].end() == 0 && ind[4].end() == 0 && ind[10].end() == 0 && ind[7].end() == 0;
+    case 4:
+        return ind[2].start() == 0 && ind[11].start() == 0 && ind[5].start() == 0 && ind[8].start() == 0;
+    case 5:
+        return ind[2].end() == 0 && ind[11].end() == 0 && ind[5].end() == 0 && ind[8].end() == 0;
+    default:
+        return false;
+    }
+}
+
+CubePool::Index CubePool::neighbor(const Index idx, const std::size_t face) const noexcept {
+    const Index parent_idx = m_parents[idx];
+    if (parent_idx == INVALID_INDEX) {
+        return INVALID_INDEX;
+    }
+    const std::size_t axis_bit = 0b100U >> (face / 2);
+    const std::size_t id = child_id(idx);
+    // The neighbor is a sibling, if the cube is not on this face of its parent.
+    if (!child_on_face(id, face)) {
+        return m_data[parent_idx] + static_cast<Index>(id ^ axis_bit);
+    }
+    const Index parent_neighbor = neighbor(parent_idx, face);
+    if (parent_neighbor == INVALID_INDEX || type(parent_neighbor) != Cube::Type::OCTANT) {
+        return parent_neighbor;
+    }
+    // mirror the position within the neighbor of the parent
+    return m_data[parent_neighbor] + static_cast<Index>(id ^ axis_bit);
+}
+
+bool CubePool::face_solid(const Index idx, const std::size_t face) const noexcept {
+    const Cube::Type cube_type = type(idx);
+    if (cube_type != Cube::Type::OCTANT) {
+        return cube_type == Cube::Type::SOLID;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        if (child_on_face(child_id, face) && !face_solid(m_data[idx] + static_cast<Index>(child_id), face)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CubePool::face_hidden(const Index idx, const std::size_t face) const noexcept {
+    const Cube::Type cube_type = type(idx);
+    if (!is_geometry(cube_type) || !face_on_bounds(cube_type, m_indentations[m_data[idx]], face)) {
+        return false;
+    }
+    const Index neighbor_idx = neighbor(idx, face);
+    return neighbor_idx != INVALID_INDEX && face_solid(neighbor_idx, opposite_face(face));
+}
+
+std::size_t CubePool::count_geometry_cubes(const Index idx) const noexcept {
+    return m_geometry_counts[idx];
+}
+
+bool CubePool::dirty(const Index idx) const noexcept {
+    return (m_bits[idx] & DIRTY_BIT) != 0;
+}
+
+void CubePool::clear_dirty(const Index idx) {
+    // the positions are not needed
+    visit_pre_order(*this, idx, m_position, m_size, [&](const TraversalNode &node) {
+        if (!dirty(node.index)) {
+            return false;
+        }
+        m_bits.writable(node.index) &= static_cast<std::uint8_t>(~DIRTY_BIT);
+        return true;
+    });
+}
+
+std::uint32_t CubePool::change_type(const Index idx, const Cube::Type new_type) {
+    const Cube::Type old_type = type(idx);
+    if (old_type == new_type) {
+        return 0;
+    }
+    if (old_type == Cube::Type::OCTANT) {
+        free_block(m_data[idx]);
+        m_data.writable(idx) = INVALID_INDEX;
+    } else if (is_geometry(old_type) && !is_geometry(new_type)) {
+        free_payload(m_data[idx]);
+        m_data.writable(idx) = INVALID_INDEX;
+    }
+    switch (new_type) {
+    case Cube::Type::EMPTY:
+        break;
+    case Cube::Type::SOLID:
+    case Cube::Type::NORMAL:
+        if (!is_geometry(old_type)) {
+            m_data.writable(idx) = allocate_payload();
+        }
+        if (new_type == Cube::Type::NORMAL) {
+            m_indentations.writable(m_data[idx]) = {};
+        }
+        break;
+    case Cube::Type::OCTANT:
+        const Index first_child = allocate_block(idx);
+        m_data.writable(idx) = first_child;
+        break;
+    }
+    if (old_type == Cube::Type::OCTANT || new_type == Cube::Type::OCTANT) {
+        m_structure_version++;
+    }
+    // also resets the polygon cache flag and the dirty flag
+    set_bits(idx, new_type);
+
+    const std::uint32_t old_count = m_geometry_counts[idx];
+    m_geometry_counts.writable(idx) =
+        new_type == Cube::Type::OCTANT ? Cube::SUB_CUBES : (is_geometry(new_type) ? 1 : 0);
+    // unsigned overflow results in the correct difference
+    return m_geometry_counts[idx] - old_count;
+}
+
+void CubePool::set_type(const Index idx, const Cube::Type new_type) {
+    if (type(idx) == new_type) {
+        return;
+    }
+    const std::array<FaceCoverage, FACES> old_coverages = face_coverages(idx);
+    const std::uint32_t difference = change_type(idx, new_type);
+    mark_dirty(idx);
+    mark_neighbors_dirty(idx, old_coverages);
+    for (Index parent_idx = m_parents[idx]; parent_idx != INVALID_INDEX; parent_idx = m_parents[parent_idx]) {
+        m_geometry_counts.writable(parent_idx) += difference;
+    }
+
+    if (m_auto_compact && m_parents[idx] != INVALID_INDEX) {
+        // merging calls set_type() on the parent, which continues with the next parent
+        if (const auto uniform_type = uniform_children(m_parents[idx])) {
+            merge_octant(m_parents[idx], *uniform_type);
+        }
+    }
+}
+
+const std::array<Indentation, Cube::EDGES> &CubePool::indentations(const Index idx) const noexcept {
+    assert(is_geometry(type(idx)));
+    return m_indentations[m_data[idx]];
+}
+
+void CubePool::set_indentations(const Index idx, const std::array<Indentation, Cube::EDGES> &indentations) {
+    if (type(idx) != Cube::Type::NORMAL) {
+        return;
+    }
+    m_indentations.writable(m_data[idx]) = indentations;
+    invalidate_polygon_cache(idx);
+    mark_dirty(idx);
+}
+
+void CubePool::set_indent(const Index idx, const std::uint8_t edge_id, const Indentation indentation) {
+    if (type(idx) != Cube::Type::NORMAL) {
+        return;
+    }
+    assert(edge_id < Cube::EDGES);
+    m_indentations.writable(m_data[idx])[edge_id] = indentation;
+    invalidate_polygon_cache(idx);
+    mark_dirty(idx);
+}
+
+void CubePool::indent(const Index idx, const std::uint8_t edge_id, const bool positive_direction,
+                      const std::uint8_t steps) {
+    if (type(idx) != Cube::Type::NORMAL) {
+        return;
+    }
+    assert(edge_id < Cube::EDGES);
+    if (positive_direction) {
+        m_indentations.writable(m_data[idx])[edge_id].indent_start(steps);
+    } else {
+        m_indentations.writable(m_data[idx])[edge_id].indent_end(steps);
+    }
+    invalidate_polygon_cache(idx);
+    mark_dirty(idx);
+}
+
+void CubePool::rotate(const Index idx, const Cube::RotationAxis::Type &axis, int rotations) {
+    rotations = ((rotations % 4) + 4) % 4;
+    if (rotations == 0 || type(idx) == Cube::Type::EMPTY || type(idx) == Cube::Type::SOLID) {
+        return;
+    }
+    const std::array<FaceCoverage, FACES> old_coverages = face_coverages(idx);
+    switch (rotations) {
+    case 1:
+        rotate<1>(idx, axis);
+        break;
+    case 2:
+        rotate<2>(idx, axis);
+        break;
+    case 3:
+        rotate<3>(idx, axis);
+        break;
+    }
+    // The children have been moved, therefore their positions have changed.
+    if (type(idx) == Cube::Type::OCTANT) {
+        m_structure_version++;
+    }
+    invalidate_subtree(idx);
+    mark_dirty(idx);
+    mark_neighbors_dirty(idx, old_coverages);
+}
+
+std::array<glm::vec3, 8> CubePool::vertices(const Cube::Type type, const glm::vec3 &position, const float size,
+                                            const std::array<Indentation, Cube::EDGES> &ind) noexcept {
+    assert(is_geometry(type));
+
+    const glm::vec3 pos = position;
+    const glm::vec3 max = {position.x + size, position.y + size, position.z + size};
+
+    if (type == Cube::Type::SOLID) {
+        return {{{pos.x, pos.y, pos.z},
+                 {pos.x, pos.y, max.z},
+                 {pos.x, max.y, pos.z},
+                 {pos.x, max.y, max.z},
+                 {max.x, pos.y, pos.z},
+                 {max.x, pos.y, max.z},
+                 {max.x, max.y, pos.z},
+                 {max.x, max.y, max.z}}};
+    }
+    if (type == Cube::Type::NORMAL) {
+        const float step = size / Indentation::MAX;
+
+        return {{{pos.x + ind[0].start() * step, pos.y + ind[1].start() * step, pos.z + ind[2].start() * step},
+                 {pos.x + ind[9].start() * step, pos.y + ind[4].start() * step, max.z - ind[2].end() * step},
+                 {pos.x + ind[3].start() * step, max.y - ind[1].end() * step, pos.z + ind[11].start() * step},
+                 {pos.x + ind[6].start() * step, max.y - ind[4].end() * step, max.z - ind[11].end() * step},
+                 {max.x - ind[0].end() * step, pos.y + ind[10].start() * step, pos.z + ind[5].start() * step},
+                 {max.x - ind[9].end() * step, pos.y + ind[7].start() * step, max.z - ind[5].end() * step},
+                 {max.x - ind[3].end() * step, max.y - ind[10].end() * step, pos.z + ind[8].start() * step},
+                 {max.x - ind[6].end() * step, max.y - ind[7].end() * step, max.z - ind[8].end() * step}}};
+    }
+    return {};
+}
+
+CubePolygons CubePool::build_polygons(const Cube::Type type, const glm::vec3 &position, const float size,
+                                      const std::array<Indentation, Cube::EDGES> &ind) {
+    const std::array<glm::vec3, 8> v = vertices(type, position, size, ind);
+    CubePolygons polygons{{
+        {{v[0], v[2], v[1]}}, // x = 0
+        {{v[1], v[2], v[3]}}, // x = 0
+        {{v[4], v[5], v[6]}}, // x = 1
+        {{v[5], v[7], v[6]}}, // x = 1
+        {{v[0], v[1], v[4]}}, // y = 0
+        {{v[1], v[5], v[4]}}, // y = 0
+        {{v[2], v[6], v[3]}}, // y = 1
+        {{v[3], v[6], v[7]}}, // y = 1
+        {{v[0], v[4], v[2]}}, // z = 0
+        {{v[2], v[4], v[6]}}, // z = 0
+        {{v[1], v[3], v[5]}}, // z = 1
+        {{v[3], v[7], v[5]}}  // z = 1
+    }};
+    if (type != Cube::Type::NORMAL) {
+        return polygons;
+    }
+
+    // Check for each side if the side is convex, rotate the hypotenuse (middle diagonal edge) so it becomes convex!
+    // x = 0
+    if (ind[0].start() + ind[6].start() < ind[9].start() + ind[3].start()) {
+        polygons[0] = {{v[0], v[2], v[3]}};
+        polygons[1] = {{v[0], v[3], v[1]}};
+    }
+    // x = 1
+    if (ind[0].end() + ind[6].end() < ind[9].end() + ind[3].end()) {
+        polygons[2] = {{v[4], v[7], v[6]}};
+        polygons[3] = {{v[4], v[5], v[7]}};
+    }
+    // y = 0
+    if (ind[1].start() + ind[7].start() < ind[4].start() + ind[10].start()) {
+        polygons[4] = {{v[0], v[1], v[5]}};
+        polygons[5] = {{v[0], v[5], v[4]}};
+    }
+    // y = 1
+    if (ind[1].end() + ind[7].end() < ind[4].end() + ind[10].end()) {
+        polygons[6] = {{v[2], v[7], v[3]}};
+        polygons[7] = {{v[2], v[6], v[7]}};
+    }
+    // z = 0
+    if (ind[2].start() + ind[8].start() < ind[11].start() + ind[5].start()) {
+        polygons[8] = {{v[0], v[4], v[6]}};
+        polygons[9] = {{v[0], v[6], v[2]}};
+    }
+    // z = 1
+    if (ind[2].end() + ind[8].end() < ind[11].end() + ind[5].end()) {
+        polygons[10] = {{v[1], v[3], v[7]}};
+        polygons[11] = {{v[1], v[7], v[5]}};
+    }
+    return polygons;
+}
+
+std::array<Polygon, 2> CubePool::box_face_polygons(const glm::vec3 &min, const glm::vec3 &max,
+                                                   const std::size_t face) noexcept {
+    assert(face < FACES);
+    // vertex ids of the polygons of each face, see build_polygons
+    constexpr std::array<std::array<std::size_t, 6>, FACES> face_vertices{{{0, 2, 1, 1, 2, 3},
+                                                                           {4, 5, 6, 5, 7, 6},
+                                                                           {0, 1, 4, 1, 5, 4},
+                                                                           {2, 6, 3, 3, 6, 7},
+                                                                           {0, 4, 2, 2, 4, 6},
+                                                                           {1, 3, 5, 3, 7, 5}}};
+    const auto vertex = [&](const std::size_t id) {
+        return glm::vec3((id & 0b100U) != 0 ? max.x : min.x, (id & 0b010U) != 0 ? max.y : min.y,
+                         (id & 0b001U) != 0 ? max.z : min.z);
+    };
+    const std::array<std::size_t, 6> &ids = face_vertices[face];
+    return {{{{vertex(ids[0]), vertex(ids[1]), vertex(ids[2])}}, {{vertex(ids[3]), vertex(ids[4]), vertex(ids[5])}}}};
+}
+
+void CubePool::update_polygon_cache(const Index idx) const {
+    const Cube::Type cube_type = type(idx);
+    if (is_geometry(cube_type)) {
+        const Index payload = m_data[idx];
+        m_polygon_caches.writable(payload) =
+            build_polygons(cube_type, position(idx), size(idx), m_indentations[payload]);
+    }
+    m_bits.writable(idx) |= POLYGON_CACHE_VALID_BIT;
+}
+
+void CubePool::invalidate_polygon_cache(const Index idx) const {
+    m_bits.writable(idx) &= static_cast<std::uint8_t>(~POLYGON_CACHE_VALID_BIT);
+}
+
+void CubePool::set_polygon_cache(const Index idx, const CubePolygons &polygons) const {
+    assert(is_geometry(type(idx)));
+    m_polygon_caches.writable(m_data[idx]) = polygons;
+    m_bits.writable(idx) |= POLYGON_CACHE_VALID_BIT;
+}
+
+bool CubePool::polygon_cache_valid(const Index idx) const noexcept {
+    return (m_bits[idx] & POLYGON_CACHE_VALID_BIT) != 0;
+}
+
+PolygonSpan CubePool::polygon_cache(const Index idx) const noexcept {
+    if (!is_geometry(type(idx)) || !polygon_cache_valid(idx)) {
+        return {};
+    }
+    const CubePolygons &polygons = m_polygon_caches[m_data[idx]];
+    return {polygons.data(), polygons.size()};
+}
+
+PolygonSpan CubePool::polygon_cache(const Index idx, const glm::vec3 &position, const float size) const {
+    const Cube::Type cube_type = type(idx);
+    if (is_geometry(cube_type) && !polygon_cache_valid(idx)) {
+        const Index payload = m_data[idx];
+        m_polygon_caches.writable(payload) = build_polygons(cube_type, position, size, m_indentations[payload]);
+        m_bits.writable(idx) |= POLYGON_CACHE_VALID_BIT;
+    }
+    return polygon_cache(idx);
+}
+
+std::vector<PolygonSpan> CubePool::polygons(const Index idx, const bool update_invalid) const {
+    std::vector<PolygonSpan> polygons;
+    polygons.reserve(count_geometry_cubes(idx));
+    for (const TraversalNode &node : pre_order(*this, idx)) {
+        if (!is_geometry(type(node.index))) {
+            continue;
+        }
+        const PolygonSpan cache =
+            update_invalid ? polygon_cache(node.index, node.position, node.size) : polygon_cache(node.index);
+        if (!cache.empty()) {
+            polygons.push_back(cache);
+        }
+    }
+    return polygons;
+}
+
+std::size_t CubePool::compact(const Index idx) {
+    const std::size_t reclaimed_bytes = m_reclaimed_bytes;
+    if (type(idx) == Cube::Type::OCTANT) {
+        // With auto compaction merging a child can merge this octant and its parents too, the freed children are
+        // Type::EMPTY and are skipped.
+        const Index first_child = m_data[idx];
+        for (Index child = first_child; child < first_child + Cube::SUB_CUBES; child++) {
+            (void)compact(child);
+        }
+        if (const auto uniform_type = uniform_children(idx)) {
+            merge_octant(idx, *uniform_type);
+        }
+    }
+    return m_reclaimed_bytes - reclaimed_bytes;
+}
+
+void CubePool::set_auto_compact(const bool auto_compact) noexcept {
+    m_auto_compact = auto_compact;
+}
+
+bool CubePool::auto_compact() const noexcept {
+    return m_auto_compact;
+}
+
+std::size_t CubePool::reclaimed_bytes() const noexcept {
+    return m_reclaimed_bytes;
+}
+
+std::shared_ptr<CubePool> CubePool::clone(const Index idx) const {
+    if (idx == ROOT_INDEX) {
+        return std::make_shared<CubePool>(*this);
+    }
+    auto pool = std::make_shared<CubePool>(size(idx), position(idx));
+    pool->copy_subtree(*this, idx, ROOT_INDEX);
+    return pool;
+}
+} // namespace inexor::vulkan_renderer::world
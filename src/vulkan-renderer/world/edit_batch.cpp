@@ -0,0 +1,298 @@
+#include "inexor/vulkan-renderer/world/edit_batch.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// The code shifted to the deepest level, parents are not greater than their children.
+MortonCode pre_order_key(const MortonCode code, const std::size_t level) noexcept {
+    return code << (3 * (MAX_MORTON_LEVEL - level));
+}
+
+bool contains(const MortonCode code, const std::size_t level, const MortonCode other, const std::size_t other_level) {
+    return other_level >= level && other >> (3 * (other_level - level)) == code;
+}
+
+/// Find the cube at the code.
+/// @return INVALID_INDEX if the cube does not exist.
+CubePool::Index find_cube(const CubePool &pool, const MortonCode code, const std::size_t level) noexcept {
+    CubePool::Index idx = CubePool::ROOT_INDEX;
+    for (std::size_t current = 1; current <= level; current++) {
+        if (pool.type(idx) != Cube::Type::OCTANT) {
+            return CubePool::INVALID_INDEX;
+        }
+        idx = pool.child(idx, (code >> (3 * (level - current))) & 0b111U);
+    }
+    return idx;
+}
+
+} // namespace
+
+EditBatch::EditBatch(Cube root, const std::size_t thread_count)
+    : EditBatch(std::move(root), std::make_shared<WorkerPool>(thread_count)) {}
+
+EditBatch::EditBatch(Cube root, std::shared_ptr<WorkerPool> workers)
+    : m_root(std::move(root)), m_workers(std::move(workers)) {
+    assert(m_root.is_root());
+}
+
+EditBatch::Edit &EditBatch::add(const MortonCode code, const Operation operation) {
+    assert(m_edits.size() < std::numeric_limits<std::uint32_t>::max());
+    Edit &edit = m_edits.emplace_back();
+    edit.code = code;
+    edit.level = static_cast<std::uint8_t>(morton_level(code));
+    edit.sequence = static_cast<std::uint32_t>(m_edits.size() - 1);
+    edit.operation = operation;
+    return edit;
+}
+
+void EditBatch::subdivide(CubePool &pool, std::vector<PathNode> &path) {
+    PathNode &node = path.back();
+    const Cube::Type type = pool.type(node.index);
+    assert(type != Cube::Type::OCTANT);
+    std::uint32_t difference = pool.change_type(node.index, Cube::Type::OCTANT);
+    pool.mark_dirty(node.index);
+    // the new children are solid
+    if (type != Cube::Type::SOLID) {
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            const CubePool::Index child = pool.child(node.index, child_id);
+            const std::uint32_t child_difference = pool.change_type(child, type);
+            pool.mark_dirty(child);
+            pool.m_geometry_counts.writable(node.index) += child_difference;
+            difference += child_difference;
+        }
+    }
+    if (path.size() > 1) {
+        path[path.size() - 2].count_difference += difference;
+    }
+    node.edited = true;
+    // the children may be merged again after the edits below them
+    node.child_type_changed = true;
+}
+
+void EditBatch::pop(CubePool &pool, std::vector<PathNode> &path, const bool compact) {
+    const PathNode node = path.back();
+    path.pop_back();
+    if (node.count_difference != 0) {
+        pool.m_geometry_counts.writable(node.index) += node.count_difference;
+    }
+    if (!path.empty()) {
+        path.back().count_difference += node.count_difference;
+    }
+    if (compact && node.child_type_changed) {
+        if (const auto uniform_type = pool.uniform_children(node.index)) {
+            // updates the geometry counts of all parents by itself
+            pool.merge_octant(node.index, *uniform_type);
+            if (!path.empty()) {
+                path.back().child_type_changed = true;
+            }
+        }
+    }
+}
+
+void EditBatch::set_type(const MortonCode code, const Cube::Type new_type) {
+    add(code, Operation::SET_TYPE).type = new_type;
+}
+
+bool EditBatch::set_type(const Cube &cube, const Cube::Type new_type) {
+    assert(cube.pool() == m_root.pool());
+    const std::optional<MortonCode> code = cube.morton_code();
+    if (!code) {
+        return false;
+    }
+    set_type(*code, new_type);
+    return true;
+}
+
+void EditBatch::set_indentations(const MortonCode code, const std::array<Indentation, Cube::EDGES> &indentations) {
+    add(code, Operation::SET_INDENTATIONS).indentations = indentations;
+}
+
+bool EditBatch::set_indentations(const Cube &cube, const std::array<Indentation, Cube::EDGES> &indentations) {
+    assert(cube.pool() == m_root.pool());
+    const std::optional<MortonCode> code = cube.morton_code();
+    if (!code) {
+        return false;
+    }
+    set_indentations(*code, indentations);
+    return true;
+}
+
+void EditBatch::set_indent(const MortonCode code, const std::uint8_t edge_id, const Indentation indentation) {
+    assert(edge_id < Cube::EDGES);
+    Edit &edit = add(code, Operation::SET_INDENT);
+    edit.edge_id = edge_id;
+    edit.indentations[0] = indentation;
+}
+
+bool EditBatch::set_indent(const Cube &cube, const std::uint8_t edge_id, const Indentation indentation) {
+    assert(cube.pool() == m_root.pool());
+    const std::optional<MortonCode> code = cube.morton_code();
+    if (!code) {
+        return false;
+    }
+    set_indent(*code, edge_id, indentation);
+    return true;
+}
+
+void EditBatch::indent(const MortonCode code, const std::uint8_t edge_id, const bool positive_direction,
+                       const std::uint8_t steps) {
+    assert(edge_id < Cube::EDGES);
+    Edit &edit = add(code, Operation::INDENT);
+    edit.edge_id = edge_id;
+    edit.positive_direction = positive_direction;
+    edit.steps = steps;
+}
+
+bool EditBatch::indent(const Cube &cube, const std::uint8_t edge_id, const bool positive_direction,
+                       const std::uint8_t steps) {
+    assert(cube.pool() == m_root.pool());
+    const std::optional<MortonCode> code = cube.morton_code();
+    if (!code) {
+        return false;
+    }
+    indent(*code, edge_id, positive_direction, steps);
+    return true;
+}
+
+std::size_t EditBatch::size() const noexcept {
+    return m_edits.size();
+}
+
+bool EditBatch::empty() const noexcept {
+    return m_edits.empty();
+}
+
+void EditBatch::clear() noexcept {
+    m_edits.clear();
+}
+
+void EditBatch::apply() {
+    CubePool &pool = *m_root.pool();
+    // parents first, the edits of a cube in the order of the calls
+    std::sort(m_edits.begin(), m_edits.end(), [](const Edit &lhs, const Edit &rhs) {
+        return std::make_tuple(pre_order_key(lhs.code, lhs.level), lhs.level, lhs.sequence) <
+               std::make_tuple(pre_order_key(rhs.code, rhs.level), rhs.level, rhs.sequence);
+    });
+    // the first edit of every edited cube
+    std::vector<std::size_t> groups;
+    for (std::size_t i = 0; i < m_edits.size(); i++) {
+        if (i == 0 || m_edits[i].code != m_edits[i - 1].code) {
+            groups.push_back(i);
+        }
+    }
+    groups.push_back(m_edits.size());
+    const std::size_t group_count = groups.size() - 1;
+
+    // The face coverages before the batch of the cubes which get a new type. They are only valid as long as the parents
+    // of the cube have not been edited, which is true for most cubes of a brush stroke.
+    std::vector<std::optional<std::array<CubePool::FaceCoverage, CubePool::FACES>>> old_coverages(group_count);
+    m_workers->parallel_for(group_count, [&](const std::size_t group) {
+        const auto first = m_edits.begin() + static_cast<std::ptrdiff_t>(groups[group]);
+        const auto last = m_edits.begin() + static_cast<std::ptrdiff_t>(groups[group + 1]);
+        if (std::none_of(first, last, [](const Edit &edit) { return edit.operation == Operation::SET_TYPE; })) {
+            return;
+        }
+        if (const CubePool::Index idx = find_cube(pool, first->code, first->level); idx != CubePool::INVALID_INDEX) {
+            old_coverages[group] = pool.face_coverages(idx);
+        }
+    });
+
+    const bool compact = pool.auto_compact();
+    pool.set_auto_compact(false);
+    std::vector<PathNode> path{{MortonCode{1}, CubePool::ROOT_INDEX}};
+    for (std::size_t group = 0; group < group_count; group++) {
+        const auto first = m_edits.begin() + static_cast<std::ptrdiff_t>(groups[group]);
+        const auto last = m_edits.begin() + static_cast<std::ptrdiff_t>(groups[group + 1]);
+        const MortonCode code = first->code;
+        const std::size_t level = first->level;
+        // leave the cubes which do not contain this one
+        while (!contains(path.back().code, path.size() - 1, code, level)) {
+            pop(pool, path, compact);
+        }
+        // skip the edits which were overwritten by a new type of a parent
+        const std::uint32_t overwritten = path.back().overwritten;
+        const auto first_applied =
+            std::find_if(first, last, [&](const Edit &edit) { return edit.sequence >= overwritten; });
+        if (first_applied == last) {
+            continue;
+        }
+
+        while (path.size() - 1 < level) {
+            if (pool.type(path.back().index) != Cube::Type::OCTANT) {
+                subdivide(pool, path);
+            }
+            const PathNode &parent = path.back();
+            const std::size_t child_id = (code >> (3 * (level - path.size()))) & 0b111U;
+            path.push_back({morton_child(parent.code, child_id), pool.child(parent.index, child_id), 0,
+                            parent.overwritten, parent.edited});
+        }
+
+        PathNode &node = path.back();
+        const bool sets_type =
+            std::any_of(first_applied, last, [](const Edit &edit) { return edit.operation == Operation::SET_TYPE; });
+        std::array<CubePool::FaceCoverage, CubePool::FACES> coverages{};
+        if (sets_type) {
+            coverages = !node.edited && old_coverages[group] ? *old_coverages[group] : pool.face_coverages(node.index);
+        }
+        // the edits of the cubes below this one follow in pre-order
+        auto subtree_last = last;
+        while (subtree_last != m_edits.end() && contains(code, level, subtree_last->code, subtree_last->level)) {
+            ++subtree_last;
+        }
+        bool type_changed = false;
+        for (auto edit = first_applied; edit != last; ++edit) {
+            // Children which were edited before this edit and after the last new type have already subdivided the cube.
+            if (pool.type(node.index) != Cube::Type::OCTANT && std::any_of(last, subtree_last, [&](const Edit &other) {
+                    return other.sequence >= node.overwritten && other.sequence < edit->sequence;
+                })) {
+                subdivide(pool, path);
+            }
+            switch (edit->operation) {
+            case Operation::SET_TYPE:
+                if (edit->type != Cube::Type::OCTANT) {
+                    node.overwritten = edit->sequence;
+                }
+                if (edit->type == pool.type(node.index)) {
+                    break;
+                }
+                type_changed = true;
+                if (const std::uint32_t difference = pool.change_type(node.index, edit->type); path.size() > 1) {
+                    path[path.size() - 2].count_difference += difference;
+                }
+                break;
+            case Operation::SET_INDENTATIONS:
+                pool.set_indentations(node.index, edit->indentations);
+                break;
+            case Operation::SET_INDENT:
+                pool.set_indent(node.index, edit->edge_id, edit->indentations[0]);
+                break;
+            case Operation::INDENT:
+                pool.indent(node.index, edit->edge_id, edit->positive_direction, edit->steps);
+                break;
+            }
+        }
+        pool.mark_dirty(node.index);
+        node.edited = true;
+        if (type_changed) {
+            pool.mark_neighbors_dirty(node.index, coverages);
+            if (path.size() > 1) {
+                path[path.size() - 2].child_type_changed = true;
+            }
+        }
+    }
+    while (!path.empty()) {
+        pop(pool, path, compact);
+    }
+    pool.set_auto_compact(compact);
+    m_edits.clear();
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,319 @@
+#include "inexor/vulkan-renderer/world/edit_journal.hpp"
+
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <array>
+#include <cassert>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Operation and Morton code.
+constexpr std::size_t HEADER_BYTES{1 + sizeof(MortonCode)};
+const std::array<const Cube::RotationAxis::Type *, 3> ROTATION_AXES{&Cube::RotationAxis::X, &Cube::RotationAxis::Y,
+                                                                    &Cube::RotationAxis::Z};
+
+/// Temporarily disable auto compaction, so restoring a state does not merge the cubes which are restored.
+class AutoCompactGuard {
+    CubePool &m_pool;
+    bool m_auto_compact;
+
+public:
+    explicit AutoCompactGuard(CubePool &pool) : m_pool(pool), m_auto_compact(pool.auto_compact()) {
+        m_pool.set_auto_compact(false);
+    }
+    AutoCompactGuard(const AutoCompactGuard &) = delete;
+    AutoCompactGuard &operator=(const AutoCompactGuard &) = delete;
+    ~AutoCompactGuard() {
+        m_pool.set_auto_compact(m_auto_compact);
+    }
+};
+
+} // namespace
+
+EditJournal::EditJournal(Cube root, const std::size_t memory_budget)
+    : m_root(std::move(root)), m_memory_budget(memory_budget) {
+    assert(m_root.is_root());
+}
+
+CubePool &EditJournal::pool() const noexcept {
+    return *m_root.pool();
+}
+
+CubePool::Index EditJournal::resolve(const MortonCode code) const {
+    CubePool &pool = this->pool();
+    const AutoCompactGuard guard(pool);
+    const std::size_t level = morton_level(code);
+    CubePool::Index idx = CubePool::ROOT_INDEX;
+    for (std::size_t current = 1; current <= level; current++) {
+        if (const Cube::Type type = pool.type(idx); type != Cube::Type::OCTANT) {
+            // the new children are solid
+            pool.set_type(idx, Cube::Type::OCTANT);
+            if (type != Cube::Type::SOLID) {
+                for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+                    pool.set_type(pool.child(idx, child_id), type);
+                }
+            }
+        }
+        idx = pool.child(idx, (code >> (3 * (level - current))) & 0b111U);
+    }
+    return idx;
+}
+
+std::size_t EditJournal::subtree_bytes(const CubePool::Index idx) const {
+    const CubePool &pool = this->pool();
+    std::size_t bytes = 0;
+    for (const TraversalNode &node : pre_order(pool, idx)) {
+        bytes += pool.type(node.index) == Cube::Type::NORMAL ? 1 + PACKED_INDENTATIONS_BYTES : 1;
+    }
+    return bytes;
+}
+
+void EditJournal::write_subtree(const CubePool::Index idx, std::deque<std::uint8_t>::iterator &out) const {
+    const CubePool &pool = this->pool();
+    for (const TraversalNode &node : pre_order(pool, idx)) {
+        const Cube::Type type = pool.type(node.index);
+        *out++ = static_cast<std::uint8_t>(type);
+        if (type != Cube::Type::NORMAL) {
+            continue;
+        }
+        out = pack_indentations(pool.indentations(node.index), out);
+    }
+}
+
+void EditJournal::read_subtree(const CubePool::Index idx, std::deque<std::uint8_t>::const_iterator &in) const {
+    CubePool &pool = this->pool();
+    // the iterator visits the children of a cube after it became an octant
+    for (const TraversalNode &node : pre_order(pool, idx)) {
+        const auto type = static_cast<Cube::Type>(*in++);
+        pool.set_type(node.index, type);
+        if (type != Cube::Type::NORMAL) {
+            continue;
+        }
+        std::array<std::uint8_t, Cube::EDGES> uids;
+        in = unpack_indentation_uids(in, uids);
+        std::array<Indentation, Cube::EDGES> ind;
+        for (std::size_t i = 0; i < Cube::EDGES; i++) {
+            // the journal only reads back what it wrote itself
+            ind[i] = Indentation(uids[i]);
+        }
+        pool.set_indentations(node.index, ind);
+    }
+}
+
+std::optional<MortonCode> EditJournal::address(const Cube &cube) const noexcept {
+    assert(cube.pool() == m_root.pool());
+    return pool().morton_code(cube.index());
+}
+
+std::deque<std::uint8_t>::iterator EditJournal::begin_record(const Operation operation, const MortonCode code,
+                                                             const std::size_t size) {
+    m_buffer.resize(m_applied_bytes);
+    m_record_sizes.resize(m_applied);
+    m_buffer.resize(m_applied_bytes + HEADER_BYTES + size);
+    m_record_sizes.push_back(static_cast<std::uint32_t>(HEADER_BYTES + size));
+
+    auto out = std::next(m_buffer.begin(), static_cast<std::ptrdiff_t>(m_applied_bytes));
+    *out++ = static_cast<std::uint8_t>(operation);
+    for (std::size_t byte = 0; byte < sizeof(MortonCode); byte++) {
+        *out++ = static_cast<std::uint8_t>(code >> (8 * byte));
+    }
+    return out;
+}
+
+void EditJournal::end_record() {
+    m_applied++;
+    m_applied_bytes = m_buffer.size();
+    set_memory_budget(m_memory_budget);
+}
+
+void EditJournal::apply(std::deque<std::uint8_t>::const_iterator record) const {
+    const auto operation = static_cast<Operation>(*record++);
+    MortonCode code = 0;
+    for (std::size_t byte = 0; byte < sizeof(MortonCode); byte++) {
+        code |= static_cast<MortonCode>(*record++) << (8 * byte);
+    }
+    CubePool &pool = this->pool();
+    const CubePool::Index idx = resolve(code);
+    switch (operation) {
+    case Operation::SET_TYPE:
+        pool.set_type(idx, static_cast<Cube::Type>(record[0]));
+        break;
+    case Operation::SET_INDENT:
+        pool.set_indent(idx, record[0], Indentation(record[1]));
+        break;
+    case Operation::INDENT:
+        pool.indent(idx, record[0], record[1] != 0, record[2]);
+        break;
+    case Operation::ROTATE:
+        pool.rotate(idx, *ROTATION_AXES[record[0]], record[1]);
+        break;
+    }
+}
+
+bool EditJournal::set_type(const Cube &cube, const Cube::Type new_type) {
+    const std::optional<MortonCode> code = address(cube);
+    if (!code) {
+        return false;
+    }
+    if (cube.type() == new_type) {
+        return true;
+    }
+    auto out = begin_record(Operation::SET_TYPE, *code, 1 + subtree_bytes(cube.index()));
+    *out++ = static_cast<std::uint8_t>(new_type);
+    write_subtree(cube.index(), out);
+    pool().set_type(cube.index(), new_type);
+    end_record();
+    return true;
+}
+
+bool EditJournal::set_indent(const Cube &cube, const std::uint8_t edge_id, const Indentation indentation) {
+    const std::optional<MortonCode> code = address(cube);
+    if (!code) {
+        return false;
+    }
+    if (cube.type() != Cube::Type::NORMAL) {
+        return true;
+    }
+    auto out = begin_record(Operation::SET_INDENT, *code, 3);
+    *out++ = edge_id;
+    *out++ = indentation.uid();
+    *out++ = cube.indentations()[edge_id].uid();
+    pool().set_indent(cube.index(), edge_id, indentation);
+    end_record();
+    return true;
+}
+
+bool EditJournal::indent(const Cube &cube, const std::uint8_t edge_id, const bool positive_direction,
+                         const std::uint8_t steps) {
+    const std::optional<MortonCode> code = address(cube);
+    if (!code) {
+        return false;
+    }
+    if (cube.type() != Cube::Type::NORMAL) {
+        return true;
+    }
+    auto out = begin_record(Operation::INDENT, *code, 4);
+    *out++ = edge_id;
+    *out++ = positive_direction ? 1 : 0;
+    *out++ = steps;
+    *out++ = cube.indentations()[edge_id].uid();
+    pool().indent(cube.index(), edge_id, positive_direction, steps);
+    end_record();
+    return true;
+}
+
+bool EditJournal::rotate(const Cube &cube, const Cube::RotationAxis::Type &axis, int rotations) {
+    const std::optional<MortonCode> code = address(cube);
+    if (!code) {
+        return false;
+    }
+    rotations = ((rotations % 4) + 4) % 4;
+    if (rotations == 0 || cube.type() == Cube::Type::EMPTY || cube.type() == Cube::Type::SOLID) {
+        return true;
+    }
+    std::uint8_t axis_id = 0;
+    while (axis_id < ROTATION_AXES.size() && *ROTATION_AXES[axis_id] != axis) {
+        axis_id++;
+    }
+    assert(axis_id < ROTATION_AXES.size());
+    auto out = begin_record(Operation::ROTATE, *code, 2);
+    *out++ = axis_id;
+    *out++ = static_cast<std::uint8_t>(rotations);
+    pool().rotate(cube.index(), axis, rotations);
+    end_record();
+    return true;
+}
+
+bool EditJournal::undo() {
+    if (m_applied == 0) {
+        return false;
+    }
+    m_applied--;
+    m_applied_bytes -= m_record_sizes[m_applied];
+
+    auto record = std::next(m_buffer.cbegin(), static_cast<std::ptrdiff_t>(m_applied_bytes));
+    const auto operation = static_cast<Operation>(*record);
+    MortonCode code = 0;
+    for (std::size_t byte = 0; byte < sizeof(MortonCode); byte++) {
+        code |= static_cast<MortonCode>(record[1 + byte]) << (8 * byte);
+    }
+    record += HEADER_BYTES;
+
+    CubePool &pool = this->pool();
+    // the prior state was compacted already
+    const AutoCompactGuard guard(pool);
+    const CubePool::Index idx = resolve(code);
+    switch (operation) {
+    case Operation::SET_TYPE:
+        // skip the new type
+        record++;
+        read_subtree(idx, record);
+        break;
+    case Operation::SET_INDENT:
+        pool.set_indent(idx, record[0], Indentation(record[2]));
+        break;
+    case Operation::INDENT:
+        pool.set_indent(idx, record[0], Indentation(record[3]));
+        break;
+    case Operation::ROTATE:
+        pool.rotate(idx, *ROTATION_AXES[record[0]], 4 - record[1]);
+        break;
+    }
+    return true;
+}
+
+bool EditJournal::redo() {
+    if (m_applied == m_record_sizes.size()) {
+        return false;
+    }
+    apply(std::next(m_buffer.cbegin(), static_cast<std::ptrdiff_t>(m_applied_bytes)));
+    m_applied_bytes += m_record_sizes[m_applied];
+    m_applied++;
+    return true;
+}
+
+void EditJournal::clear() noexcept {
+    m_buffer.clear();
+    m_record_sizes.clear();
+    m_applied = 0;
+    m_applied_bytes = 0;
+}
+
+std::size_t EditJournal::undo_count() const noexcept {
+    return m_applied;
+}
+
+std::size_t EditJournal::redo_count() const noexcept {
+    return m_record_sizes.size() - m_applied;
+}
+
+std::size_t EditJournal::memory_usage() const noexcept {
+    return m_buffer.size() + m_record_sizes.size() * sizeof(std::uint32_t);
+}
+
+std::size_t EditJournal::memory_budget() const noexcept {
+    return m_memory_budget;
+}
+
+void EditJournal::set_memory_budget(const std::size_t memory_budget) {
+    m_memory_budget = memory_budget;
+    while (memory_usage() > m_memory_budget) {
+        if (m_record_sizes.size() > m_applied) {
+            // drop the newest undone edit, the undone edits have to be redone in order
+            m_buffer.resize(m_buffer.size() - m_record_sizes.back());
+            m_record_sizes.pop_back();
+            continue;
+        }
+        m_buffer.erase(m_buffer.begin(), std::next(m_buffer.begin(), m_record_sizes.front()));
+        m_applied_bytes -= m_record_sizes.front();
+        m_record_sizes.pop_front();
+        m_applied--;
+    }
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -9,7 +9,7 @@ namespace inexor::vulkan_renderer::world {
 Indentation::Indentation(const std::uint8_t start, const std::uint8_t end) noexcept : m_start(start), m_end(end) {}
 
 Indentation::Indentation(const std::uint8_t uid) noexcept {
-    assert(uid <= 44);
+    assert(uid <= MAX_UID);
     constexpr std::array<std::uint8_t, Indentation::MAX> masks{44, 42, 39, 35, 30, 24, 17, 9};
     for (std::uint8_t idx = 0; idx < Indentation::MAX; idx++) {
         if (masks[idx] <= uid) {
@@ -0,0 +1,66 @@
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+/// Insert two zero bits after each of the lower 21 bits.
+std::uint64_t spread_bits(std::uint64_t value) noexcept {
+    value &= 0x1fffffU;
+    value = (value | value << 32U) & 0x1f00000000ffffU;
+    value = (value | value << 16U) & 0x1f0000ff0000ffU;
+    value = (value | value << 8U) & 0x100f00f00f00f00fU;
+    value = (value | value << 4U) & 0x10c30c30c30c30c3U;
+    value = (value | value << 2U) & 0x1249249249249249U;
+    return value;
+}
+
+/// Inverse of spread_bits.
+std::uint32_t compact_bits(std::uint64_t value) noexcept {
+    value &= 0x1249249249249249U;
+    value = (value ^ (value >> 2U)) & 0x10c30c30c30c30c3U;
+    value = (value ^ (value >> 4U)) & 0x100f00f00f00f00fU;
+    value = (value ^ (value >> 8U)) & 0x1f0000ff0000ffU;
+    value = (value ^ (value >> 16U)) & 0x1f00000000ffffU;
+    value = (value ^ (value >> 32U)) & 0x1fffffU;
+    return static_cast<std::uint32_t>(value);
+}
+} // namespace
+
+MortonCode morton_code(const glm::uvec3 &cell, const std::size_t level) noexcept {
+    assert(level <= MAX_MORTON_LEVEL);
+    assert(cell.x >> level == 0 && cell.y >> level == 0 && cell.z >> level == 0);
+    return (MortonCode{1} << (3 * level)) | spread_bits(cell.x) << 2U | spread_bits(cell.y) << 1U |
+           spread_bits(cell.z);
+}
+
+std::size_t morton_level(MortonCode code) noexcept {
+    assert(code != 0);
+    std::size_t level = 0;
+    while (code > 1) {
+        code >>= 3U;
+        level++;
+    }
+    return level;
+}
+
+glm::uvec3 morton_cell(const MortonCode code) noexcept {
+    // remove the level bit
+    const MortonCode cell = code ^ (MortonCode{1} << (3 * morton_level(code)));
+    return {compact_bits(cell >> 2U), compact_bits(cell >> 1U), compact_bits(cell)};
+}
+
+MortonCode morton_parent(const MortonCode code) noexcept {
+    assert(code > 1);
+    return code >> 3U;
+}
+
+MortonCode morton_child(const MortonCode code, const std::size_t child_id) noexcept {
+    assert(child_id < Cube::SUB_CUBES);
+    assert(morton_level(code) < MAX_MORTON_LEVEL);
+    return code << 3U | child_id;
+}
+} // namespace inexor::vulkan_renderer::world
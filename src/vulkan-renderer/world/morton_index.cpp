@@ -0,0 +1,51 @@
+#include "inexor/vulkan-renderer/world/morton_index.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+MortonIndex::MortonIndex(std::shared_ptr<const CubePool> pool, const std::size_t level)
+    : m_pool(std::move(pool)), m_level(level) {
+    assert(m_pool);
+    assert(m_level <= MAX_MORTON_LEVEL);
+}
+
+void MortonIndex::insert(const CubePool::Index idx, const MortonCode code) {
+    m_cubes.emplace(code, idx);
+    if (morton_level(code) == m_level || m_pool->type(idx) != Cube::Type::OCTANT) {
+        return;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        insert(m_pool->child(idx, child_id), morton_child(code, child_id));
+    }
+}
+
+void MortonIndex::build() {
+    m_cubes.clear();
+    insert(CubePool::ROOT_INDEX, 1);
+    m_structure_version = m_pool->structure_version();
+    m_built = true;
+}
+
+CubePool::Index MortonIndex::find(MortonCode code) {
+    if (!m_built || m_structure_version != m_pool->structure_version()) {
+        build();
+    }
+    for (std::size_t level = morton_level(code); level > m_level; level--) {
+        code = morton_parent(code);
+    }
+    // If the cube does not exist, the first existing parent is the leaf cube which contains it.
+    for (;; code = morton_parent(code)) {
+        if (const auto cube = m_cubes.find(code); cube != m_cubes.end()) {
+            return cube->second;
+        }
+        if (code == 1) {
+            return CubePool::INVALID_INDEX;
+        }
+    }
+}
+
+std::size_t MortonIndex::level() const noexcept {
+    return m_level;
+}
+} // namespace inexor::vulkan_renderer::world
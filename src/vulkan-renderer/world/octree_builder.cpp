@@ -0,0 +1,283 @@
+#include "inexor/vulkan-renderer/world/octree_builder.hpp"
+
+#include "inexor/vulkan-renderer/world/morton.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// The grid is split into at most 8^3 parts.
+constexpr std::size_t MAX_SPLIT_LEVEL{3};
+
+bool uniform(const std::vector<Cube::Type>::const_iterator first, const std::vector<Cube::Type>::const_iterator last) {
+    return (*first == Cube::Type::EMPTY || *first == Cube::Type::SOLID) &&
+           std::all_of(first + 1, last, [&](const Cube::Type type) { return type == *first; });
+}
+
+} // namespace
+
+VoxelGrid::VoxelGrid(const std::size_t level)
+    : m_level(level), m_types(std::size_t{1} << (3 * level), Cube::Type::EMPTY) {
+    assert(level <= MAX_MORTON_LEVEL);
+}
+
+std::size_t VoxelGrid::voxel(const glm::uvec3 &cell) const noexcept {
+    // remove the level bit
+    return morton_code(cell, m_level) ^ (MortonCode{1} << (3 * m_level));
+}
+
+void VoxelGrid::set_voxel(const std::size_t voxel, const Cube::Type type,
+                          const std::array<Indentation, Cube::EDGES> &indentations) {
+    assert(type != Cube::Type::OCTANT);
+    m_types[voxel] = type;
+    if (type == Cube::Type::NORMAL) {
+        m_indentations[voxel] = indentations;
+    } else {
+        m_indentations.erase(voxel);
+    }
+}
+
+std::size_t VoxelGrid::level() const noexcept {
+    return m_level;
+}
+
+std::uint32_t VoxelGrid::resolution() const noexcept {
+    return std::uint32_t{1} << m_level;
+}
+
+Cube::Type VoxelGrid::type(const glm::uvec3 &cell) const noexcept {
+    return m_types[voxel(cell)];
+}
+
+const std::array<Indentation, Cube::EDGES> &VoxelGrid::indentations(const glm::uvec3 &cell) const {
+    assert(type(cell) == Cube::Type::NORMAL);
+    return m_indentations.at(voxel(cell));
+}
+
+void VoxelGrid::set(const glm::uvec3 &cell, const Cube::Type type,
+                    const std::array<Indentation, Cube::EDGES> &indentations) {
+    set_voxel(voxel(cell), type, indentations);
+}
+
+void VoxelGrid::set_run(const std::size_t first, const std::size_t count, const Cube::Type type,
+                        const std::array<Indentation, Cube::EDGES> &indentations) {
+    assert(first + count <= m_types.size());
+    const std::uint32_t resolution = this->resolution();
+    glm::uvec3 cell(first % resolution, (first / resolution) % resolution, first / resolution / resolution);
+    for (std::size_t i = 0; i < count; i++) {
+        set_voxel(voxel(cell), type, indentations);
+        if (++cell.x == resolution) {
+            cell.x = 0;
+            if (++cell.y == resolution) {
+                cell.y = 0;
+                cell.z++;
+            }
+        }
+    }
+}
+
+OctreeBuilder::OctreeBuilder(const std::size_t thread_count)
+    : OctreeBuilder(std::make_shared<WorkerPool>(thread_count)) {}
+
+OctreeBuilder::OctreeBuilder(std::shared_ptr<WorkerPool> workers) : m_workers(std::move(workers)) {}
+
+void OctreeBuilder::encode(const VoxelGrid &grid, const std::size_t first_voxel, const std::size_t levels,
+                           Part &part) {
+    if (levels == 0) {
+        const Cube::Type type = grid.m_types[first_voxel];
+        part.types.push_back(type);
+        if (type == Cube::Type::NORMAL) {
+            part.indentations.push_back(grid.m_indentations.at(first_voxel));
+        }
+        if (type != Cube::Type::EMPTY) {
+            part.geometry_cubes++;
+        }
+        return;
+    }
+    const std::size_t octant = part.types.size();
+    part.types.push_back(Cube::Type::OCTANT);
+    const std::size_t child_voxels = std::size_t{1} << (3 * (levels - 1));
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        encode(grid, first_voxel + child_id * child_voxels, levels - 1, part);
+    }
+    // merge like CubePool::compact() if all children are leaves of the same type
+    if (part.types.size() == octant + 1 + Cube::SUB_CUBES &&
+        uniform(part.types.begin() + octant + 1, part.types.end())) {
+        const Cube::Type type = part.types[octant + 1];
+        part.types.resize(octant + 1);
+        part.types[octant] = type;
+        if (type == Cube::Type::SOLID) {
+            part.geometry_cubes -= Cube::SUB_CUBES - 1;
+        }
+        return;
+    }
+    part.octants++;
+}
+
+void OctreeBuilder::grow(CubePool &pool, const std::size_t nodes, const std::size_t payloads) {
+    assert(nodes < CubePool::INVALID_INDEX && payloads < CubePool::INVALID_INDEX);
+    pool.m_bits.resize(std::max(nodes, pool.m_bits.size()));
+    pool.m_parents.resize(std::max(nodes, pool.m_parents.size()));
+    pool.m_data.resize(std::max(nodes, pool.m_data.size()));
+    pool.m_geometry_counts.resize(std::max(nodes, pool.m_geometry_counts.size()));
+    pool.m_indentations.resize(std::max(payloads, pool.m_indentations.size()));
+    pool.m_polygon_caches.resize(std::max(payloads, pool.m_polygon_caches.size()));
+}
+
+void OctreeBuilder::write_cells(CubePool &pool, const CubePool::Index idx, const std::size_t level,
+                                const std::size_t cell, const std::vector<std::vector<Cube::Type>> &cell_types,
+                                std::vector<Part> &parts, CubePool::Index &next_block,
+                                CubePool::Index &next_payload) {
+    if (level + 1 == cell_types.size()) {
+        parts[cell].root = idx;
+        return;
+    }
+    const Cube::Type type = cell_types[level][cell];
+    CubePool::Index data = CubePool::INVALID_INDEX;
+    if (type == Cube::Type::SOLID) {
+        data = next_payload++;
+    } else if (type == Cube::Type::OCTANT) {
+        data = next_block;
+        next_block += Cube::SUB_CUBES;
+    }
+    grow(pool, next_block, next_payload);
+    pool.m_bits.writable(idx) = static_cast<std::uint8_t>(static_cast<std::uint8_t>(type) | CubePool::DIRTY_BIT);
+    pool.m_data.writable(idx) = data;
+    // the counts of the octants are added by their children
+    pool.m_geometry_counts.writable(idx) = type == Cube::Type::SOLID ? 1 : 0;
+    if (type != Cube::Type::OCTANT) {
+        add_to_parents(pool, idx);
+        return;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        pool.m_parents.writable(data + child_id) = idx;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        write_cells(pool, data + static_cast<CubePool::Index>(child_id), level + 1, cell * Cube::SUB_CUBES + child_id,
+                    cell_types, parts, next_block, next_payload);
+    }
+}
+
+void OctreeBuilder::write_part(CubePool &pool, const Part &part) {
+    CubePool::Index next_block = part.first_block;
+    CubePool::Index next_payload = part.first_payload;
+    auto type = part.types.begin();
+    auto indentations = part.indentations.begin();
+    // the iterator visits the children of a cube after it became an octant, the positions are not needed
+    visit_pre_order(pool, part.root, pool.m_position, pool.m_size, [&](const TraversalNode &node) {
+        CubePool::Index data = CubePool::INVALID_INDEX;
+        if (*type == Cube::Type::OCTANT) {
+            data = next_block;
+            next_block += Cube::SUB_CUBES;
+            for (CubePool::Index child = data; child < next_block; child++) {
+                pool.m_parents.writable(child) = node.index;
+            }
+        } else if (*type != Cube::Type::EMPTY) {
+            data = next_payload++;
+            if (*type == Cube::Type::NORMAL) {
+                pool.m_indentations.writable(data) = *indentations++;
+            }
+        }
+        pool.m_bits.writable(node.index) =
+            static_cast<std::uint8_t>(static_cast<std::uint8_t>(*type++) | CubePool::DIRTY_BIT);
+        pool.m_data.writable(node.index) = data;
+        return true;
+    });
+    visit_post_order(pool, part.root, [&](const TraversalNode &node) {
+        std::uint32_t count = 0;
+        switch (pool.type(node.index)) {
+        case Cube::Type::EMPTY:
+            break;
+        case Cube::Type::SOLID:
+        case Cube::Type::NORMAL:
+            count = 1;
+            break;
+        case Cube::Type::OCTANT:
+            for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+                count += pool.m_geometry_counts[pool.child(node.index, child_id)];
+            }
+            break;
+        }
+        pool.m_geometry_counts.writable(node.index) = count;
+    });
+}
+
+void OctreeBuilder::add_to_parents(CubePool &pool, const CubePool::Index idx) {
+    for (CubePool::Index parent_idx = pool.m_parents[idx]; parent_idx != CubePool::INVALID_INDEX;
+         parent_idx = pool.m_parents[parent_idx]) {
+        pool.m_geometry_counts.writable(parent_idx) += pool.m_geometry_counts[idx];
+    }
+}
+
+std::size_t OctreeBuilder::thread_count() const noexcept {
+    return m_workers->thread_count();
+}
+
+Cube OctreeBuilder::build(const VoxelGrid &grid, const float size, const glm::vec3 &position) const {
+    // a few parts per thread balance the load
+    std::size_t split_level = 0;
+    while (split_level < std::min(grid.level(), MAX_SPLIT_LEVEL) &&
+           (std::size_t{1} << (3 * split_level)) < 4 * thread_count()) {
+        split_level++;
+    }
+    const std::size_t part_levels = grid.level() - split_level;
+    std::vector<Part> parts(std::size_t{1} << (3 * split_level));
+    m_workers->parallel_for(parts.size(),
+                            [&](const std::size_t i) { encode(grid, i << (3 * part_levels), part_levels, parts[i]); });
+
+    // Merge the cells above the split level bottom-up, Type::OCTANT for cells which are not merged.
+    std::vector<std::vector<Cube::Type>> cell_types(split_level + 1);
+    for (const Part &part : parts) {
+        cell_types[split_level].push_back(part.types.size() == 1 ? part.types[0] : Cube::Type::OCTANT);
+    }
+    for (std::size_t level = split_level; level > 0; level--) {
+        const std::vector<Cube::Type> &children = cell_types[level];
+        for (auto first = children.begin(); first != children.end(); first += Cube::SUB_CUBES) {
+            cell_types[level - 1].push_back(uniform(first, first + Cube::SUB_CUBES) ? *first : Cube::Type::OCTANT);
+        }
+    }
+
+    // The payload of the solid root cube is reused.
+    auto pool = std::make_shared<CubePool>(size, position);
+    CubePool::Index next_block = 1;
+    CubePool::Index next_payload = 0;
+    write_cells(*pool, CubePool::ROOT_INDEX, 0, 0, cell_types, parts, next_block, next_payload);
+    std::size_t nodes = next_block;
+    std::size_t payloads = next_payload;
+    for (Part &part : parts) {
+        if (part.root == CubePool::INVALID_INDEX) {
+            continue;
+        }
+        part.first_block = static_cast<CubePool::Index>(nodes);
+        part.first_payload = static_cast<CubePool::Index>(payloads);
+        nodes += part.octants * Cube::SUB_CUBES;
+        payloads += part.geometry_cubes;
+    }
+    grow(*pool, nodes, payloads);
+    if (payloads == 0) {
+        pool->m_free_payloads.push_back(0);
+    }
+
+    // Every part writes different elements of the arrays, which have been resized already and are not shared.
+    m_workers->parallel_for(parts.size(), [&](const std::size_t i) {
+        if (parts[i].root != CubePool::INVALID_INDEX) {
+            write_part(*pool, parts[i]);
+        }
+    });
+    for (const Part &part : parts) {
+        if (part.root != CubePool::INVALID_INDEX) {
+            add_to_parents(*pool, part.root);
+        }
+    }
+    if (pool->type(CubePool::ROOT_INDEX) == Cube::Type::OCTANT) {
+        pool->m_structure_version++;
+    }
+    return {pool, CubePool::ROOT_INDEX};
+}
+
+} // namespace inexor::vulkan_renderer::world
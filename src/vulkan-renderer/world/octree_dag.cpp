@@ -0,0 +1,252 @@
+#include "inexor/vulkan-renderer/world/octree_dag.hpp"
+
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+void hash_combine(std::size_t &hash, const std::size_t value) noexcept {
+    hash ^= value + 0x9e3779b97f4a7c15U + (hash << 6U) + (hash >> 2U);
+}
+
+/// Estimated memory of a hash table: every element is a list node with a next pointer and the cached hash, every bucket
+/// is a pointer.
+template <typename Map>
+std::size_t hash_table_bytes(const Map &map) noexcept {
+    return map.size() * (sizeof(typename Map::value_type) + sizeof(void *) + sizeof(std::size_t)) +
+           map.bucket_count() * sizeof(void *);
+}
+
+} // namespace
+
+std::size_t OctreeDag::ChildrenHash::operator()(const std::array<NodeId, Cube::SUB_CUBES> &children) const noexcept {
+    std::size_t hash = 0;
+    for (const NodeId child : children) {
+        hash_combine(hash, child);
+    }
+    return hash;
+}
+
+std::size_t OctreeDag::IndentationsHash::operator()(const std::array<std::uint8_t, Cube::EDGES> &uids) const noexcept {
+    std::size_t hash = 0;
+    for (const std::uint8_t uid : uids) {
+        hash_combine(hash, uid);
+    }
+    return hash;
+}
+
+OctreeDag::OctreeDag() {
+    m_nodes.push_back({Cube::Type::EMPTY, INVALID_NODE, 1, 0});
+    m_nodes.push_back({Cube::Type::SOLID, INVALID_NODE, 1, 1});
+}
+
+OctreeDag::OctreeDag(const Cube &cube) : OctreeDag() {
+    const CubePool &pool = *cube.pool();
+    // the children of an octant are the last eight nodes on the stack
+    std::vector<NodeId> stack;
+    visit_post_order(pool, cube.index(), [&](const TraversalNode &node) {
+        const Cube::Type type = pool.type(node.index);
+        if (type != Cube::Type::OCTANT) {
+            stack.push_back(type == Cube::Type::NORMAL ? leaf(type, pool.indentations(node.index)) : leaf(type));
+            return;
+        }
+        std::array<NodeId, Cube::SUB_CUBES> children{};
+        std::copy(stack.end() - Cube::SUB_CUBES, stack.end(), children.begin());
+        stack.resize(stack.size() - Cube::SUB_CUBES);
+        stack.push_back(octant(children));
+    });
+    assert(stack.size() == 1);
+    m_root = stack.back();
+}
+
+OctreeDag::NodeId OctreeDag::replace(const NodeId node, const MortonCode code, const std::size_t level,
+                                     const NodeId subtree) {
+    if (level == 0) {
+        return subtree;
+    }
+    std::array<NodeId, Cube::SUB_CUBES> children{};
+    if (type(node) == Cube::Type::OCTANT) {
+        children = m_children[m_nodes[node].data];
+    } else {
+        children.fill(node);
+    }
+    const std::size_t child_id = (code >> (3 * (level - 1))) & 0b111U;
+    children[child_id] = replace(children[child_id], code, level - 1, subtree);
+    return octant(children);
+}
+
+OctreeDag::NodeId OctreeDag::leaf(const Cube::Type type, const std::array<Indentation, Cube::EDGES> &indentations) {
+    assert(type != Cube::Type::OCTANT);
+    if (type == Cube::Type::EMPTY) {
+        return EMPTY_NODE;
+    }
+    if (type == Cube::Type::SOLID) {
+        return SOLID_NODE;
+    }
+    std::array<std::uint8_t, Cube::EDGES> uids{};
+    std::transform(indentations.begin(), indentations.end(), uids.begin(),
+                   [](const Indentation &indentation) { return indentation.uid(); });
+    const auto [iter, inserted] = m_normal_leaves.try_emplace(uids, static_cast<NodeId>(m_nodes.size()));
+    if (inserted) {
+        assert(m_nodes.size() < INVALID_NODE);
+        m_nodes.push_back({Cube::Type::NORMAL, static_cast<std::uint32_t>(m_indentations.size()), 1, 1});
+        m_indentations.push_back(indentations);
+    }
+    return iter->second;
+}
+
+OctreeDag::NodeId OctreeDag::octant(const std::array<NodeId, Cube::SUB_CUBES> &children) {
+    const auto [iter, inserted] = m_octants.try_emplace(children, static_cast<NodeId>(m_nodes.size()));
+    if (inserted) {
+        assert(m_nodes.size() < INVALID_NODE);
+        Node node{Cube::Type::OCTANT, static_cast<std::uint32_t>(m_children.size()), 1, 0};
+        for (const NodeId child : children) {
+            node.cubes += m_nodes[child].cubes;
+            node.geometry_cubes += m_nodes[child].geometry_cubes;
+        }
+        m_nodes.push_back(node);
+        m_children.push_back(children);
+    }
+    return iter->second;
+}
+
+OctreeDag::NodeId OctreeDag::root() const noexcept {
+    return m_root;
+}
+
+void OctreeDag::set_root(const NodeId root) {
+    assert(root < m_nodes.size());
+    m_root = root;
+}
+
+Cube::Type OctreeDag::type(const NodeId node) const noexcept {
+    return m_nodes[node].type;
+}
+
+OctreeDag::NodeId OctreeDag::child(const NodeId node, const std::size_t child_id) const noexcept {
+    assert(type(node) == Cube::Type::OCTANT);
+    return m_children[m_nodes[node].data][child_id];
+}
+
+const std::array<Indentation, Cube::EDGES> &OctreeDag::indentations(const NodeId node) const noexcept {
+    assert(type(node) == Cube::Type::NORMAL);
+    return m_indentations[m_nodes[node].data];
+}
+
+void OctreeDag::set(const MortonCode code, const NodeId subtree) {
+    assert(subtree < m_nodes.size());
+    m_root = replace(m_root, code, morton_level(code), subtree);
+}
+
+void OctreeDag::set_type(const MortonCode code, const Cube::Type type) {
+    // like Cube::set_type(), setting the current type keeps the cube
+    NodeId node = m_root;
+    std::size_t level = morton_level(code);
+    for (; level > 0 && this->type(node) == Cube::Type::OCTANT; level--) {
+        node = child(node, (code >> (3 * (level - 1))) & 0b111U);
+    }
+    if (level == 0 && this->type(node) == type) {
+        return;
+    }
+    if (type == Cube::Type::OCTANT) {
+        std::array<NodeId, Cube::SUB_CUBES> children{};
+        children.fill(SOLID_NODE);
+        set(code, octant(children));
+        return;
+    }
+    set(code, leaf(type));
+}
+
+void OctreeDag::set_indentations(const MortonCode code, const std::array<Indentation, Cube::EDGES> &indentations) {
+    set(code, leaf(Cube::Type::NORMAL, indentations));
+}
+
+std::size_t OctreeDag::collect_garbage() {
+    // Children are always added before their parents, so a single pass from the newest node marks all used nodes.
+    std::vector<bool> used(m_nodes.size(), false);
+    used[EMPTY_NODE] = true;
+    used[SOLID_NODE] = true;
+    used[m_root] = true;
+    for (std::size_t node = m_nodes.size(); node-- > 0;) {
+        if (used[node] && m_nodes[node].type == Cube::Type::OCTANT) {
+            for (const NodeId child : m_children[m_nodes[node].data]) {
+                used[child] = true;
+            }
+        }
+    }
+    OctreeDag dag;
+    std::vector<NodeId> new_ids(m_nodes.size(), INVALID_NODE);
+    for (std::size_t node = 0; node < m_nodes.size(); node++) {
+        if (!used[node]) {
+            continue;
+        }
+        switch (m_nodes[node].type) {
+        case Cube::Type::EMPTY:
+        case Cube::Type::SOLID:
+            new_ids[node] = static_cast<NodeId>(node);
+            break;
+        case Cube::Type::NORMAL:
+            new_ids[node] = dag.leaf(Cube::Type::NORMAL, m_indentations[m_nodes[node].data]);
+            break;
+        case Cube::Type::OCTANT:
+            std::array<NodeId, Cube::SUB_CUBES> children = m_children[m_nodes[node].data];
+            for (NodeId &child : children) {
+                child = new_ids[child];
+            }
+            new_ids[node] = dag.octant(children);
+            break;
+        }
+    }
+    dag.m_root = new_ids[m_root];
+    const std::size_t removed = m_nodes.size() - dag.m_nodes.size();
+    *this = std::move(dag);
+    return removed;
+}
+
+std::size_t OctreeDag::node_count() const noexcept {
+    return m_nodes.size();
+}
+
+std::uint64_t OctreeDag::cube_count() const noexcept {
+    return m_nodes[m_root].cubes;
+}
+
+std::size_t OctreeDag::memory_usage() const noexcept {
+    return m_nodes.size() * sizeof(Node) + m_children.size() * sizeof(std::array<NodeId, Cube::SUB_CUBES>) +
+           m_indentations.size() * sizeof(std::array<Indentation, Cube::EDGES>) + hash_table_bytes(m_octants) +
+           hash_table_bytes(m_normal_leaves);
+}
+
+double OctreeDag::compression_ratio() const noexcept {
+    const Node &root = m_nodes[m_root];
+    const double expanded_bytes =
+        static_cast<double>(root.cubes) * CubePool::NODE_BYTES +
+        static_cast<double>(root.geometry_cubes) * sizeof(std::array<Indentation, Cube::EDGES>);
+    return expanded_bytes / static_cast<double>(memory_usage());
+}
+
+Cube OctreeDag::to_cube(const float size, const glm::vec3 &position) const {
+    Cube root(size, position);
+    CubePool &pool = *root.pool();
+    // The DAG nodes of the path to the current cube.
+    std::vector<NodeId> path;
+    // the iterator visits the children of a cube after it became an octant
+    for (const TraversalNode &node : pre_order(pool, CubePool::ROOT_INDEX)) {
+        path.resize(node.depth + 1);
+        path[node.depth] = node.depth == 0 ? m_root : child(path[node.depth - 1], pool.child_id(node.index));
+        const NodeId dag_node = path[node.depth];
+        pool.set_type(node.index, type(dag_node));
+        if (type(dag_node) == Cube::Type::NORMAL) {
+            pool.set_indentations(node.index, indentations(dag_node));
+        }
+    }
+    return root;
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,510 @@
+#include "inexor/vulkan-renderer/world/octree_mesher.hpp"
+
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+/// Part of the volume filled with geometry, indented cubes count as filled.
+float fill_ratio(const CubePool &pool, const CubePool::Index idx) {
+    switch (pool.type(idx)) {
+    case Cube::Type::EMPTY:
+        return 0.0F;
+    case Cube::Type::OCTANT: {
+        float ratio = 0.0F;
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            ratio += fill_ratio(pool, pool.child(idx, child_id));
+        }
+        return ratio / Cube::SUB_CUBES;
+    }
+    default:
+        return 1.0F;
+    }
+}
+
+/// Is any part of the face covered by solid cubes.
+bool face_partially_solid(const CubePool &pool, const CubePool::Index idx, const std::size_t face) {
+    const Cube::Type type = pool.type(idx);
+    if (type != Cube::Type::OCTANT) {
+        return type == Cube::Type::SOLID;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        if (CubePool::child_on_face(child_id, face) && face_partially_solid(pool, pool.child(idx, child_id), face)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Are there octants depth levels below the cube.
+bool has_octant_at(const CubePool &pool, const CubePool::Index idx, const std::size_t depth) {
+    if (pool.type(idx) != Cube::Type::OCTANT) {
+        return false;
+    }
+    if (depth == 0) {
+        return true;
+    }
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        if (has_octant_at(pool, pool.child(idx, child_id), depth - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// A cell of the grid of a level of detail.
+struct LodCell {
+    bool solid{false};
+    /// The cube at the cell or the leaf cube which contains it.
+    CubePool::Index idx{CubePool::INVALID_INDEX};
+};
+
+/// Fill the cells of the grid with a resolution of 2^depth cells per axis.
+void rasterize(const CubePool &pool, const CubePool::Index idx, const std::size_t depth, const glm::ivec3 &cell,
+               const int span, const int resolution, std::vector<LodCell> &cells) {
+    const auto cell_index = [&](const int x, const int y, const int z) {
+        return (static_cast<std::size_t>(x) * resolution + y) * resolution + z;
+    };
+    const Cube::Type type = pool.type(idx);
+    if (depth == 0) {
+        bool solid = fill_ratio(pool, idx) >= 0.5F;
+        // Neighbor regions cull faces against the solid cubes on the bounds of this region.
+        for (std::size_t face = 0; face < CubePool::FACES && !solid; face++) {
+            const int coordinate = cell[static_cast<int>(face / 2)];
+            const bool on_bounds = face % 2 == 0 ? coordinate == 0 : coordinate == resolution - 1;
+            solid = on_bounds && face_partially_solid(pool, idx, face);
+        }
+        cells[cell_index(cell.x, cell.y, cell.z)] = {solid, idx};
+        return;
+    }
+    if (type != Cube::Type::OCTANT) {
+        const bool solid = type != Cube::Type::EMPTY;
+        for (int x = cell.x; x < cell.x + span; x++) {
+            for (int y = cell.y; y < cell.y + span; y++) {
+                for (int z = cell.z; z < cell.z + span; z++) {
+                    cells[cell_index(x, y, z)] = {solid, idx};
+                }
+            }
+        }
+        return;
+    }
+    const int half_span = span / 2;
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        const glm::ivec3 child_cell{cell.x + static_cast<int>((child_id >> 2U) & 1U) * half_span,
+                                    cell.y + static_cast<int>((child_id >> 1U) & 1U) * half_span,
+                                    cell.z + static_cast<int>(child_id & 1U) * half_span};
+        rasterize(pool, pool.child(idx, child_id), depth - 1, child_cell, half_span, resolution, cells);
+    }
+}
+} // namespace
+
+void OctreeMesher::collect_invalid_caches(const std::uint32_t idx, const glm::vec3 &position, const float size,
+                                          std::vector<std::uint32_t> &indices, PolygonBatch &batch) const {
+    const CubePool &pool = *m_root.pool();
+    const Cube::Type type = pool.type(idx);
+    if (type == Cube::Type::OCTANT) {
+        const float half_size = size / 2;
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            collect_invalid_caches(pool.child(idx, child_id), position + CubePool::child_offset(child_id, half_size),
+                                   half_size, indices, batch);
+        }
+        return;
+    }
+    // greedy meshing does not use the caches of solid cubes
+    if ((type == Cube::Type::NORMAL || (type == Cube::Type::SOLID && !m_greedy_meshing)) &&
+        !pool.polygon_cache_valid(idx)) {
+        indices.push_back(idx);
+        batch.add(type, position, size, pool.indentations(idx));
+    }
+}
+
+void OctreeMesher::build_polygon_caches(const std::uint32_t idx, const glm::vec3 &position, const float size,
+                                        std::vector<std::pair<std::uint32_t, CubePolygons>> &polygon_caches) const {
+    std::vector<std::uint32_t> indices;
+    PolygonBatch batch;
+    collect_invalid_caches(idx, position, size, indices, batch);
+    batch.build();
+    polygon_caches.reserve(indices.size());
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        polygon_caches.emplace_back(indices[i], batch.polygons(i));
+    }
+}
+
+void OctreeMesher::collect_visible_polygons(const std::uint32_t idx, const glm::vec3 &position, const float size,
+                                            std::vector<Polygon> &polygons, FacePlanes *planes) const {
+    const CubePool &pool = *m_root.pool();
+    const Cube::Type type = pool.type(idx);
+    if (type == Cube::Type::OCTANT) {
+        const float half_size = size / 2;
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            collect_visible_polygons(pool.child(idx, child_id), position + CubePool::child_offset(child_id, half_size),
+                                     half_size, polygons, planes);
+        }
+        return;
+    }
+    if (type == Cube::Type::EMPTY) {
+        return;
+    }
+    if (planes != nullptr && type == Cube::Type::SOLID) {
+        for (std::size_t face = 0; face < CubePool::FACES; face++) {
+            if (pool.face_hidden(idx, face)) {
+                continue;
+            }
+            const std::size_t axis = face / 2;
+            const std::size_t u = (axis + 1) % 3;
+            const std::size_t v = (axis + 2) % 3;
+            const float plane = position[axis] + static_cast<float>(face % 2) * size;
+            (*planes)[{face, plane}].push_back({position[u], position[u] + size, position[v], position[v] + size});
+        }
+        return;
+    }
+    const PolygonSpan cache = pool.polygon_cache(idx, position, size);
+    // every face consists of two polygons
+    for (std::size_t face = 0; face < CubePool::FACES; face++) {
+        if (!pool.face_hidden(idx, face)) {
+            polygons.push_back(cache[2 * face]);
+            polygons.push_back(cache[2 * face + 1]);
+        }
+    }
+}
+
+void OctreeMesher::merge_faces(const FacePlanes &planes, std::vector<Polygon> &polygons) {
+    std::vector<float> us;
+    std::vector<float> vs;
+    std::vector<bool> covered;
+    for (const auto &[plane_key, rects] : planes) {
+        const auto [face, plane] = plane_key;
+        // Compress the plane to a grid of all rectangle bounds, so differently sized faces share one grid.
+        us.clear();
+        vs.clear();
+        for (const FaceRect &rect : rects) {
+            us.insert(us.end(), {rect.u0, rect.u1});
+            vs.insert(vs.end(), {rect.v0, rect.v1});
+        }
+        std::sort(us.begin(), us.end());
+        us.erase(std::unique(us.begin(), us.end()), us.end());
+        std::sort(vs.begin(), vs.end());
+        vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+
+        const std::size_t columns = us.size() - 1;
+        const std::size_t rows = vs.size() - 1;
+        covered.assign(columns * rows, false);
+        for (const FaceRect &rect : rects) {
+            const auto u_begin = std::lower_bound(us.begin(), us.end(), rect.u0) - us.begin();
+            const auto u_end = std::lower_bound(us.begin(), us.end(), rect.u1) - us.begin();
+            const auto v_begin = std::lower_bound(vs.begin(), vs.end(), rect.v0) - vs.begin();
+            const auto v_end = std::lower_bound(vs.begin(), vs.end(), rect.v1) - vs.begin();
+            for (auto row = v_begin; row < v_end; row++) {
+                std::fill_n(covered.begin() + row * columns + u_begin, u_end - u_begin, true);
+            }
+        }
+
+        const std::size_t axis = face / 2;
+        const std::size_t u = (axis + 1) % 3;
+        const std::size_t v = (axis + 2) % 3;
+        for (std::size_t row = 0; row < rows; row++) {
+            for (std::size_t column = 0; column < columns; column++) {
+                if (!covered[row * columns + column]) {
+                    continue;
+                }
+                // Grow the rectangle along u first, then along v as long as whole rows are covered.
+                std::size_t width = 1;
+                while (column + width < columns && covered[row * columns + column + width]) {
+                    width++;
+                }
+                std::size_t height = 1;
+                while (row + height < rows &&
+                       std::all_of(covered.begin() + (row + height) * columns + column,
+                                   covered.begin() + (row + height) * columns + column + width,
+                                   [](const bool cell) { return cell; })) {
+                    height++;
+                }
+                for (std::size_t merged_row = row; merged_row < row + height; merged_row++) {
+                    std::fill_n(covered.begin() + merged_row * columns + column, width, false);
+                }
+
+                glm::vec3 min;
+                glm::vec3 max;
+                min[axis] = max[axis] = plane;
+                min[u] = us[column];
+                max[u] = us[column + width];
+                min[v] = vs[row];
+                max[v] = vs[row + height];
+                const std::array<Polygon, 2> face_polygons = CubePool::box_face_polygons(min, max, face);
+                polygons.insert(polygons.end(), face_polygons.begin(), face_polygons.end());
+            }
+        }
+    }
+}
+
+std::optional<std::vector<Polygon>> OctreeMesher::build_lod(const std::uint32_t idx, const glm::vec3 &position,
+                                                            const float size, const std::size_t depth) const {
+    const CubePool &pool = *m_root.pool();
+    if (!has_octant_at(pool, idx, depth)) {
+        return std::nullopt;
+    }
+    const int resolution = 1 << depth;
+    const float cell_size = size / static_cast<float>(resolution);
+    std::vector<LodCell> cells(static_cast<std::size_t>(resolution) * resolution * resolution);
+    rasterize(pool, idx, depth, {0, 0, 0}, resolution, resolution, cells);
+
+    FacePlanes planes;
+    std::vector<Polygon> polygons;
+    std::size_t i = 0;
+    for (int x = 0; x < resolution; x++) {
+        for (int y = 0; y < resolution; y++) {
+            for (int z = 0; z < resolution; z++, i++) {
+                const LodCell &cell = cells[i];
+                if (!cell.solid) {
+                    continue;
+                }
+                const glm::ivec3 coordinates{x, y, z};
+                const glm::vec3 min = position + glm::vec3(coordinates) * cell_size;
+                for (std::size_t face = 0; face < CubePool::FACES; face++) {
+                    const auto axis = static_cast<int>(face / 2);
+                    glm::ivec3 next = coordinates;
+                    next[axis] += face % 2 == 0 ? -1 : 1;
+                    if (next[axis] >= 0 && next[axis] < resolution) {
+                        const std::size_t next_cell =
+                            (static_cast<std::size_t>(next.x) * resolution + next.y) * resolution + next.z;
+                        if (cells[next_cell].solid) {
+                            continue;
+                        }
+                    } else {
+                        // The face is on the bounds of the region, which are culled against the full detail neighbor.
+                        const CubePool::Index neighbor = pool.neighbor(cell.idx, face);
+                        if (neighbor != CubePool::INVALID_INDEX &&
+                            pool.face_solid(neighbor, CubePool::opposite_face(face))) {
+                            continue;
+                        }
+                    }
+                    if (m_greedy_meshing) {
+                        const std::size_t u = (axis + 1) % 3;
+                        const std::size_t v = (axis + 2) % 3;
+                        const float plane = min[axis] + static_cast<float>(face % 2) * cell_size;
+                        planes[{face, plane}].push_back({min[u], min[u] + cell_size, min[v], min[v] + cell_size});
+                    } else {
+                        const std::array<Polygon, 2> face_polygons =
+                            CubePool::box_face_polygons(min, min + glm::vec3(cell_size), face);
+                        polygons.insert(polygons.end(), face_polygons.begin(), face_polygons.end());
+                    }
+                }
+            }
+        }
+    }
+    merge_faces(planes, polygons);
+    return polygons;
+}
+
+void OctreeMesher::collect_jobs(const std::uint32_t idx, const std::size_t level, const RegionKey key,
+                                const glm::vec3 &position, const float size, const bool force,
+                                std::vector<Job> &jobs) {
+    CubePool &pool = *m_root.pool();
+    if (!force && !pool.dirty(idx)) {
+        return;
+    }
+    const std::size_t shift = 3 * (m_region_level - level);
+    const RegionKey first = key << shift;
+
+    if (level < m_region_level && pool.type(idx) == Cube::Type::OCTANT) {
+        // The cube may have been a leaf region before.
+        if (const auto stale = m_regions.find(first); stale != m_regions.end() && stale->second.grid_level <= level) {
+            m_regions.erase(stale);
+        }
+        const float half_size = size / 2;
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            collect_jobs(pool.child(idx, child_id), level + 1, (key << 3U) | child_id,
+                         position + CubePool::child_offset(child_id, half_size), half_size, force, jobs);
+        }
+        pool.clear_dirty(idx);
+        return;
+    }
+
+    const RegionKey last = (key + 1) << shift;
+    m_regions.erase(m_regions.lower_bound(first), m_regions.lower_bound(last));
+    pool.clear_dirty(idx);
+    jobs.push_back({idx, {first, last, position, size}, {level, position, size, {}, {}}, {}});
+}
+
+std::vector<OctreeMesher::ChangedRegion> OctreeMesher::run_jobs(std::vector<Job> &jobs) {
+    // Storing a cache writes the pool, which may copy pages of the pool and must not happen in parallel. Therefore
+    // the workers only build the caches, which are stored before any faces are culled.
+    m_workers->parallel_for(jobs.size(), [&](const std::size_t i) {
+        build_polygon_caches(jobs[i].idx, jobs[i].range.position, jobs[i].range.size, jobs[i].polygon_caches);
+    });
+    const CubePool &pool = *m_root.pool();
+    for (auto &job : jobs) {
+        for (const auto &[idx, polygons] : job.polygon_caches) {
+            pool.set_polygon_cache(idx, polygons);
+        }
+        job.polygon_caches.clear();
+    }
+    m_workers->parallel_for(jobs.size(), [&](const std::size_t i) {
+        Job &job = jobs[i];
+        if (m_greedy_meshing) {
+            FacePlanes planes;
+            collect_visible_polygons(job.idx, job.range.position, job.range.size, job.region.polygons, &planes);
+            merge_faces(planes, job.region.polygons);
+        } else {
+            collect_visible_polygons(job.idx, job.range.position, job.range.size, job.region.polygons, nullptr);
+        }
+        for (std::size_t depth = 0; depth < m_lod_levels; depth++) {
+            auto lod = build_lod(job.idx, job.range.position, job.range.size, depth);
+            if (!lod) {
+                break;
+            }
+            job.region.lods.push_back(std::move(*lod));
+        }
+    });
+
+    std::vector<ChangedRegion> changed;
+    changed.reserve(jobs.size());
+    for (auto &job : jobs) {
+        if (!job.region.polygons.empty()) {
+            m_regions.emplace(job.range.first, std::move(job.region));
+        }
+        changed.push_back(job.range);
+    }
+    return changed;
+}
+
+void OctreeMesher::collect_visible_regions(const std::uint32_t idx, const std::size_t level, const RegionKey key,
+                                           const glm::vec3 &position, const float size,
+                                           const std::array<glm::vec4, 6> &frustum_planes, std::uint8_t plane_mask,
+                                           std::vector<RegionRange> &ranges) const {
+    const CubePool &pool = *m_root.pool();
+    if (pool.count_geometry_cubes(idx) == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < frustum_planes.size(); i++) {
+        if ((plane_mask & (1U << i)) == 0) {
+            continue;
+        }
+        const glm::vec4 &plane = frustum_planes[i];
+        // the corners which are the furthest inside and outside of the plane
+        glm::vec3 inner = position;
+        glm::vec3 outer = position;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            (plane[axis] >= 0.0F ? inner : outer)[axis] += size;
+        }
+        if (plane.x * inner.x + plane.y * inner.y + plane.z * inner.z + plane.w < 0.0F) {
+            return;
+        }
+        if (plane.x * outer.x + plane.y * outer.y + plane.z * outer.z + plane.w >= 0.0F) {
+            plane_mask &= ~(1U << i);
+        }
+    }
+
+    if (plane_mask != 0 && level < m_region_level && pool.type(idx) == Cube::Type::OCTANT) {
+        const float half_size = size / 2;
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            collect_visible_regions(pool.child(idx, child_id), level + 1, (key << 3U) | child_id,
+                                    position + CubePool::child_offset(child_id, half_size), half_size,
+                                    frustum_planes, plane_mask, ranges);
+        }
+        return;
+    }
+
+    const std::size_t shift = 3 * (m_region_level - level);
+    const RegionKey first = key << shift;
+    const RegionKey last = (key + 1) << shift;
+    if (!ranges.empty() && ranges.back().last == first) {
+        ranges.back().last = last;
+    } else {
+        ranges.push_back({first, last});
+    }
+}
+
+OctreeMesher::OctreeMesher(Cube root, const std::size_t region_level, const bool greedy_meshing,
+                           const std::size_t thread_count, const std::size_t lod_levels)
+    : m_root(std::move(root)), m_region_level(region_level), m_greedy_meshing(greedy_meshing),
+      m_workers(std::make_shared<WorkerPool>(thread_count)), m_lod_levels(lod_levels) {
+    assert(m_root.is_root());
+    assert(m_region_level <= MAX_REGION_LEVEL);
+    std::vector<Job> jobs;
+    collect_jobs(m_root.index(), 0, 0, m_root.position(), m_root.size(), true, jobs);
+    (void)run_jobs(jobs);
+}
+
+std::vector<OctreeMesher::ChangedRegion> OctreeMesher::update() {
+    std::vector<Job> jobs;
+    collect_jobs(m_root.index(), 0, 0, m_root.position(), m_root.size(), false, jobs);
+    return run_jobs(jobs);
+}
+
+std::vector<OctreeMesher::ChangedRegion> OctreeMesher::update(Cube root, const bool remesh_all) {
+    assert(root.is_root());
+    m_root = std::move(root);
+    std::vector<Job> jobs;
+    collect_jobs(m_root.index(), 0, 0, m_root.position(), m_root.size(), remesh_all, jobs);
+    return run_jobs(jobs);
+}
+
+const Cube &OctreeMesher::root() const noexcept {
+    return m_root;
+}
+
+std::size_t OctreeMesher::region_level() const noexcept {
+    return m_region_level;
+}
+
+bool OctreeMesher::greedy_meshing() const noexcept {
+    return m_greedy_meshing;
+}
+
+std::size_t OctreeMesher::thread_count() const noexcept {
+    return m_workers->thread_count();
+}
+
+const std::shared_ptr<WorkerPool> &OctreeMesher::workers() const noexcept {
+    return m_workers;
+}
+
+std::size_t OctreeMesher::lod_levels() const noexcept {
+    return m_lod_levels;
+}
+
+const std::map<OctreeMesher::RegionKey, OctreeMesher::Region> &OctreeMesher::regions() const noexcept {
+    return m_regions;
+}
+
+std::size_t OctreeMesher::polygon_count() const noexcept {
+    std::size_t count = 0;
+    for (const auto &[key, region] : m_regions) {
+        count += region.polygons.size();
+    }
+    return count;
+}
+
+std::vector<OctreeMesher::RegionRange>
+OctreeMesher::visible_regions(const std::array<glm::vec4, 6> &frustum_planes) const {
+    std::vector<RegionRange> ranges;
+    collect_visible_regions(m_root.index(), 0, 0, m_root.position(), m_root.size(), frustum_planes, 0b111111U, ranges);
+    return ranges;
+}
+
+const std::vector<Polygon> &OctreeMesher::select_lod(const Region &region, const glm::vec3 &camera_position,
+                                                     const float max_error) {
+    // distance from the camera to the closest point of the region
+    float squared_distance = 0.0F;
+    for (int axis = 0; axis < 3; axis++) {
+        const float offset = std::max({region.position[axis] - camera_position[axis], 0.0F,
+                                       camera_position[axis] - region.position[axis] - region.size});
+        squared_distance += offset * offset;
+    }
+    const float max_cube_size = max_error * std::sqrt(squared_distance);
+    // the replacement cubes at depth d have the size region.size / 2^d
+    float cube_size = region.size;
+    for (const auto &lod : region.lods) {
+        if (cube_size <= max_cube_size) {
+            return lod;
+        }
+        cube_size /= 2;
+    }
+    return region.polygons;
+}
+} // namespace inexor::vulkan_renderer::world
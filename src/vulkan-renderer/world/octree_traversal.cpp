@@ -0,0 +1,110 @@
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <cassert>
+
+namespace inexor::vulkan_renderer::world {
+
+PreOrderIterator::PreOrderIterator(const CubePool &pool, const CubePool::Index idx, const glm::vec3 &position,
+                                   const float size) noexcept
+    : m_pool(&pool), m_node{idx, 0, position, size} {}
+
+PreOrderIterator::reference PreOrderIterator::operator*() const noexcept {
+    return m_node;
+}
+
+PreOrderIterator::pointer PreOrderIterator::operator->() const noexcept {
+    return &m_node;
+}
+
+PreOrderIterator &PreOrderIterator::operator++() {
+    assert(m_node.index != CubePool::INVALID_INDEX);
+    if (!m_skip_children && m_pool->type(m_node.index) == Cube::Type::OCTANT) {
+        m_stack.push({m_pool->child(m_node.index, 0), 0, m_node.position, m_node.size / 2});
+    }
+    m_skip_children = false;
+    while (m_stack.size() > 0) {
+        Frame &frame = m_stack.top();
+        if (frame.next_child < Cube::SUB_CUBES) {
+            const std::size_t child_id = frame.next_child++;
+            m_node = {frame.first_child + static_cast<CubePool::Index>(child_id), m_stack.size(),
+                      frame.position + CubePool::child_offset(child_id, frame.child_size), frame.child_size};
+            return *this;
+        }
+        m_stack.pop();
+    }
+    m_node.index = CubePool::INVALID_INDEX;
+    return *this;
+}
+
+bool PreOrderIterator::operator==(const PreOrderIterator &rhs) const noexcept {
+    return m_node.index == rhs.m_node.index;
+}
+
+bool PreOrderIterator::operator!=(const PreOrderIterator &rhs) const noexcept {
+    return !(*this == rhs);
+}
+
+void PreOrderIterator::skip_children() noexcept {
+    m_skip_children = true;
+}
+
+PostOrderIterator::PostOrderIterator(const CubePool &pool, const CubePool::Index idx, const glm::vec3 &position,
+                                     const float size)
+    : m_pool(&pool) {
+    descend({idx, 0, position, size});
+}
+
+void PostOrderIterator::descend(TraversalNode node) {
+    while (m_pool->type(node.index) == Cube::Type::OCTANT) {
+        m_stack.push({node, 1});
+        const float child_size = node.size / 2;
+        node = {m_pool->child(node.index, 0), node.depth + 1, node.position + CubePool::child_offset(0, child_size),
+                child_size};
+    }
+    m_node = node;
+}
+
+PostOrderIterator::reference PostOrderIterator::operator*() const noexcept {
+    return m_node;
+}
+
+PostOrderIterator::pointer PostOrderIterator::operator->() const noexcept {
+    return &m_node;
+}
+
+PostOrderIterator &PostOrderIterator::operator++() {
+    assert(m_node.index != CubePool::INVALID_INDEX);
+    if (m_stack.size() == 0) {
+        m_node.index = CubePool::INVALID_INDEX;
+        return *this;
+    }
+    Frame &frame = m_stack.top();
+    if (frame.next_child < Cube::SUB_CUBES) {
+        const std::size_t child_id = frame.next_child++;
+        const float child_size = frame.octant.size / 2;
+        descend({m_pool->child(frame.octant.index, child_id), frame.octant.depth + 1,
+                 frame.octant.position + CubePool::child_offset(child_id, child_size), child_size});
+        return *this;
+    }
+    m_node = frame.octant;
+    m_stack.pop();
+    return *this;
+}
+
+bool PostOrderIterator::operator==(const PostOrderIterator &rhs) const noexcept {
+    return m_node.index == rhs.m_node.index;
+}
+
+bool PostOrderIterator::operator!=(const PostOrderIterator &rhs) const noexcept {
+    return !(*this == rhs);
+}
+
+TraversalRange<PreOrderIterator> pre_order(const CubePool &pool, const CubePool::Index idx) {
+    return TraversalRange<PreOrderIterator>(PreOrderIterator(pool, idx, pool.position(idx), pool.size(idx)));
+}
+
+TraversalRange<PostOrderIterator> post_order(const CubePool &pool, const CubePool::Index idx) {
+    return TraversalRange<PostOrderIterator>(PostOrderIterator(pool, idx, pool.position(idx), pool.size(idx)));
+}
+
+} // namespace inexor::vulkan_renderer::world
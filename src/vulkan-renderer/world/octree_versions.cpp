@@ -0,0 +1,52 @@
+#include "inexor/vulkan-renderer/world/octree_versions.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+OctreeVersions::OctreeVersions(Cube root) : m_root(std::move(root)) {
+    assert(m_root.is_root());
+    (void)publish();
+}
+
+const Cube &OctreeVersions::root() const noexcept {
+    return m_root;
+}
+
+std::uint64_t OctreeVersions::publish() {
+    const auto previous = std::atomic_load(&m_published);
+    const std::uint64_t number = previous ? previous->number + 1 : 1;
+    // copies the page tables only
+    std::shared_ptr<const Snapshot> snapshot = std::make_shared<Snapshot>(Snapshot{number, *m_root.pool()});
+    m_root.pool()->clear_dirty(CubePool::ROOT_INDEX);
+    std::atomic_store(&m_published, std::move(snapshot));
+
+    if (previous) {
+        std::scoped_lock lock(m_retired_mutex);
+        m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(),
+                                       [](const auto &retired) { return retired.expired(); }),
+                        m_retired.end());
+        m_retired.push_back(previous);
+    }
+    return number;
+}
+
+OctreeVersions::Version OctreeVersions::acquire() const {
+    auto snapshot = std::atomic_load(&m_published);
+    Cube root(std::make_shared<CubePool>(snapshot->pool), CubePool::ROOT_INDEX);
+    return {snapshot->number, std::move(root), std::move(snapshot)};
+}
+
+std::uint64_t OctreeVersions::version() const {
+    return std::atomic_load(&m_published)->number;
+}
+
+std::size_t OctreeVersions::retired_versions() const {
+    std::scoped_lock lock(m_retired_mutex);
+    return static_cast<std::size_t>(
+        std::count_if(m_retired.begin(), m_retired.end(), [](const auto &retired) { return !retired.expired(); }));
+}
+
+} // namespace inexor::vulkan_renderer::world
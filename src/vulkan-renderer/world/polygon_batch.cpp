@@ -0,0 +1,201 @@
+#include "inexor/vulkan-renderer/world/polygon_batch.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <tuple>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// The edge which indents each axis of a corner. An axis is indented by the start of the edge if the corner is at the
+/// minimum of the axis and by the end if it is at the maximum, which is the bit of the axis in the corner id.
+constexpr std::array<std::array<std::uint8_t, 3>, PolygonBatch::CORNERS> CORNER_EDGES{
+    {{0, 1, 2}, {9, 4, 2}, {3, 1, 11}, {6, 4, 11}, {0, 10, 5}, {9, 7, 5}, {3, 10, 8}, {6, 7, 8}}};
+
+/// A face uses the other diagonal if the indentations of the first two edges are smaller than the ones of the last two.
+/// Faces at the minimum of an axis compare the starts of the edges, faces at the maximum the ends.
+constexpr std::array<std::array<std::uint8_t, 4>, 3> DIAGONAL_EDGES{{{0, 6, 9, 3}, {1, 7, 4, 10}, {2, 8, 11, 5}}};
+
+using Triangle = std::array<std::uint8_t, 3>;
+using FaceTriangles = std::array<Triangle, 2>;
+
+/// The triangles of each face with the default and with the other diagonal.
+constexpr std::array<std::array<FaceTriangles, 2>, 6> FACE_TRIANGLES{{
+    {{{{{0, 2, 1}, {1, 2, 3}}}, {{{0, 2, 3}, {0, 3, 1}}}}}, // x = 0
+    {{{{{4, 5, 6}, {5, 7, 6}}}, {{{4, 7, 6}, {4, 5, 7}}}}}, // x = 1
+    {{{{{0, 1, 4}, {1, 5, 4}}}, {{{0, 1, 5}, {0, 5, 4}}}}}, // y = 0
+    {{{{{2, 6, 3}, {3, 6, 7}}}, {{{2, 7, 3}, {2, 6, 7}}}}}, // y = 1
+    {{{{{0, 4, 2}, {2, 4, 6}}}, {{{0, 4, 6}, {0, 6, 2}}}}}, // z = 0
+    {{{{{1, 3, 5}, {3, 7, 5}}}, {{{1, 3, 7}, {1, 7, 5}}}}}  // z = 1
+}};
+
+constexpr std::size_t POLYGONS{std::tuple_size_v<CubePolygons>};
+static_assert(POLYGONS == 2 * FACE_TRIANGLES.size());
+
+constexpr std::array<std::array<Triangle, POLYGONS>, 64> make_polygon_table() {
+    std::array<std::array<Triangle, POLYGONS>, 64> table{};
+    for (std::size_t mask = 0; mask < table.size(); mask++) {
+        for (std::size_t face = 0; face < FACE_TRIANGLES.size(); face++) {
+            const FaceTriangles &triangles = FACE_TRIANGLES[face][(mask >> face) & 1U];
+            table[mask][2 * face] = triangles[0];
+            table[mask][2 * face + 1] = triangles[1];
+        }
+    }
+    return table;
+}
+
+/// Corner ids of the triangles for every diagonal mask.
+constexpr std::array<std::array<Triangle, POLYGONS>, 64> POLYGON_TABLE = make_polygon_table();
+
+#if defined(__SSE2__)
+/// Load four bytes as four 32 bit integers.
+__m128i load_bytes(const std::uint8_t *bytes) {
+    std::int32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+}
+#endif
+
+} // namespace
+
+void PolygonBatch::add(const Cube::Type type, const glm::vec3 &position, const float size,
+                       const std::array<Indentation, Cube::EDGES> &ind) {
+    assert(type == Cube::Type::SOLID || type == Cube::Type::NORMAL);
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        m_positions[axis].push_back(position[static_cast<int>(axis)]);
+    }
+    m_sizes.push_back(size);
+    // the indentations of solid cubes are unused
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        m_starts[edge].push_back(type == Cube::Type::NORMAL ? ind[edge].start() : 0);
+        m_ends[edge].push_back(type == Cube::Type::NORMAL ? ind[edge].end() : 0);
+    }
+}
+
+std::size_t PolygonBatch::size() const noexcept {
+    return m_sizes.size();
+}
+
+void PolygonBatch::clear() noexcept {
+    for (auto &positions : m_positions) {
+        positions.clear();
+    }
+    m_sizes.clear();
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        m_starts[edge].clear();
+        m_ends[edge].clear();
+    }
+    m_corners.clear();
+    m_diagonals.clear();
+}
+
+std::size_t PolygonBatch::corner_offset(const std::size_t cube, const std::size_t corner,
+                                        const std::size_t axis) noexcept {
+    return (cube / 4 * 3 * CORNERS + 3 * corner + axis) * 4 + cube % 4;
+}
+
+void PolygonBatch::build_scalar(const std::size_t cube) {
+    const float size = m_sizes[cube];
+    const float step = size / Indentation::MAX;
+    for (std::size_t corner = 0; corner < CORNERS; corner++) {
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            const std::uint8_t edge = CORNER_EDGES[corner][axis];
+            const float position = m_positions[axis][cube];
+            m_corners[corner_offset(cube, corner, axis)] = ((corner >> (2 - axis)) & 1U) != 0
+                                                               ? (position + size) - m_ends[edge][cube] * step
+                                                               : position + m_starts[edge][cube] * step;
+        }
+    }
+    std::uint8_t diagonals = 0;
+    for (std::size_t face = 0; face < 6; face++) {
+        const auto &ind = (face & 1U) != 0 ? m_ends : m_starts;
+        const auto &edges = DIAGONAL_EDGES[face / 2];
+        if (ind[edges[0]][cube] + ind[edges[1]][cube] < ind[edges[2]][cube] + ind[edges[3]][cube]) {
+            diagonals |= 1U << face;
+        }
+    }
+    m_diagonals[cube] = diagonals;
+}
+
+#if defined(__SSE2__)
+void PolygonBatch::build_sse2(const std::size_t first, const std::size_t last) {
+    for (std::size_t cube = first; cube < last; cube += 4) {
+        const __m128 size = _mm_loadu_ps(&m_sizes[cube]);
+        const __m128 step = _mm_div_ps(size, _mm_set1_ps(Indentation::MAX));
+        __m128 min[3];
+        __m128 max[3];
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            min[axis] = _mm_loadu_ps(&m_positions[axis][cube]);
+            max[axis] = _mm_add_ps(min[axis], size);
+        }
+        for (std::size_t corner = 0; corner < CORNERS; corner++) {
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                const std::uint8_t edge = CORNER_EDGES[corner][axis];
+                __m128 coordinate;
+                if (((corner >> (2 - axis)) & 1U) != 0) {
+                    const __m128 ends = _mm_cvtepi32_ps(load_bytes(&m_ends[edge][cube]));
+                    coordinate = _mm_sub_ps(max[axis], _mm_mul_ps(ends, step));
+                } else {
+                    const __m128 starts = _mm_cvtepi32_ps(load_bytes(&m_starts[edge][cube]));
+                    coordinate = _mm_add_ps(min[axis], _mm_mul_ps(starts, step));
+                }
+                _mm_storeu_ps(&m_corners[corner_offset(cube, corner, axis)], coordinate);
+            }
+        }
+        std::array<std::uint8_t, 4> diagonals{};
+        for (std::size_t face = 0; face < 6; face++) {
+            const auto &ind = (face & 1U) != 0 ? m_ends : m_starts;
+            const auto &edges = DIAGONAL_EDGES[face / 2];
+            const __m128i lhs = _mm_add_epi32(load_bytes(&ind[edges[0]][cube]), load_bytes(&ind[edges[1]][cube]));
+            const __m128i rhs = _mm_add_epi32(load_bytes(&ind[edges[2]][cube]), load_bytes(&ind[edges[3]][cube]));
+            const int lanes = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(lhs, rhs)));
+            for (std::size_t lane = 0; lane < 4; lane++) {
+                diagonals[lane] |= ((lanes >> lane) & 1) << face;
+            }
+        }
+        std::memcpy(&m_diagonals[cube], diagonals.data(), diagonals.size());
+    }
+}
+#endif
+
+void PolygonBatch::build() {
+    const std::size_t count = size();
+    m_corners.resize((count + 3) / 4 * 4 * 3 * CORNERS);
+    m_diagonals.resize(count);
+    std::size_t first = 0;
+#if defined(__SSE2__)
+    first = count - count % 4;
+    build_sse2(0, first);
+#endif
+    for (std::size_t cube = first; cube < count; cube++) {
+        build_scalar(cube);
+    }
+}
+
+std::array<glm::vec3, PolygonBatch::CORNERS> PolygonBatch::vertices(const std::size_t cube) const noexcept {
+    assert(cube < m_diagonals.size());
+    std::array<glm::vec3, CORNERS> vertices;
+    for (std::size_t corner = 0; corner < CORNERS; corner++) {
+        vertices[corner] = {m_corners[corner_offset(cube, corner, 0)], m_corners[corner_offset(cube, corner, 1)],
+                            m_corners[corner_offset(cube, corner, 2)]};
+    }
+    return vertices;
+}
+
+CubePolygons PolygonBatch::polygons(const std::size_t cube) const noexcept {
+    const std::array<glm::vec3, CORNERS> v = vertices(cube);
+    const auto &triangles = POLYGON_TABLE[m_diagonals[cube]];
+    CubePolygons polygons;
+    for (std::size_t polygon = 0; polygon < POLYGONS; polygon++) {
+        polygons[polygon] = {{v[triangles[polygon][0]], v[triangles[polygon][1]], v[triangles[polygon][2]]}};
+    }
+    return polygons;
+}
+
+} // namespace inexor::vulkan_renderer::world
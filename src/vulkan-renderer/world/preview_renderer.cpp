@@ -0,0 +1,397 @@
+#include "inexor/vulkan-renderer/world/preview_renderer.hpp"
+
+#include "inexor/vulkan-renderer/camera.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <xmmintrin.h>
+#endif
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Rays per packet.
+constexpr std::size_t LANES{4};
+/// Width and height of a packet in pixels.
+constexpr std::uint32_t PACKET_SIZE{2};
+/// Brightness of faces which do not face the light.
+constexpr float AMBIENT_LIGHT{0.35F};
+
+/// Rays with a common origin.
+struct RayPacket {
+    glm::vec3 origin;
+    alignas(16) std::array<std::array<float, LANES>, 3> directions;
+    alignas(16) std::array<std::array<float, LANES>, 3> inverse_directions;
+    float max_distance;
+
+    [[nodiscard]] glm::vec3 direction(const std::size_t lane) const noexcept {
+        return {directions[0][lane], directions[1][lane], directions[2][lane]};
+    }
+};
+
+/// The closest hit of every ray of a packet.
+struct PacketHits {
+    alignas(16) std::array<float, LANES> distances;
+    std::array<glm::vec3, LANES> normals;
+};
+
+/// The children of an octant are visited in the order child_id ^ mask. Rays with the same mask enter the children in
+/// this order, because a ray can only pass from a child to another one whose coordinates are not smaller along the
+/// direction of the ray.
+std::size_t child_order_mask(const glm::vec3 &direction) noexcept {
+    return (direction.x < 0.0F ? 0b100U : 0U) | (direction.y < 0.0F ? 0b010U : 0U) |
+           (direction.z < 0.0F ? 0b001U : 0U);
+}
+
+/// Normal of the face of an axis aligned cube through which a ray enters it.
+glm::vec3 box_normal(const RayPacket &packet, const std::size_t lane, const glm::vec3 &position, const float size) {
+    std::size_t enter_axis = 0;
+    float enter = -std::numeric_limits<float>::infinity();
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        const float plane = packet.directions[axis][lane] < 0.0F ? position[axis] + size : position[axis];
+        const float distance = (plane - packet.origin[axis]) * packet.inverse_directions[axis][lane];
+        if (distance > enter) {
+            enter = distance;
+            enter_axis = axis;
+        }
+    }
+    glm::vec3 normal{0.0F};
+    normal[enter_axis] = packet.directions[enter_axis][lane] < 0.0F ? 1.0F : -1.0F;
+    return normal;
+}
+
+#if defined(__SSE2__)
+/// Intersect the rays with an axis aligned cube.
+/// @param enters The distance at which each ray enters the cube, 0 if it starts inside.
+/// @return The active rays which intersect the cube before their maximum distance.
+unsigned intersect_box(const RayPacket &packet, const unsigned active, const glm::vec3 &position, const float size,
+                       std::array<float, LANES> &enters) {
+    __m128 enter = _mm_setzero_ps();
+    __m128 exit = _mm_set1_ps(packet.max_distance);
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        const __m128 inverse_direction = _mm_load_ps(packet.inverse_directions[axis].data());
+        const __m128 near = _mm_mul_ps(_mm_set1_ps(position[axis] - packet.origin[axis]), inverse_direction);
+        const __m128 far = _mm_mul_ps(_mm_set1_ps(position[axis] + size - packet.origin[axis]), inverse_direction);
+        enter = _mm_max_ps(enter, _mm_min_ps(near, far));
+        exit = _mm_min_ps(exit, _mm_max_ps(near, far));
+    }
+    _mm_store_ps(enters.data(), enter);
+    return active & static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(enter, exit)));
+}
+
+/// Möller-Trumbore intersection of the rays with a polygon, culling neither side. The parts which only depend on the
+/// common origin are computed once for all rays.
+/// @param distances The closest distances so far, which are updated.
+/// @return The active rays which hit the polygon closer than before.
+unsigned intersect_polygon(const RayPacket &packet, const unsigned active, const Polygon &polygon,
+                           std::array<float, LANES> &distances) {
+    constexpr float EPSILON{1e-7F};
+    const glm::vec3 edge1 = polygon[1] - polygon[0];
+    const glm::vec3 edge2 = polygon[2] - polygon[0];
+    const glm::vec3 s = packet.origin - polygon[0];
+    const glm::vec3 q = glm::cross(s, edge1);
+
+    const __m128 x = _mm_load_ps(packet.directions[0].data());
+    const __m128 y = _mm_load_ps(packet.directions[1].data());
+    const __m128 z = _mm_load_ps(packet.directions[2].data());
+    // p = cross(direction, edge2)
+    const __m128 px = _mm_sub_ps(_mm_mul_ps(y, _mm_set1_ps(edge2.z)), _mm_mul_ps(z, _mm_set1_ps(edge2.y)));
+    const __m128 py = _mm_sub_ps(_mm_mul_ps(z, _mm_set1_ps(edge2.x)), _mm_mul_ps(x, _mm_set1_ps(edge2.z)));
+    const __m128 pz = _mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(edge2.y)), _mm_mul_ps(y, _mm_set1_ps(edge2.x)));
+    const auto dot = [&](const glm::vec3 &vector) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(vector.x)), _mm_mul_ps(py, _mm_set1_ps(vector.y))),
+                          _mm_mul_ps(pz, _mm_set1_ps(vector.z)));
+    };
+    const __m128 determinant = dot(edge1);
+    const __m128 inverse_determinant = _mm_div_ps(_mm_set1_ps(1.0F), determinant);
+    const __m128 u = _mm_mul_ps(dot(s), inverse_determinant);
+    const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(q.x)), _mm_mul_ps(y, _mm_set1_ps(q.y))),
+                                           _mm_mul_ps(z, _mm_set1_ps(q.z))),
+                                inverse_determinant);
+    const __m128 t = _mm_mul_ps(_mm_set1_ps(glm::dot(edge2, q)), inverse_determinant);
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 closest = _mm_load_ps(distances.data());
+    const __m128 hit = _mm_and_ps(
+        _mm_and_ps(_mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0F), determinant), _mm_set1_ps(EPSILON)),
+                   _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one))),
+        _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)),
+                   _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmplt_ps(t, closest))));
+    const unsigned hits = active & static_cast<unsigned>(_mm_movemask_ps(hit));
+    alignas(16) std::array<float, LANES> hit_distances;
+    _mm_store_ps(hit_distances.data(), t);
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+        if ((hits & (1U << lane)) != 0) {
+            distances[lane] = hit_distances[lane];
+        }
+    }
+    return hits;
+}
+#else
+/// Intersect the rays with an axis aligned cube.
+/// @param enters The distance at which each ray enters the cube, 0 if it starts inside.
+/// @return The active rays which intersect the cube before their maximum distance.
+unsigned intersect_box(const RayPacket &packet, const unsigned active, const glm::vec3 &position, const float size,
+                       std::array<float, LANES> &enters) {
+    unsigned hits = 0;
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+        float enter = 0.0F;
+        float exit = packet.max_distance;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            const float near = (position[axis] - packet.origin[axis]) * packet.inverse_directions[axis][lane];
+            const float far = (position[axis] + size - packet.origin[axis]) * packet.inverse_directions[axis][lane];
+            enter = std::max(enter, std::min(near, far));
+            exit = std::min(exit, std::max(near, far));
+        }
+        enters[lane] = enter;
+        hits |= enter <= exit ? 1U << lane : 0U;
+    }
+    return active & hits;
+}
+
+/// Möller-Trumbore intersection of the rays with a polygon, culling neither side.
+/// @param distances The closest distances so far, which are updated.
+/// @return The active rays which hit the polygon closer than before.
+unsigned intersect_polygon(const RayPacket &packet, const unsigned active, const Polygon &polygon,
+                           std::array<float, LANES> &distances) {
+    constexpr float EPSILON{1e-7F};
+    const glm::vec3 edge1 = polygon[1] - polygon[0];
+    const glm::vec3 edge2 = polygon[2] - polygon[0];
+    const glm::vec3 s = packet.origin - polygon[0];
+    const glm::vec3 q = glm::cross(s, edge1);
+    unsigned hits = 0;
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+        if ((active & (1U << lane)) == 0) {
+            continue;
+        }
+        const glm::vec3 direction = packet.direction(lane);
+        const glm::vec3 p = glm::cross(direction, edge2);
+        const float determinant = glm::dot(edge1, p);
+        if (std::abs(determinant) < EPSILON) {
+            continue;
+        }
+        const float u = glm::dot(s, p) / determinant;
+        const float v = glm::dot(direction, q) / determinant;
+        const float t = glm::dot(edge2, q) / determinant;
+        if (u >= 0.0F && u <= 1.0F && v >= 0.0F && u + v <= 1.0F && t >= 0.0F && t < distances[lane]) {
+            distances[lane] = t;
+            hits |= 1U << lane;
+        }
+    }
+    return hits;
+}
+#endif
+
+/// Cast the active rays into a cube which they intersect.
+/// @param enters The distances at which the rays enter the cube.
+/// @return The active rays which hit geometry in the cube.
+unsigned cast_packet(const CubePool &pool, const CubePool::Index idx, const RayPacket &packet, const unsigned active,
+                     const std::size_t order_mask, const glm::vec3 &position, const float size,
+                     const std::array<float, LANES> &enters, PacketHits &hits) {
+    switch (pool.type(idx)) {
+    case Cube::Type::EMPTY:
+        return 0;
+    case Cube::Type::SOLID:
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            if ((active & (1U << lane)) != 0) {
+                hits.distances[lane] = enters[lane];
+                hits.normals[lane] = box_normal(packet, lane, position, size);
+            }
+        }
+        return active;
+    case Cube::Type::NORMAL: {
+        // Do not update the cache, rendering must not modify the octree.
+        CubePolygons built_polygons;
+        PolygonSpan polygons = pool.polygon_cache(idx);
+        if (polygons.empty()) {
+            built_polygons = CubePool::build_polygons(Cube::Type::NORMAL, position, size, pool.indentations(idx));
+            polygons = {built_polygons.data(), built_polygons.size()};
+        }
+        alignas(16) std::array<float, LANES> distances;
+        distances.fill(packet.max_distance);
+        std::array<std::size_t, LANES> closest_polygons{};
+        unsigned hit = 0;
+        for (std::size_t polygon = 0; polygon < polygons.size(); polygon++) {
+            const unsigned closer = intersect_polygon(packet, active, polygons[polygon], distances);
+            for (std::size_t lane = 0; lane < LANES; lane++) {
+                if ((closer & (1U << lane)) != 0) {
+                    closest_polygons[lane] = polygon;
+                }
+            }
+            hit |= closer;
+        }
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            if ((hit & (1U << lane)) == 0) {
+                continue;
+            }
+            const Polygon &polygon = polygons[closest_polygons[lane]];
+            const glm::vec3 normal = glm::normalize(glm::cross(polygon[1] - polygon[0], polygon[2] - polygon[0]));
+            hits.distances[lane] = distances[lane];
+            // towards the camera
+            hits.normals[lane] = glm::dot(normal, packet.direction(lane)) > 0.0F ? -normal : normal;
+        }
+        return hit;
+    }
+    case Cube::Type::OCTANT:
+        break;
+    }
+
+    unsigned remaining = active;
+    const float half_size = size / 2;
+    for (std::size_t order = 0; order < Cube::SUB_CUBES && remaining != 0; order++) {
+        const std::size_t child_id = order ^ order_mask;
+        const CubePool::Index child = pool.child(idx, child_id);
+        if (pool.count_geometry_cubes(child) == 0) {
+            continue;
+        }
+        const glm::vec3 child_position = position + CubePool::child_offset(child_id, half_size);
+        alignas(16) std::array<float, LANES> child_enters;
+        if (const unsigned entering = intersect_box(packet, remaining, child_position, half_size, child_enters)) {
+            remaining &= ~cast_packet(pool, child, packet, entering, order_mask, child_position, half_size,
+                                      child_enters, hits);
+        }
+    }
+    return active & ~remaining;
+}
+
+std::uint8_t to_byte(const float value) {
+    return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0F, 1.0F) * 255.0F));
+}
+
+} // namespace
+
+PreviewRenderer::PreviewRenderer(const std::size_t thread_count)
+    : PreviewRenderer(std::make_shared<WorkerPool>(thread_count)) {}
+
+PreviewRenderer::PreviewRenderer(std::shared_ptr<WorkerPool> workers) : m_workers(std::move(workers)) {}
+
+void PreviewRenderer::set_light_direction(const glm::vec3 &direction) {
+    assert(glm::dot(direction, direction) > 0.0F);
+    m_light_direction = direction;
+}
+
+void PreviewRenderer::set_geometry_color(const glm::vec3 &color) {
+    m_geometry_color = color;
+}
+
+void PreviewRenderer::set_background_color(const glm::vec3 &color) {
+    m_background_color = color;
+}
+
+PreviewImage PreviewRenderer::render(const Cube &cube, const Camera &camera, const std::uint32_t width,
+                                     const std::uint32_t height) const {
+    PreviewImage image{width, height, std::vector<std::uint8_t>(std::size_t{4} * width * height)};
+    if (width == 0 || height == 0) {
+        return image;
+    }
+    const CubePool &pool = *cube.pool();
+    const glm::vec3 cube_position = cube.position();
+    const float cube_size = cube.size();
+    const glm::vec3 light_direction = glm::normalize(m_light_direction);
+
+    // a pinhole camera like the perspective matrix of the camera
+    const glm::vec3 front = glm::normalize(camera.front());
+    const glm::vec3 right = glm::normalize(glm::cross(front, camera.up()));
+    const glm::vec3 up = glm::cross(right, front);
+    const float screen_height = std::tan(glm::radians(camera.fov()) / 2.0F);
+    const float screen_width = screen_height * static_cast<float>(width) / static_cast<float>(height);
+
+    const std::uint32_t tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const std::uint32_t tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    m_workers->parallel_for(std::size_t{tiles_x} * tiles_y, [&](const std::size_t tile) {
+        const std::uint32_t tile_x = static_cast<std::uint32_t>(tile % tiles_x) * TILE_SIZE;
+        const std::uint32_t tile_y = static_cast<std::uint32_t>(tile / tiles_x) * TILE_SIZE;
+        const std::uint32_t tile_width = std::min(TILE_SIZE, width - tile_x);
+        const std::uint32_t tile_height = std::min(TILE_SIZE, height - tile_y);
+        for (std::uint32_t packet_y = 0; packet_y < tile_height; packet_y += PACKET_SIZE) {
+            for (std::uint32_t packet_x = 0; packet_x < tile_width; packet_x += PACKET_SIZE) {
+                RayPacket packet{camera.position(), {}, {}, camera.far_plane()};
+                std::array<std::size_t, LANES> order_masks{};
+                unsigned valid = 0;
+                for (std::size_t lane = 0; lane < LANES; lane++) {
+                    const std::uint32_t x = tile_x + packet_x + static_cast<std::uint32_t>(lane % PACKET_SIZE);
+                    const std::uint32_t y = tile_y + packet_y + static_cast<std::uint32_t>(lane / PACKET_SIZE);
+                    if (x >= tile_x + tile_width || y >= tile_y + tile_height) {
+                        // lanes outside of the image keep a valid direction
+                        for (std::size_t axis = 0; axis < 3; axis++) {
+                            packet.directions[axis][lane] = 1.0F;
+                            packet.inverse_directions[axis][lane] = 1.0F;
+                        }
+                        continue;
+                    }
+                    valid |= 1U << lane;
+                    const float screen_x = (2.0F * (static_cast<float>(x) + 0.5F) / static_cast<float>(width) - 1.0F);
+                    const float screen_y = (1.0F - 2.0F * (static_cast<float>(y) + 0.5F) / static_cast<float>(height));
+                    glm::vec3 direction =
+                        glm::normalize(front + right * (screen_x * screen_width) + up * (screen_y * screen_height));
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        // Rays parallel to an axis would multiply infinity by zero in the box test.
+                        constexpr float MIN_COMPONENT{1e-12F};
+                        if (std::abs(direction[axis]) < MIN_COMPONENT) {
+                            direction[axis] = std::signbit(direction[axis]) ? -MIN_COMPONENT : MIN_COMPONENT;
+                        }
+                        packet.directions[axis][lane] = direction[axis];
+                        packet.inverse_directions[axis][lane] = 1.0F / direction[axis];
+                    }
+                    order_masks[lane] = child_order_mask(direction);
+                }
+
+                PacketHits hits{};
+                unsigned hit = 0;
+                // rays which enter the children in different orders are traversed separately
+                for (unsigned remaining = valid; remaining != 0;) {
+                    std::size_t first = 0;
+                    while ((remaining & (1U << first)) == 0) {
+                        first++;
+                    }
+                    unsigned active = 0;
+                    for (std::size_t lane = first; lane < LANES; lane++) {
+                        if ((remaining & (1U << lane)) != 0 && order_masks[lane] == order_masks[first]) {
+                            active |= 1U << lane;
+                        }
+                    }
+                    remaining &= ~active;
+                    alignas(16) std::array<float, LANES> enters;
+                    if (const unsigned entering = intersect_box(packet, active, cube_position, cube_size, enters)) {
+                        hit |= cast_packet(pool, cube.index(), packet, entering, order_masks[first], cube_position,
+                                           cube_size, enters, hits);
+                    }
+                }
+
+                for (std::size_t lane = 0; lane < LANES; lane++) {
+                    if ((valid & (1U << lane)) == 0) {
+                        continue;
+                    }
+                    glm::vec3 color = m_background_color;
+                    if ((hit & (1U << lane)) != 0) {
+                        const float diffuse = std::max(glm::dot(hits.normals[lane], light_direction), 0.0F);
+                        const float light = AMBIENT_LIGHT + (1.0F - AMBIENT_LIGHT) * diffuse;
+                        const float fog = std::clamp(hits.distances[lane] / packet.max_distance, 0.0F, 1.0F);
+                        color = m_geometry_color * light * (1.0F - fog) + m_background_color * fog;
+                    }
+                    const std::uint32_t x = tile_x + packet_x + static_cast<std::uint32_t>(lane % PACKET_SIZE);
+                    const std::uint32_t y = tile_y + packet_y + static_cast<std::uint32_t>(lane / PACKET_SIZE);
+                    std::uint8_t *pixel = &image.pixels[4 * (std::size_t{y} * width + x)];
+                    for (std::size_t channel = 0; channel < 3; channel++) {
+                        pixel[channel] = to_byte(color[channel]);
+                    }
+                    pixel[3] = 255;
+                }
+            }
+        }
+    });
+    return image;
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,134 @@
+#include "inexor/vulkan-renderer/world/range_query.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+/// Convex polygon while clipping a triangle, every clipping plane adds at most one corner.
+struct ClipPolygon {
+    std::array<glm::vec3, 9> corners;
+    std::size_t size;
+};
+
+/// Clip the polygon to the half space in which the coordinate on the axis is at least (or at most) the bound.
+void clip(const ClipPolygon &polygon, const std::size_t axis, const float bound, const bool keep_greater,
+          ClipPolygon &clipped) {
+    const auto inside = [&](const glm::vec3 &corner) {
+        return keep_greater ? corner[axis] >= bound : corner[axis] <= bound;
+    };
+    clipped.size = 0;
+    for (std::size_t i = 0; i < polygon.size; i++) {
+        const glm::vec3 &current = polygon.corners[i];
+        const glm::vec3 &next = polygon.corners[(i + 1) % polygon.size];
+        if (inside(current)) {
+            clipped.corners[clipped.size++] = current;
+        }
+        if (inside(current) != inside(next)) {
+            const float t = (bound - current[axis]) / (next[axis] - current[axis]);
+            glm::vec3 corner = current + (next - current) * t;
+            // exactly on the plane, despite rounding
+            corner[axis] = bound;
+            clipped.corners[clipped.size++] = corner;
+        }
+    }
+}
+
+/// Closest point of the triangle to the point, from Real-Time Collision Detection by Christer Ericson.
+glm::vec3 closest_point(const Polygon &triangle, const glm::vec3 &point) {
+    const glm::vec3 &a = triangle[0];
+    const glm::vec3 &b = triangle[1];
+    const glm::vec3 &c = triangle[2];
+    const glm::vec3 ab = b - a;
+    const glm::vec3 ac = c - a;
+    const glm::vec3 ap = point - a;
+    const float d1 = glm::dot(ab, ap);
+    const float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0F && d2 <= 0.0F) {
+        return a;
+    }
+    const glm::vec3 bp = point - b;
+    const float d3 = glm::dot(ab, bp);
+    const float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0F && d4 <= d3) {
+        return b;
+    }
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0F && d1 >= 0.0F && d3 <= 0.0F) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+    const glm::vec3 cp = point - c;
+    const float d5 = glm::dot(ab, cp);
+    const float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0F && d5 <= d6) {
+        return c;
+    }
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0F && d2 >= 0.0F && d6 <= 0.0F) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0F && d4 - d3 >= 0.0F && d5 - d6 >= 0.0F) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+    const float denominator = 1.0F / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+} // namespace
+
+bool intersects(const Box &box, const glm::vec3 &position, const float size) noexcept {
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (box.max[axis] < position[axis] || box.min[axis] > position[axis] + size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool intersects(const Sphere &sphere, const glm::vec3 &position, const float size) noexcept {
+    const glm::vec3 closest = glm::clamp(sphere.center, position, position + glm::vec3(size));
+    const glm::vec3 offset = sphere.center - closest;
+    return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+}
+
+bool intersects(const Sphere &sphere, const Polygon &triangle) noexcept {
+    const glm::vec3 offset = sphere.center - closest_point(triangle, sphere.center);
+    return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+}
+
+std::size_t clip(const Polygon &triangle, const Box &box,
+                 std::array<Polygon, MAX_CLIPPED_TRIANGLES> &clipped) noexcept {
+    // Sutherland-Hodgman against the six planes of the box, swapping between two buffers.
+    std::array<ClipPolygon, 2> polygons{};
+    polygons[0].corners[0] = triangle[0];
+    polygons[0].corners[1] = triangle[1];
+    polygons[0].corners[2] = triangle[2];
+    polygons[0].size = 3;
+    std::size_t current = 0;
+    for (std::size_t axis = 0; axis < 3 && polygons[current].size > 0; axis++) {
+        clip(polygons[current], axis, box.min[axis], true, polygons[1 - current]);
+        clip(polygons[1 - current], axis, box.max[axis], false, polygons[current]);
+    }
+    const ClipPolygon &polygon = polygons[current];
+    if (polygon.size < 3) {
+        return 0;
+    }
+    // the clipped polygon is convex and keeps the winding of the triangle
+    for (std::size_t i = 1; i + 1 < polygon.size; i++) {
+        clipped[i - 1] = {polygon.corners[0], polygon.corners[i], polygon.corners[i + 1]};
+    }
+    return polygon.size - 2;
+}
+
+PolygonSpan cube_polygons(const CubePool &pool, const TraversalNode &node, CubePolygons &polygons) {
+    // Do not update the cache, queries should not modify the octree.
+    const PolygonSpan cache = pool.polygon_cache(node.index);
+    if (!cache.empty()) {
+        return cache;
+    }
+    polygons = CubePool::build_polygons(pool.type(node.index), node.position, node.size, pool.indentations(node.index));
+    return {polygons.data(), polygons.size()};
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,225 @@
+#include "inexor/vulkan-renderer/world/ray_cast.hpp"
+
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 inverse_direction;
+    float max_distance;
+};
+
+/// Parameter range of the ray inside of an axis aligned cube.
+struct BoxHit {
+    float enter;
+    float exit;
+    /// Face through which the ray enters the cube.
+    std::size_t face;
+};
+
+std::optional<BoxHit> intersect_box(const Ray &ray, const glm::vec3 &position, const float size) {
+    BoxHit hit{-std::numeric_limits<float>::infinity(), ray.max_distance, 0};
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (ray.direction[axis] == 0.0F) {
+            // parallel to the slab
+            if (ray.origin[axis] < position[axis] || ray.origin[axis] > position[axis] + size) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        float near = (position[axis] - ray.origin[axis]) * ray.inverse_direction[axis];
+        float far = (position[axis] + size - ray.origin[axis]) * ray.inverse_direction[axis];
+        std::size_t near_face = 2 * axis;
+        if (near > far) {
+            std::swap(near, far);
+            near_face++;
+        }
+        if (near > hit.enter) {
+            hit.enter = near;
+            hit.face = near_face;
+        }
+        hit.exit = std::min(hit.exit, far);
+    }
+    if (hit.enter > hit.exit || hit.exit < 0.0F) {
+        return std::nullopt;
+    }
+    return hit;
+}
+
+/// Möller-Trumbore ray triangle intersection, culling neither side.
+std::optional<float> intersect_polygon(const Ray &ray, const Polygon &polygon) {
+    constexpr float EPSILON{1e-7F};
+    const glm::vec3 edge1 = polygon[1] - polygon[0];
+    const glm::vec3 edge2 = polygon[2] - polygon[0];
+    const glm::vec3 p = glm::cross(ray.direction, edge2);
+    const float determinant = glm::dot(edge1, p);
+    if (std::abs(determinant) < EPSILON) {
+        return std::nullopt;
+    }
+    const float inverse_determinant = 1.0F / determinant;
+    const glm::vec3 s = ray.origin - polygon[0];
+    const float u = glm::dot(s, p) * inverse_determinant;
+    if (u < 0.0F || u > 1.0F) {
+        return std::nullopt;
+    }
+    const glm::vec3 q = glm::cross(s, edge1);
+    const float v = glm::dot(ray.direction, q) * inverse_determinant;
+    if (v < 0.0F || u + v > 1.0F) {
+        return std::nullopt;
+    }
+    const float t = glm::dot(edge2, q) * inverse_determinant;
+    if (t < 0.0F || t > ray.max_distance) {
+        return std::nullopt;
+    }
+    return t;
+}
+
+/// Is the point inside of the polygon when projected along its normal.
+bool inside_polygon(const Polygon &polygon, const glm::vec3 &point) {
+    const glm::vec3 normal = glm::cross(polygon[1] - polygon[0], polygon[2] - polygon[0]);
+    for (std::size_t corner = 0; corner < polygon.size(); corner++) {
+        const glm::vec3 &start = polygon[corner];
+        const glm::vec3 &end = polygon[(corner + 1) % polygon.size()];
+        if (glm::dot(glm::cross(end - start, point - start), normal) < 0.0F) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// The edge of a face of a geometry cube which is closest to the point.
+std::size_t closest_edge(const CubePool &pool, const CubePool::Index idx, const glm::vec3 &position, const float size,
+                         const std::size_t face, const glm::vec3 &point) {
+    // the corners of every edge in the order of CubePool::vertices(), whose ids have the bits x = 4, y = 2 and z = 1
+    constexpr std::array<std::array<std::size_t, 2>, Cube::EDGES> edge_corners{
+        {{0, 4}, {0, 2}, {0, 1}, {2, 6}, {1, 3}, {4, 5}, {3, 7}, {5, 7}, {6, 7}, {1, 5}, {4, 6}, {2, 3}}};
+    const Cube::Type type = pool.type(idx);
+    const std::array<glm::vec3, 8> corners = CubePool::vertices(
+        type, position, size,
+        type == Cube::Type::NORMAL ? pool.indentations(idx) : std::array<Indentation, Cube::EDGES>{});
+    // the bit of the face axis in the corner ids and its value on the face
+    const std::size_t axis_bit = 0b100U >> (face / 2);
+    const std::size_t face_bits = (face % 2) != 0 ? axis_bit : 0;
+    std::size_t closest = 0;
+    float closest_distance = std::numeric_limits<float>::infinity();
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        const auto [first, second] = edge_corners[edge];
+        if ((first & axis_bit) != face_bits || (second & axis_bit) != face_bits) {
+            continue;
+        }
+        const glm::vec3 segment = corners[second] - corners[first];
+        const float length_squared = glm::dot(segment, segment);
+        const float fraction =
+            length_squared > 0.0F ? std::clamp(glm::dot(point - corners[first], segment) / length_squared, 0.0F, 1.0F)
+                                  : 0.0F;
+        const glm::vec3 offset = corners[first] + segment * fraction - point;
+        if (const float distance = glm::dot(offset, offset); distance < closest_distance) {
+            closest_distance = distance;
+            closest = edge;
+        }
+    }
+    return closest;
+}
+
+std::optional<RayHit> ray_cast(const std::shared_ptr<CubePool> &pool, const CubePool::Index idx, const Ray &ray,
+                               const glm::vec3 &position, const float size, const BoxHit &box) {
+    switch (pool->type(idx)) {
+    case Cube::Type::EMPTY:
+        return std::nullopt;
+    case Cube::Type::SOLID: {
+        const float distance = std::max(box.enter, 0.0F);
+        const glm::vec3 hit_position = ray.origin + ray.direction * distance;
+        // the face is split into two polygons along a diagonal
+        const CubePolygons polygons = CubePool::build_polygons(Cube::Type::SOLID, position, size, {});
+        const std::size_t polygon =
+            inside_polygon(polygons[2 * box.face + 1], hit_position) ? 2 * box.face + 1 : 2 * box.face;
+        return RayHit{{pool, idx},
+                      box.face,
+                      polygon,
+                      closest_edge(*pool, idx, position, size, box.face, hit_position),
+                      distance,
+                      hit_position,
+                      pool->grid_level(idx)};
+    }
+    case Cube::Type::NORMAL: {
+        // Do not update the cache, queries should not modify the octree.
+        CubePolygons built_polygons;
+        PolygonSpan polygons = pool->polygon_cache(idx);
+        if (polygons.empty()) {
+            built_polygons = CubePool::build_polygons(Cube::Type::NORMAL, position, size, pool->indentations(idx));
+            polygons = {built_polygons.data(), built_polygons.size()};
+        }
+        std::optional<RayHit> closest;
+        for (std::size_t polygon = 0; polygon < polygons.size(); polygon++) {
+            const std::optional<float> distance = intersect_polygon(ray, polygons[polygon]);
+            if (distance && (!closest || *distance < closest->distance)) {
+                closest = RayHit{{pool, idx},
+                                 polygon / 2,
+                                 polygon,
+                                 0,
+                                 *distance,
+                                 ray.origin + ray.direction * *distance,
+                                 pool->grid_level(idx)};
+            }
+        }
+        if (closest) {
+            closest->edge = closest_edge(*pool, idx, position, size, closest->face, closest->position);
+        }
+        return closest;
+    }
+    case Cube::Type::OCTANT:
+        break;
+    }
+
+    // The children do not overlap, so the first hit in the order of entering the children is the closest one.
+    std::array<std::pair<BoxHit, std::size_t>, Cube::SUB_CUBES> children;
+    std::size_t child_count = 0;
+    const float half_size = size / 2;
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        if (pool->type(pool->child(idx, child_id)) == Cube::Type::EMPTY) {
+            continue;
+        }
+        const glm::vec3 child_position = position + CubePool::child_offset(child_id, half_size);
+        if (const std::optional<BoxHit> child_box = intersect_box(ray, child_position, half_size)) {
+            // insertion sort by the entering distance
+            std::size_t i = child_count++;
+            for (; i > 0 && children[i - 1].first.enter > child_box->enter; i--) {
+                children[i] = children[i - 1];
+            }
+            children[i] = {*child_box, child_id};
+        }
+    }
+    for (std::size_t i = 0; i < child_count; i++) {
+        const auto &[child_box, child_id] = children[i];
+        if (auto hit = ray_cast(pool, pool->child(idx, child_id), ray,
+                                position + CubePool::child_offset(child_id, half_size), half_size, child_box)) {
+            return hit;
+        }
+    }
+    return std::nullopt;
+}
+} // namespace
+
+std::optional<RayHit> ray_cast(const Cube &cube, const glm::vec3 &origin, const glm::vec3 &direction,
+                               const float max_distance) {
+    const Ray ray{origin, direction, 1.0F / direction, max_distance};
+    const glm::vec3 position = cube.position();
+    const float size = cube.size();
+    const std::optional<BoxHit> box = intersect_box(ray, position, size);
+    if (!box) {
+        return std::nullopt;
+    }
+    return ray_cast(cube.pool(), cube.index(), ray, position, size, *box);
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,202 @@
+#include "inexor/vulkan-renderer/world/region_streamer.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/nxoc_parser.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+RegionStreamer::RegionStreamer(std::filesystem::path directory, const float region_size,
+                               const std::size_t memory_budget, const std::size_t region_memory_estimate,
+                               const std::size_t thread_count, const std::size_t mesher_region_level)
+    : m_directory(std::move(directory)), m_region_size(region_size), m_memory_budget(memory_budget),
+      m_region_memory_estimate(region_memory_estimate), m_mesher_region_level(mesher_region_level) {
+    for (std::size_t thread = 0; thread < std::max<std::size_t>(thread_count, 1); thread++) {
+        m_threads.emplace_back([this] { run_thread(); });
+    }
+}
+
+RegionStreamer::~RegionStreamer() {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_requests_added.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+RegionStreamer::LoadedRegion RegionStreamer::load(const RegionCoordinate &coordinate) const {
+    const std::filesystem::path path = region_path(coordinate);
+    Cube root(m_region_size, region_position(coordinate));
+    root.set_type(Cube::Type::EMPTY);
+    // a missing file is an empty region, but errors of the file system must not escape the loader thread
+    std::error_code error;
+    const bool exists = std::filesystem::exists(path, error);
+    bool failed = static_cast<bool>(error);
+    if (exists) {
+        try {
+            root = io::NXOCParser().deserialize(io::ByteStream(path));
+            root.pool()->set_root_bounds(m_region_size, region_position(coordinate));
+        } catch (const std::exception &) {
+            failed = true;
+        }
+    }
+    auto mesher = std::make_unique<OctreeMesher>(root, m_mesher_region_level);
+    const std::size_t memory_usage = root.pool()->memory_usage() + mesher->polygon_count() * sizeof(Polygon);
+    return {coordinate, {std::move(root), std::move(mesher), memory_usage}, failed};
+}
+
+void RegionStreamer::run_thread() {
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_requests_added.wait(lock, [&] { return m_stop || !m_requests.empty(); });
+        if (m_stop) {
+            return;
+        }
+        const RegionCoordinate coordinate = m_requests.front();
+        m_requests.pop_front();
+        lock.unlock();
+        LoadedRegion loaded_region = load(coordinate);
+        lock.lock();
+        m_loaded_regions.push_back(std::move(loaded_region));
+    }
+}
+
+std::size_t RegionStreamer::expected_region_memory_usage() const noexcept {
+    return m_measured_regions == 0 ? m_region_memory_estimate : m_measured_memory_usage / m_measured_regions;
+}
+
+float RegionStreamer::distance(const RegionCoordinate &coordinate, const glm::vec3 &position) const noexcept {
+    const glm::vec3 min = region_position(coordinate);
+    return glm::length(position - glm::clamp(position, min, min + glm::vec3(m_region_size)));
+}
+
+RegionStreamer::Changes RegionStreamer::update(const glm::vec3 &camera_position, const float load_distance) {
+    Changes changes;
+    const float unload_distance = load_distance * UNLOAD_DISTANCE_FACTOR;
+    std::vector<LoadedRegion> loaded_regions;
+    {
+        std::scoped_lock lock(m_mutex);
+        loaded_regions.swap(m_loaded_regions);
+        // the requests which were not started yet are replaced below
+        for (const RegionCoordinate &coordinate : m_requests) {
+            m_pending.erase(coordinate);
+        }
+        m_requests.clear();
+    }
+    for (LoadedRegion &loaded_region : loaded_regions) {
+        m_pending.erase(loaded_region.coordinate);
+        m_measured_memory_usage += loaded_region.region.memory_usage;
+        m_measured_regions++;
+        // the camera may have moved away while the region was loading
+        if (distance(loaded_region.coordinate, camera_position) > unload_distance) {
+            continue;
+        }
+        changes.loaded.push_back(loaded_region.coordinate);
+        if (loaded_region.failed) {
+            changes.failed.push_back(loaded_region.coordinate);
+        }
+        m_memory_usage += loaded_region.region.memory_usage;
+        m_regions.emplace(loaded_region.coordinate, std::move(loaded_region.region));
+    }
+
+    // unload the regions out of range and the farthest ones until the memory budget is kept
+    std::vector<std::pair<float, RegionCoordinate>> resident_regions;
+    resident_regions.reserve(m_regions.size());
+    for (const auto &[coordinate, region] : m_regions) {
+        resident_regions.emplace_back(distance(coordinate, camera_position), coordinate);
+    }
+    std::sort(resident_regions.begin(), resident_regions.end());
+    while (!resident_regions.empty() &&
+           (resident_regions.back().first > unload_distance || m_memory_usage > m_memory_budget)) {
+        const auto region = m_regions.find(resident_regions.back().second);
+        m_memory_usage -= region->second.memory_usage;
+        changes.unloaded.push_back(region->first);
+        m_regions.erase(region);
+        resident_regions.pop_back();
+    }
+
+    // request the missing regions in range, the nearest first, as long as they are expected to fit into the budget
+    std::vector<std::pair<float, RegionCoordinate>> missing_regions;
+    const RegionCoordinate first = region_at(camera_position - glm::vec3(load_distance));
+    const RegionCoordinate last = region_at(camera_position + glm::vec3(load_distance));
+    for (std::int32_t x = first[0]; x <= last[0]; x++) {
+        for (std::int32_t y = first[1]; y <= last[1]; y++) {
+            for (std::int32_t z = first[2]; z <= last[2]; z++) {
+                const RegionCoordinate coordinate{x, y, z};
+                const float region_distance = distance(coordinate, camera_position);
+                if (region_distance <= load_distance && m_regions.count(coordinate) == 0 &&
+                    m_pending.count(coordinate) == 0) {
+                    missing_regions.emplace_back(region_distance, coordinate);
+                }
+            }
+        }
+    }
+    std::sort(missing_regions.begin(), missing_regions.end());
+    const std::size_t region_memory_usage = expected_region_memory_usage();
+    std::size_t expected_memory_usage = m_memory_usage + m_pending.size() * region_memory_usage;
+    {
+        std::scoped_lock lock(m_mutex);
+        for (const auto &[region_distance, coordinate] : missing_regions) {
+            if (expected_memory_usage + region_memory_usage > m_memory_budget) {
+                break;
+            }
+            expected_memory_usage += region_memory_usage;
+            m_requests.push_back(coordinate);
+            m_pending.insert(coordinate);
+        }
+    }
+    m_requests_added.notify_all();
+    return changes;
+}
+
+float RegionStreamer::region_size() const noexcept {
+    return m_region_size;
+}
+
+glm::vec3 RegionStreamer::region_position(const RegionCoordinate &coordinate) const noexcept {
+    return glm::vec3(static_cast<float>(coordinate[0]), static_cast<float>(coordinate[1]),
+                     static_cast<float>(coordinate[2])) *
+           m_region_size;
+}
+
+RegionStreamer::RegionCoordinate RegionStreamer::region_at(const glm::vec3 &position) const noexcept {
+    return {static_cast<std::int32_t>(std::floor(position.x / m_region_size)),
+            static_cast<std::int32_t>(std::floor(position.y / m_region_size)),
+            static_cast<std::int32_t>(std::floor(position.z / m_region_size))};
+}
+
+std::filesystem::path RegionStreamer::region_path(const RegionCoordinate &coordinate) const {
+    return m_directory / ("region_" + std::to_string(coordinate[0]) + "_" + std::to_string(coordinate[1]) + "_" +
+                          std::to_string(coordinate[2]) + ".nxoc");
+}
+
+const std::map<RegionStreamer::RegionCoordinate, RegionStreamer::Region> &RegionStreamer::regions() const noexcept {
+    return m_regions;
+}
+
+std::size_t RegionStreamer::memory_usage() const noexcept {
+    return m_memory_usage;
+}
+
+std::size_t RegionStreamer::pending_count() const noexcept {
+    return m_pending.size();
+}
+
+void RegionStreamer::save(const RegionCoordinate &coordinate, const Cube &root) const {
+    io::NXOCParser().serialize(root, io::NXOCParser::LATEST_VERSION).write_file(region_path(coordinate));
+}
+
+} // namespace inexor::vulkan_renderer::world
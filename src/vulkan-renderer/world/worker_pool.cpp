@@ -0,0 +1,100 @@
+#include "inexor/vulkan-renderer/world/worker_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+WorkerPool::WorkerPool(const std::size_t thread_count) {
+    const std::size_t worker_count = std::max<std::size_t>(thread_count, 1) - 1;
+    m_threads.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; i++) {
+        m_threads.emplace_back([this] { thread_main(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_started.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::work() {
+    try {
+        for (std::size_t i = m_next++; i < m_count; i = m_next++) {
+            m_call(m_function, i);
+        }
+    } catch (...) {
+        // skip the remaining iterations
+        m_next = m_count;
+        const std::scoped_lock lock(m_mutex);
+        if (!m_exception) {
+            m_exception = std::current_exception();
+        }
+    }
+}
+
+void WorkerPool::thread_main() {
+    std::uint64_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_started.wait(lock, [&] { return m_stop || m_generation != generation; });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+        }
+        work();
+        bool last = false;
+        {
+            const std::scoped_lock lock(m_mutex);
+            last = --m_busy_threads == 0;
+        }
+        if (last) {
+            m_finished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::run(const std::size_t count, const Call call, const void *function) {
+    if (m_threads.empty() || count <= 1) {
+        for (std::size_t i = 0; i < count; i++) {
+            call(function, i);
+        }
+        return;
+    }
+    const std::scoped_lock run_lock(m_run_mutex);
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_call = call;
+        m_function = function;
+        m_count = count;
+        m_next = 0;
+        m_busy_threads = m_threads.size();
+        m_exception = nullptr;
+        m_generation++;
+    }
+    m_started.notify_all();
+    work();
+    std::exception_ptr exception;
+    {
+        std::unique_lock lock(m_mutex);
+        m_finished.wait(lock, [&] { return m_busy_threads == 0; });
+        exception = std::exchange(m_exception, nullptr);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+std::size_t WorkerPool::thread_count() const noexcept {
+    return m_threads.size() + 1;
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -70,8 +70,9 @@ void CommandBuffer::draw(std::size_t vertex_count) const {
     vkCmdDraw(m_command_buffer, static_cast<std::uint32_t>(vertex_count), 1, 0, 0);
 }
 
-void CommandBuffer::draw_indexed(std::size_t index_count) const {
-    vkCmdDrawIndexed(m_command_buffer, static_cast<std::uint32_t>(index_count), 1, 0, 0, 0);
+void CommandBuffer::draw_indexed(std::size_t index_count, std::size_t first_index) const {
+    vkCmdDrawIndexed(m_command_buffer, static_cast<std::uint32_t>(index_count), 1,
+                     static_cast<std::uint32_t>(first_index), 0, 0);
 }
 
 void CommandBuffer::end_render_pass() const {
@@ -1,58 +1,45 @@
 #include "inexor/vulkan-renderer/wrapper/shader.hpp"
 
 #include "inexor/vulkan-renderer/exception.hpp"
+#include "inexor/vulkan-renderer/tools/mapped_file.hpp"
 #include "inexor/vulkan-renderer/wrapper/device.hpp"
 #include "inexor/vulkan-renderer/wrapper/make_info.hpp"
 
 #include <spdlog/spdlog.h>
 
 #include <cassert>
-#include <fstream>
-#include <stdexcept>
+#include <cstdint>
 #include <utility>
 
-namespace {
-
-std::vector<char> read_binary(const std::string &file_name) {
-    // Open stream at the end of the file to read it's size.
-    std::ifstream file(file_name.c_str(), std::ios::ate | std::ios::binary | std::ios::in);
-
-    if (!file) {
-        throw std::runtime_error("Error: Could not open file " + file_name + "!");
-    }
-
-    const auto file_size = file.tellg();
-    std::vector<char> buffer(file_size);
-
-    file.seekg(0);
-    file.read(buffer.data(), file_size);
-
-    return buffer;
-}
-
-} // namespace
-
 namespace inexor::vulkan_renderer::wrapper {
 
 Shader::Shader(const Device &device, const VkShaderStageFlagBits type, const std::string &name,
                const std::string &file_name, const std::string &entry_point)
-    : Shader(device, type, name, read_binary(file_name), entry_point) {}
+    : Shader(device, type, name, tools::MappedFile(file_name), entry_point) {}
 
 Shader::Shader(const Device &device, const VkShaderStageFlagBits type, const std::string &name,
                const std::vector<char> &code, const std::string &entry_point)
+    : Shader(device, type, name, code.data(), code.size(), entry_point) {}
+
+Shader::Shader(const Device &device, const VkShaderStageFlagBits type, const std::string &name,
+               const tools::MappedFile &file, const std::string &entry_point)
+    : Shader(device, type, name, file.data(), file.size(), entry_point) {}
+
+Shader::Shader(const Device &device, const VkShaderStageFlagBits type, const std::string &name, const void *code,
+               const std::size_t code_size, const std::string &entry_point)
     : m_device(device), m_type(type), m_name(name), m_entry_point(entry_point) {
     assert(device.device());
     assert(!name.empty());
-    assert(!code.empty());
+    assert(code != nullptr && code_size != 0);
     assert(!entry_point.empty());
 
     auto shader_module_ci = make_info<VkShaderModuleCreateInfo>();
-    shader_module_ci.codeSize = code.size();
+    shader_module_ci.codeSize = code_size;
 
     // When you perform a cast like this, you also need to ensure that the data satisfies the alignment
-    // requirements of std::uint32_t. Lucky for us, the data is stored in an std::vector where the default
-    // allocator already ensures that the data satisfies the worst case alignment requirements.
-    shader_module_ci.pCode = reinterpret_cast<const std::uint32_t *>(code.data());
+    // requirements of std::uint32_t. Lucky for us, both the default allocator of std::vector and memory
+    // mapped files already ensure that the data satisfies the worst case alignment requirements.
+    shader_module_ci.pCode = static_cast<const std::uint32_t *>(code);
 
     spdlog::debug("Creating shader module {}.", name);
     if (const auto result = vkCreateShaderModule(device.device(), &shader_module_ci, nullptr, &m_shader_module);
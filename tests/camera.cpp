@@ -0,0 +1,47 @@
+#include "inexor/vulkan-renderer/camera.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace inexor::vulkan_renderer {
+namespace {
+
+/// Is the point inside of all planes.
+bool inside(const std::array<glm::vec4, 6> &planes, const glm::vec3 &point) {
+    for (const glm::vec4 &plane : planes) {
+        if (glm::dot(glm::vec3(plane), point) + plane.w < 0.0F) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(Camera, FrustumPlanes) {
+    // looking in positive y direction
+    Camera camera({1.0F, 2.0F, 3.0F}, 0.0F, 0.0F, 800.0F, 600.0F);
+    const std::array<glm::vec4, 6> &planes = camera.frustum_planes();
+    for (const glm::vec4 &plane : planes) {
+        EXPECT_NEAR(glm::length(glm::vec3(plane)), 1.0F, 1e-5F);
+    }
+    EXPECT_TRUE(inside(planes, {1.0F, 12.0F, 3.0F}));
+    // behind the camera and behind the far plane
+    EXPECT_FALSE(inside(planes, {1.0F, -8.0F, 3.0F}));
+    EXPECT_FALSE(inside(planes, {1.0F, 2.0F + camera.far_plane() + 1.0F, 3.0F}));
+    // the field of view is 90 degrees vertically and wider horizontally
+    EXPECT_TRUE(inside(planes, {1.0F, 12.0F, 3.0F + 9.0F}));
+    EXPECT_FALSE(inside(planes, {1.0F, 12.0F, 3.0F + 11.0F}));
+    EXPECT_FALSE(inside(planes, {1.0F, 12.0F, 3.0F - 11.0F}));
+    EXPECT_TRUE(inside(planes, {1.0F + 13.0F, 12.0F, 3.0F}));
+    EXPECT_FALSE(inside(planes, {1.0F + 14.0F, 12.0F, 3.0F}));
+    EXPECT_FALSE(inside(planes, {1.0F - 14.0F, 12.0F, 3.0F}));
+
+    // the planes follow the camera
+    camera.set_position({1.0F, 20.0F, 3.0F});
+    camera.update(0.0F);
+    EXPECT_FALSE(inside(camera.frustum_planes(), {1.0F, 12.0F, 3.0F}));
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer
@@ -0,0 +1,33 @@
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+
+TEST(ByteStream, WriteFileKeepsMappedContent) {
+#if defined(_WIN32)
+    GTEST_SKIP() << "A mapped file cannot be replaced on Windows.";
+#endif
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "inexor_byte_stream_test.bin";
+    ByteStream(std::vector<std::uint8_t>(100000, 1)).write_file(path);
+    const ByteStream old_content(path);
+
+    // a shorter file would truncate the pages of the old one
+    ByteStream(std::vector<std::uint8_t>{2, 3}).write_file(path);
+    ASSERT_EQ(old_content.size(), 100000);
+    EXPECT_EQ(old_content.data()[old_content.size() - 1], 1);
+
+    const ByteStream new_content(path);
+    ASSERT_EQ(new_content.size(), 2);
+    EXPECT_EQ(new_content.data()[1], 3);
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+    std::filesystem::remove(path);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,77 @@
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/delta_transport.hpp"
+#include "inexor/vulkan-renderer/io/exception.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+
+std::vector<std::uint8_t> bytes(const std::optional<ByteStream> &stream) {
+    if (!stream) {
+        return {};
+    }
+    return {stream->data(), stream->data() + stream->size()};
+}
+
+/// Append raw bytes to the file, like another process which is still writing.
+void append(const std::filesystem::path &path, const std::vector<std::uint8_t> &content) {
+    std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::app);
+    stream.write(reinterpret_cast<const char *>(content.data()), static_cast<std::streamsize>(content.size()));
+}
+
+TEST(LoopbackTransport, ReceivesInOrder) {
+    auto [first, second] = LoopbackTransport::connect();
+    EXPECT_FALSE(second->receive());
+    first->send(ByteStream(std::vector<std::uint8_t>{1, 2}));
+    first->send(ByteStream(std::vector<std::uint8_t>{3}));
+    second->send(ByteStream(std::vector<std::uint8_t>{4}));
+    EXPECT_EQ(bytes(second->receive()), (std::vector<std::uint8_t>{1, 2}));
+    EXPECT_EQ(bytes(second->receive()), std::vector<std::uint8_t>{3});
+    EXPECT_FALSE(second->receive());
+    EXPECT_EQ(bytes(first->receive()), std::vector<std::uint8_t>{4});
+    EXPECT_FALSE(first->receive());
+}
+
+TEST(FileTransport, ReceivesCompleteDeltas) {
+    const std::filesystem::path first_path = std::filesystem::temp_directory_path() / "inexor_transport_first.bin";
+    const std::filesystem::path second_path = std::filesystem::temp_directory_path() / "inexor_transport_second.bin";
+    std::filesystem::remove(first_path);
+    std::filesystem::remove(second_path);
+    FileTransport first(first_path, second_path);
+    FileTransport second(second_path, first_path);
+
+    // the file does not exist yet
+    EXPECT_FALSE(second.receive());
+    first.send(ByteStream(std::vector<std::uint8_t>{1, 2}));
+    first.send(ByteStream(std::vector<std::uint8_t>{3}));
+    second.send(ByteStream(std::vector<std::uint8_t>{4}));
+    EXPECT_EQ(bytes(second.receive()), (std::vector<std::uint8_t>{1, 2}));
+    EXPECT_EQ(bytes(second.receive()), std::vector<std::uint8_t>{3});
+    EXPECT_FALSE(second.receive());
+    EXPECT_EQ(bytes(first.receive()), std::vector<std::uint8_t>{4});
+
+    // a delta which is not completely written is received later
+    append(first_path, {3, 0});
+    EXPECT_FALSE(second.receive());
+    append(first_path, {0, 0, 5, 6});
+    EXPECT_FALSE(second.receive());
+    append(first_path, {7});
+    EXPECT_EQ(bytes(second.receive()), (std::vector<std::uint8_t>{5, 6, 7}));
+
+    // an invalid size is not allocated
+    append(first_path, {0xFF, 0xFF, 0xFF, 0xFF});
+    EXPECT_THROW(static_cast<void>(second.receive()), IoException);
+
+    std::filesystem::remove(first_path);
+    std::filesystem::remove(second_path);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,188 @@
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/edit_delta.hpp"
+#include "inexor/vulkan-renderer/io/exception.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/edit_batch.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+
+/// The code of the cube reached by the child ids from the root cube.
+world::MortonCode code_of(const std::vector<std::size_t> &child_ids) {
+    world::MortonCode code{1};
+    for (const std::size_t child_id : child_ids) {
+        code = world::morton_child(code, child_id);
+    }
+    return code;
+}
+
+/// Types and indentations of all cubes in pre-order.
+std::vector<std::pair<world::Cube::Type, std::array<world::Indentation, world::Cube::EDGES>>>
+content(const world::Cube &cube) {
+    const world::CubePool &pool = *cube.pool();
+    std::vector<std::pair<world::Cube::Type, std::array<world::Indentation, world::Cube::EDGES>>> result;
+    for (const world::TraversalNode &node : world::pre_order(pool, cube.index())) {
+        const world::Cube::Type type = pool.type(node.index);
+        result.emplace_back(type, type == world::Cube::Type::NORMAL
+                                      ? pool.indentations(node.index)
+                                      : std::array<world::Indentation, world::Cube::EDGES>{});
+    }
+    return result;
+}
+
+/// Content of a new octree after applying the delta.
+std::vector<std::pair<world::Cube::Type, std::array<world::Indentation, world::Cube::EDGES>>>
+applied(const EditDelta &delta) {
+    world::Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    world::EditBatch batch(root);
+    delta.apply(batch);
+    batch.apply();
+    return content(root);
+}
+
+std::vector<std::uint8_t> bytes(const ByteStream &stream) {
+    return {stream.data(), stream.data() + stream.size()};
+}
+
+void write_varint(ByteStreamWriter &writer, std::uint64_t value) {
+    while (value >= 0x80U) {
+        writer.write(static_cast<std::uint8_t>(value | 0x80U));
+        value >>= 7U;
+    }
+    writer.write(static_cast<std::uint8_t>(value));
+}
+
+/// Delta with a single record whose code follows the root code.
+ByteStreamWriter record(const std::uint8_t tag, const world::MortonCode first, const std::uint64_t count) {
+    ByteStreamWriter writer;
+    writer.write<std::string>("Inexor Delta");
+    writer.write<std::uint32_t>(0);
+    writer.write(tag);
+    // zigzag encoding of the difference
+    const std::uint64_t difference = first - 1;
+    write_varint(writer, difference >> 63U != 0 ? ~(difference << 1U) : difference << 1U);
+    write_varint(writer, count);
+    return writer;
+}
+
+TEST(EditDelta, RoundTripKeepsOrder) {
+    EditDelta delta;
+    // parents and their children are edited in turn, the edits do not commute
+    delta.set_type(code_of({2}), world::Cube::Type::OCTANT);
+    delta.set_type(code_of({2, 3}), world::Cube::Type::NORMAL);
+    delta.indent(code_of({2, 3}), 4, true, 2);
+    delta.set_type(code_of({1, 6}), world::Cube::Type::EMPTY);
+    delta.set_type(code_of({2}), world::Cube::Type::EMPTY);
+    delta.set_indent(code_of({2, 3, 1}), 7, world::Indentation(3, 5));
+    delta.set_type(code_of({1}), world::Cube::Type::SOLID);
+    std::array<world::Indentation, world::Cube::EDGES> indentations{};
+    indentations[9] = world::Indentation(1, 6);
+    delta.set_indentations(code_of({1, 6}), indentations);
+    delta.set_type(code_of({2, 3}), world::Cube::Type::OCTANT);
+
+    const ByteStream stream = delta.serialize();
+    const EditDelta decoded(stream);
+    EXPECT_EQ(decoded.size(), delta.size());
+    EXPECT_EQ(applied(decoded), applied(delta));
+    EXPECT_EQ(bytes(decoded.serialize()), bytes(stream));
+}
+
+TEST(EditDelta, CoalescesRuns) {
+    EditDelta single;
+    single.set_type(code_of({4, 0}), world::Cube::Type::EMPTY);
+    EditDelta run;
+    for (std::size_t child_id = 0; child_id < world::Cube::SUB_CUBES; child_id++) {
+        run.set_type(code_of({4, child_id}), world::Cube::Type::EMPTY);
+    }
+    EXPECT_EQ(run.serialize().size(), single.serialize().size());
+    const EditDelta decoded(run.serialize());
+    EXPECT_EQ(decoded.size(), world::Cube::SUB_CUBES);
+    EXPECT_EQ(applied(decoded), applied(run));
+
+    // a different payload starts a new run
+    run.set_type(code_of({5, 0}), world::Cube::Type::SOLID);
+    run.set_type(code_of({5, 1}), world::Cube::Type::EMPTY);
+    EXPECT_GT(run.serialize().size(), single.serialize().size());
+    EXPECT_EQ(EditDelta(run.serialize()).size(), world::Cube::SUB_CUBES + 2);
+}
+
+TEST(EditDelta, InvalidHeader) {
+    ByteStreamWriter identifier;
+    identifier.write<std::string>("Inexor Octree");
+    EXPECT_THROW(EditDelta{identifier}, IoException);
+    ByteStreamWriter version;
+    version.write<std::string>("Inexor Delta");
+    version.write<std::uint32_t>(EditDelta::LATEST_VERSION + 1);
+    EXPECT_THROW(EditDelta{version}, IoException);
+    EXPECT_THROW(static_cast<void>(EditDelta().serialize(EditDelta::LATEST_VERSION + 1)), IoException);
+}
+
+TEST(EditDelta, InvalidRecords) {
+    // SET_TYPE of an empty cube
+    EXPECT_NO_THROW(EditDelta{record(0, 1, 1)});
+    // a type in the tag of another operation
+    EXPECT_THROW(EditDelta{record(0b101U, 1, 1)}, IoException);
+    // a type after Type::OCTANT
+    EXPECT_THROW(EditDelta{record(4U << 2U, 1, 1)}, IoException);
+    // code zero
+    EXPECT_THROW(EditDelta{record(0, 0, 1)}, IoException);
+    // empty runs
+    EXPECT_THROW(EditDelta{record(0, code_of({7}), 0)}, IoException);
+    // runs which leave the level
+    EXPECT_THROW(EditDelta{record(0, 1, 2)}, IoException);
+    EXPECT_THROW(EditDelta{record(0, code_of({7}), 2)}, IoException);
+}
+
+TEST(EditDelta, InvalidPayloads) {
+    ByteStreamWriter edge = record(2, code_of({3}), 1);
+    edge.write<std::uint8_t>(world::Cube::EDGES);
+    edge.write<std::uint8_t>(0);
+    EXPECT_THROW(EditDelta{edge}, IoException);
+
+    ByteStreamWriter uid = record(2, code_of({3}), 1);
+    uid.write<std::uint8_t>(0);
+    uid.write<std::uint8_t>(world::Indentation::MAX_UID + 1);
+    EXPECT_THROW(EditDelta{uid}, IoException);
+
+    // the highest bit of the edge of an INDENT is the direction
+    ByteStreamWriter indent = record(3, code_of({3}), 1);
+    indent.write<std::uint8_t>(0x80U | 11U);
+    indent.write<std::uint8_t>(1);
+    EXPECT_EQ(EditDelta{indent}.size(), 1);
+    ByteStreamWriter indent_edge = record(3, code_of({3}), 1);
+    indent_edge.write<std::uint8_t>(0x80U | world::Cube::EDGES);
+    indent_edge.write<std::uint8_t>(1);
+    EXPECT_THROW(EditDelta{indent_edge}, IoException);
+}
+
+TEST(EditDelta, RunsWithinBudget) {
+    // all cubes of level 4 are within the budget of a delta of a few bytes, all cubes of level 5 are not
+    const world::MortonCode level4 = world::MortonCode{1} << 12U;
+    const ByteStreamWriter small = record(0, level4, 4096);
+    ASSERT_LE(small.size() * EditDelta::MAX_EDITS_PER_BYTE, std::size_t{1} << 15U);
+    EXPECT_EQ(EditDelta{small}.size(), 4096);
+    EXPECT_THROW(EditDelta{record(0, level4 << 3U, std::size_t{1} << 15U)}, IoException);
+
+    // a large delta is still limited by MAX_EDITS
+    const world::MortonCode level7 = world::MortonCode{1} << 21U;
+    ByteStreamWriter large = record(0, level7, EditDelta::MAX_EDITS + 1);
+    for (std::size_t i = 0; i <= EditDelta::MAX_EDITS / EditDelta::MAX_EDITS_PER_BYTE; i++) {
+        large.write<std::uint8_t>(0);
+    }
+    EXPECT_THROW(EditDelta{large}, IoException);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,114 @@
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/exception.hpp"
+#include "inexor/vulkan-renderer/io/nxoc_parser.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+
+/// Header of an octree file of the version.
+ByteStreamWriter header(const std::uint32_t version) {
+    ByteStreamWriter writer;
+    writer.write<std::string>("Inexor Octree");
+    writer.write<std::uint32_t>(version);
+    return writer;
+}
+
+/// Version 0 file of a chain of octants whose first children are nested depth times.
+ByteStreamWriter nested_octants(const std::size_t depth) {
+    ByteStreamWriter writer = header(0);
+    for (std::size_t level = 0; level < depth; level++) {
+        writer.write(world::Cube::Type::OCTANT);
+    }
+    // the children of all octants
+    for (std::size_t child = 0; child < depth * (world::Cube::SUB_CUBES - 1) + 1; child++) {
+        writer.write(world::Cube::Type::EMPTY);
+    }
+    return writer;
+}
+
+/// Types and indentations of all cubes in pre-order.
+std::vector<std::pair<world::Cube::Type, std::array<world::Indentation, world::Cube::EDGES>>>
+content(const world::Cube &cube) {
+    std::vector<std::pair<world::Cube::Type, std::array<world::Indentation, world::Cube::EDGES>>> result{
+        {cube.type(), cube.indentations()}};
+    if (cube.type() == world::Cube::Type::OCTANT) {
+        for (const world::Cube &child : cube.childs()) {
+            const auto child_content = content(child);
+            result.insert(result.end(), child_content.begin(), child_content.end());
+        }
+    }
+    return result;
+}
+
+TEST(NXOCParser, RoundTrip) {
+    world::Cube cube;
+    cube.set_type(world::Cube::Type::OCTANT);
+    for (world::Cube child : cube.childs()) {
+        // copies of the same subtree are written as references by version 1
+        child.set_type(world::Cube::Type::OCTANT);
+        child[1].set_type(world::Cube::Type::EMPTY);
+        child[2].set_type(world::Cube::Type::NORMAL);
+        child[2].indent(6, false, 3);
+    }
+    cube[4][7].set_type(world::Cube::Type::OCTANT);
+    cube[4][7][0].set_type(world::Cube::Type::NORMAL);
+    cube[4][7][0].set_indent(11, world::Indentation(5, 7));
+    cube[5].set_type(world::Cube::Type::EMPTY);
+
+    NXOCParser parser;
+    const ByteStream version0 = parser.serialize(cube, 0);
+    const ByteStream version1 = parser.serialize(cube, 1);
+    EXPECT_LT(version1.size(), version0.size());
+    EXPECT_EQ(content(parser.deserialize(version0)), content(cube));
+    EXPECT_EQ(content(parser.deserialize(version1)), content(cube));
+    // the versions do not depend on each other
+    EXPECT_EQ(parser.serialize(parser.deserialize(version1), 0).size(), version0.size());
+    EXPECT_THROW(static_cast<void>(parser.serialize(cube, NXOCParser::LATEST_VERSION + 1)), IoException);
+}
+
+TEST(NXOCParser, Version1InvalidReference) {
+    ByteStreamWriter writer = header(1);
+    writer.write(world::Cube::Type::OCTANT);
+    // the octant itself is still being read
+    writer.write<std::uint8_t>(4);
+    writer.write<std::uint32_t>(0);
+    NXOCParser parser;
+    EXPECT_THROW(static_cast<void>(parser.deserialize(writer)), IoException);
+}
+
+TEST(NXOCParser, Version0InvalidType) {
+    ByteStreamWriter writer = header(0);
+    writer.write<std::uint8_t>(0b100U);
+    NXOCParser parser;
+    EXPECT_THROW(static_cast<void>(parser.deserialize(writer)), IoException);
+}
+
+TEST(NXOCParser, Version0DeepestOctree) {
+    NXOCParser parser;
+    const world::Cube cube = parser.deserialize(nested_octants(world::MAX_TRAVERSAL_DEPTH));
+    std::size_t depth = 0;
+    for (world::Cube child = cube; child.type() == world::Cube::Type::OCTANT; child = child[0]) {
+        depth++;
+    }
+    EXPECT_EQ(depth, world::MAX_TRAVERSAL_DEPTH);
+}
+
+TEST(NXOCParser, Version0TooDeep) {
+    NXOCParser parser;
+    EXPECT_THROW(static_cast<void>(parser.deserialize(nested_octants(world::MAX_TRAVERSAL_DEPTH + 1))),
+                 IoException);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::io
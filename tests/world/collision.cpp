@@ -0,0 +1,116 @@
+#include "inexor/vulkan-renderer/world/collision.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+void expect_near(const glm::vec3 &vector, const glm::vec3 &expected) {
+    for (int axis = 0; axis < 3; axis++) {
+        EXPECT_NEAR(vector[axis], expected[axis], 1e-4F) << "axis " << axis;
+    }
+}
+
+/// A solid cube from (0, 0, 0) to (8, 8, 8).
+Cube solid_cube() {
+    Cube cube(8.0F, {0.0F, 0.0F, 0.0F});
+    cube.set_type(Cube::Type::SOLID);
+    return cube;
+}
+
+TEST(OctreeCollider, SphereOntoFace) {
+    const Cube world = solid_cube();
+    OctreeCollider collider(world);
+    const std::optional<Contact> contact =
+        collider.sweep({{12.0F, 4.0F, 4.0F}, {12.0F, 4.0F, 4.0F}, 1.0F}, {-6.0F, 0.0F, 0.0F});
+    ASSERT_TRUE(contact);
+    EXPECT_NEAR(contact->time, 0.5F, 1e-5F);
+    expect_near(contact->normal, {1.0F, 0.0F, 0.0F});
+    EXPECT_EQ(contact->cube.index(), world.index());
+
+    // too short, moving away and passing by
+    EXPECT_FALSE(collider.sweep({{12.0F, 4.0F, 4.0F}, {12.0F, 4.0F, 4.0F}, 1.0F}, {-2.0F, 0.0F, 0.0F}));
+    EXPECT_FALSE(collider.sweep({{12.0F, 4.0F, 4.0F}, {12.0F, 4.0F, 4.0F}, 1.0F}, {6.0F, 0.0F, 0.0F}));
+    EXPECT_FALSE(collider.sweep({{12.0F, 4.0F, 4.0F}, {12.0F, 4.0F, 4.0F}, 1.0F}, {0.0F, 6.0F, 0.0F}));
+}
+
+TEST(OctreeCollider, SphereOntoEdgeAndCorner) {
+    OctreeCollider collider(solid_cube());
+    // the sphere touches the edge at x = y = 8 when its center is one radius away from it
+    const float diagonal = 1.0F / std::sqrt(2.0F);
+    std::optional<Contact> contact =
+        collider.sweep({{12.0F, 12.0F, 4.0F}, {12.0F, 12.0F, 4.0F}, 1.0F}, {-6.0F, -6.0F, 0.0F});
+    ASSERT_TRUE(contact);
+    EXPECT_NEAR(contact->time, (4.0F - diagonal) / 6.0F, 1e-5F);
+    expect_near(contact->normal, {diagonal, diagonal, 0.0F});
+
+    const float space_diagonal = 1.0F / std::sqrt(3.0F);
+    contact = collider.sweep({{12.0F, 12.0F, 12.0F}, {12.0F, 12.0F, 12.0F}, 1.0F}, {-6.0F, -6.0F, -6.0F});
+    ASSERT_TRUE(contact);
+    EXPECT_NEAR(contact->time, (4.0F - space_diagonal) / 6.0F, 1e-5F);
+    expect_near(contact->normal, glm::vec3(space_diagonal));
+}
+
+TEST(OctreeCollider, CapsuleSlidesAlongWall) {
+    OctreeCollider collider(solid_cube());
+    // only the end of the capsule is in front of the face
+    std::optional<Contact> contact =
+        collider.sweep({{12.0F, 4.0F, -6.0F}, {12.0F, 4.0F, 2.0F}, 1.0F}, {-6.0F, 0.0F, 0.0F});
+    ASSERT_TRUE(contact);
+    EXPECT_NEAR(contact->time, 0.5F, 1e-5F);
+    expect_near(contact->normal, {1.0F, 0.0F, 0.0F});
+
+    // the capsule moves a quarter of the motion up to the wall and slides along it for the rest
+    const Capsule capsule{{10.0F, 2.0F, 3.0F}, {10.0F, 2.0F, 5.0F}, 1.0F};
+    const SlideResult result = collider.slide(capsule, {-4.0F, 3.0F, 0.0F});
+    ASSERT_EQ(result.contact_count, 1);
+    expect_near(result.normals[0], {1.0F, 0.0F, 0.0F});
+    const float skin = OctreeCollider::SKIN * capsule.radius;
+    expect_near(result.motion, {-1.0F + skin * 0.8F, 0.75F - skin * 0.6F + 2.25F, 0.0F});
+
+    // a motion into the corner of two walls stops at both
+    Cube corner = solid_cube();
+    corner.set_type(Cube::Type::OCTANT);
+    corner[7].set_type(Cube::Type::EMPTY);
+    OctreeCollider corner_collider(corner);
+    const SlideResult stopped =
+        corner_collider.slide({{6.0F, 6.0F, 6.0F}, {6.0F, 6.0F, 6.0F}, 1.0F}, {-3.0F, -3.0F, 0.0F});
+    EXPECT_EQ(stopped.contact_count, 2);
+    EXPECT_GE(stopped.motion.x, -1.0F);
+    EXPECT_GE(stopped.motion.y, -1.0F);
+    EXPECT_LT(stopped.motion.x, -0.9F);
+    EXPECT_LT(stopped.motion.y, -0.9F);
+}
+
+TEST(OctreeCollider, VectorAndScalarPathsAgree) {
+    OctreeCollider collider(solid_cube());
+    // With SSE2 the triangles are tested in blocks of four. Only the two triangles of the face at x = 8 are within the
+    // bounds of the first sweep, they are tested by the scalar path. The second sweep also reaches the face at y = 8,
+    // so the same face is tested by the vector path.
+    const std::optional<Contact> scalar =
+        collider.sweep({{12.0F, 4.0F, 4.0F}, {12.0F, 4.0F, 4.0F}, 1.0F}, {-6.0F, 0.0F, 0.0F});
+    const std::optional<Contact> vector =
+        collider.sweep({{12.0F, 7.5F, 4.0F}, {12.0F, 7.5F, 4.0F}, 1.0F}, {-6.0F, 0.0F, 0.0F});
+    ASSERT_TRUE(scalar);
+    ASSERT_TRUE(vector);
+    EXPECT_EQ(vector->time, scalar->time);
+    EXPECT_EQ(vector->normal, scalar->normal);
+
+    // the same for the edge at x = z = 8
+    const std::optional<Contact> scalar_edge =
+        collider.sweep({{12.0F, 4.0F, 8.5F}, {12.0F, 4.0F, 8.5F}, 1.0F}, {-6.0F, 0.0F, 0.0F});
+    const std::optional<Contact> vector_edge =
+        collider.sweep({{12.0F, 7.5F, 8.5F}, {12.0F, 7.5F, 8.5F}, 1.0F}, {-6.0F, 0.0F, 0.0F});
+    ASSERT_TRUE(scalar_edge);
+    ASSERT_TRUE(vector_edge);
+    EXPECT_NEAR(vector_edge->time, scalar_edge->time, 1e-6F);
+    expect_near(vector_edge->normal, scalar_edge->normal);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
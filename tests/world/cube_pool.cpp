@@ -0,0 +1,233 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Count the geometry cubes by visiting every leaf.
+std::size_t count_leaves(const CubePool &pool, const CubePool::Index idx) {
+    switch (pool.type(idx)) {
+    case Cube::Type::EMPTY:
+        return 0;
+    case Cube::Type::SOLID:
+    case Cube::Type::NORMAL:
+        return 1;
+    case Cube::Type::OCTANT:
+        break;
+    }
+    std::size_t count = 0;
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        count += count_leaves(pool, pool.child(idx, child_id));
+    }
+    return count;
+}
+
+/// Check the geometry count of every octant of the subtree.
+void expect_geometry_counts(const CubePool &pool, const CubePool::Index idx) {
+    EXPECT_EQ(pool.count_geometry_cubes(idx), count_leaves(pool, idx));
+    if (pool.type(idx) == Cube::Type::OCTANT) {
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            expect_geometry_counts(pool, pool.child(idx, child_id));
+        }
+    }
+}
+
+/// Types and indentations of all cubes in pre-order.
+std::vector<std::pair<Cube::Type, std::array<Indentation, Cube::EDGES>>> content(const Cube &cube) {
+    std::vector<std::pair<Cube::Type, std::array<Indentation, Cube::EDGES>>> result{
+        {cube.type(), cube.indentations()}};
+    if (cube.type() == Cube::Type::OCTANT) {
+        for (const Cube &child : cube.childs()) {
+            const auto child_content = content(child);
+            result.insert(result.end(), child_content.begin(), child_content.end());
+        }
+    }
+    return result;
+}
+
+TEST(CubePool, ChildAndParentRoundTrip) {
+    Cube root(4.0F, {1.0F, 2.0F, 3.0F});
+    root.set_type(Cube::Type::OCTANT);
+    root[5].set_type(Cube::Type::OCTANT);
+    const CubePool &pool = *root.pool();
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        const CubePool::Index child = pool.child(CubePool::ROOT_INDEX, child_id);
+        EXPECT_EQ(pool.parent(child), CubePool::ROOT_INDEX);
+        EXPECT_EQ(pool.child_id(child), child_id);
+        EXPECT_EQ(pool.grid_level(child), 1);
+        EXPECT_EQ(pool.type(child), child_id == 5 ? Cube::Type::OCTANT : Cube::Type::SOLID);
+
+        const CubePool::Index grandchild = pool.child(root[5].index(), child_id);
+        EXPECT_EQ(pool.parent(grandchild), root[5].index());
+        EXPECT_EQ(pool.child_id(grandchild), child_id);
+        EXPECT_EQ(pool.grid_level(grandchild), 2);
+        EXPECT_EQ(pool.size(grandchild), 1.0F);
+        EXPECT_EQ(pool.position(grandchild),
+                  root[5].position() + CubePool::child_offset(child_id, pool.size(grandchild)));
+    }
+    EXPECT_EQ(pool.parent(CubePool::ROOT_INDEX), CubePool::INVALID_INDEX);
+    EXPECT_EQ(root[5].position(), glm::vec3(3.0F, 2.0F, 5.0F));
+
+    root[5].set_type(Cube::Type::NORMAL);
+    EXPECT_EQ(root[5].type(), Cube::Type::NORMAL);
+    EXPECT_EQ(root[5].indentations(), (std::array<Indentation, Cube::EDGES>{}));
+    root.set_type(Cube::Type::EMPTY);
+    EXPECT_EQ(root.type(), Cube::Type::EMPTY);
+    EXPECT_EQ(root.count_geometry_cubes(), 0);
+}
+
+TEST(CubePool, MortonCodesOfDeepCubes) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    Cube cube = root;
+    for (std::size_t level = 0; level <= MAX_MORTON_LEVEL; level++) {
+        cube.set_type(Cube::Type::OCTANT);
+        cube = cube[0];
+    }
+    const CubePool &pool = *root.pool();
+    ASSERT_EQ(cube.grid_level(), MAX_MORTON_LEVEL + 1);
+    const CubePool::Index deepest = pool.parent(cube.index());
+    EXPECT_EQ(pool.morton_code(deepest), MortonCode{1} << (3 * MAX_MORTON_LEVEL));
+    // the code would overflow
+    EXPECT_FALSE(pool.morton_code(cube.index()));
+    EXPECT_FALSE(cube.morton_code());
+
+    const glm::vec3 origin(0.0F, 0.0F, 0.0F);
+    EXPECT_EQ(pool.morton_code(origin, MAX_MORTON_LEVEL), MortonCode{1} << (3 * MAX_MORTON_LEVEL));
+    EXPECT_FALSE(pool.morton_code(origin, MAX_MORTON_LEVEL + 1));
+    EXPECT_EQ(pool.find(MortonCode{1} << (3 * MAX_MORTON_LEVEL)), deepest);
+    // the level is clamped to the deepest level of a code
+    EXPECT_EQ(pool.cube_at(origin, MAX_MORTON_LEVEL + 10), deepest);
+}
+
+TEST(CubePool, GeometryCountsAfterNestedEdits) {
+    std::mt19937 random(5);
+    std::uniform_int_distribution<int> type(0, 3);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    Cube root;
+    root.set_type(Cube::Type::OCTANT);
+    for (int edit = 0; edit < 500; edit++) {
+        Cube cube = root;
+        while (cube.type() == Cube::Type::OCTANT && random() % 4 != 0) {
+            cube = cube[child_id(random)];
+        }
+        cube.set_type(static_cast<Cube::Type>(type(random)));
+        expect_geometry_counts(*root.pool(), CubePool::ROOT_INDEX);
+    }
+}
+
+TEST(CubePool, FreeBlocksAreReused) {
+    Cube root;
+    root.set_type(Cube::Type::OCTANT);
+    root[0].set_type(Cube::Type::OCTANT);
+    root[0][3].set_type(Cube::Type::OCTANT);
+    const std::size_t capacity = root.pool()->capacity();
+    const std::size_t memory_usage = root.pool()->memory_usage();
+    ASSERT_EQ(capacity, 25);
+
+    // frees two blocks and their payloads
+    root[0].set_type(Cube::Type::EMPTY);
+    root[1].set_type(Cube::Type::OCTANT);
+    root[1][7].set_type(Cube::Type::OCTANT);
+    EXPECT_EQ(root.pool()->capacity(), capacity);
+    EXPECT_EQ(root.pool()->memory_usage(), memory_usage);
+    expect_geometry_counts(*root.pool(), CubePool::ROOT_INDEX);
+    for (const Cube &child : root[1][7].childs()) {
+        EXPECT_EQ(child.type(), Cube::Type::SOLID);
+        EXPECT_EQ(child.grid_level(), 3);
+    }
+}
+
+TEST(CubePool, CompactMergesUniformSubtrees) {
+    Cube root;
+    root.set_type(Cube::Type::OCTANT);
+    // eight solid children
+    root[2].set_type(Cube::Type::OCTANT);
+    // uniform after its children are merged
+    root[5].set_type(Cube::Type::OCTANT);
+    for (Cube child : root[5].childs()) {
+        child.set_type(Cube::Type::OCTANT);
+        for (Cube grandchild : child.childs()) {
+            grandchild.set_type(Cube::Type::EMPTY);
+        }
+    }
+    // Type::NORMAL children are not uniform
+    root[6].set_type(Cube::Type::OCTANT);
+    for (Cube child : root[6].childs()) {
+        child.set_type(Cube::Type::NORMAL);
+    }
+    root[7].set_type(Cube::Type::OCTANT);
+    root[7][4].set_type(Cube::Type::EMPTY);
+    CubePool &pool = *root.pool();
+    const std::size_t capacity = pool.capacity();
+
+    const std::size_t reclaimed = pool.compact(CubePool::ROOT_INDEX);
+    EXPECT_GT(reclaimed, 0);
+    EXPECT_EQ(pool.reclaimed_bytes(), reclaimed);
+    EXPECT_EQ(root.type(), Cube::Type::OCTANT);
+    EXPECT_EQ(root[2].type(), Cube::Type::SOLID);
+    EXPECT_EQ(root[5].type(), Cube::Type::EMPTY);
+    EXPECT_EQ(root[6].type(), Cube::Type::OCTANT);
+    EXPECT_EQ(root[7].type(), Cube::Type::OCTANT);
+    EXPECT_EQ(root[7][4].type(), Cube::Type::EMPTY);
+    EXPECT_EQ(root.count_geometry_cubes(), 5 + 8 + 7);
+    expect_geometry_counts(pool, CubePool::ROOT_INDEX);
+    EXPECT_EQ(pool.compact(CubePool::ROOT_INDEX), 0);
+
+    // the merged blocks are used again
+    root[5].set_type(Cube::Type::OCTANT);
+    root[5][0].set_type(Cube::Type::OCTANT);
+    EXPECT_EQ(pool.capacity(), capacity);
+    expect_geometry_counts(pool, CubePool::ROOT_INDEX);
+
+    // a whole uniform octree becomes a single cube
+    root[5].set_type(Cube::Type::SOLID);
+    root[6].set_type(Cube::Type::SOLID);
+    root[7][4].set_type(Cube::Type::SOLID);
+    root[0].set_type(Cube::Type::SOLID);
+    EXPECT_GT(pool.compact(CubePool::ROOT_INDEX), 0);
+    EXPECT_EQ(root.type(), Cube::Type::SOLID);
+    EXPECT_EQ(root.count_geometry_cubes(), 1);
+}
+
+TEST(CubePool, CloneIsIndependentAfterWrite) {
+    Cube root;
+    root.set_type(Cube::Type::OCTANT);
+    root[2].set_type(Cube::Type::NORMAL);
+    root[2].indent(4, true, 3);
+    root[6].set_type(Cube::Type::OCTANT);
+    root[6][1].set_type(Cube::Type::EMPTY);
+    const auto original_content = content(root);
+
+    Cube clone = root.clone();
+    EXPECT_EQ(content(clone), original_content);
+    clone[2].indent(4, true, 1);
+    clone[6].set_type(Cube::Type::SOLID);
+    clone[0].set_type(Cube::Type::OCTANT);
+    EXPECT_EQ(content(root), original_content);
+    const auto clone_content = content(clone);
+    EXPECT_NE(clone_content, original_content);
+
+    root[2].set_type(Cube::Type::EMPTY);
+    EXPECT_EQ(content(clone), clone_content);
+    expect_geometry_counts(*root.pool(), CubePool::ROOT_INDEX);
+    expect_geometry_counts(*clone.pool(), CubePool::ROOT_INDEX);
+
+    // a clone of a subtree is a new root cube
+    const Cube subtree = clone[0].clone();
+    EXPECT_TRUE(subtree.is_root());
+    EXPECT_EQ(subtree.size(), clone[0].size());
+    EXPECT_EQ(content(subtree), content(clone[0]));
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
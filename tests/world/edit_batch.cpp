@@ -0,0 +1,113 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/edit_batch.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+std::vector<Cube::Type> pre_order_types(const Cube &cube) {
+    std::vector<Cube::Type> types;
+    for (const TraversalNode &node : pre_order(*cube.pool(), cube.index())) {
+        types.push_back(cube.pool()->type(node.index));
+    }
+    return types;
+}
+
+/// The code of the cube reached by the child ids from the root cube.
+MortonCode code_of(const std::vector<std::size_t> &child_ids) {
+    MortonCode code{1};
+    for (const std::size_t child_id : child_ids) {
+        code = morton_child(code, child_id);
+    }
+    return code;
+}
+
+TEST(EditBatch, NoOpEditsKeepCompactTree) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.pool()->set_auto_compact(true);
+    root.set_type(Cube::Type::OCTANT);
+    root[3].set_type(Cube::Type::EMPTY);
+    const std::vector<Cube::Type> types = pre_order_types(root);
+    ASSERT_EQ(types.size(), 9);
+
+    EditBatch batch(root);
+    batch.set_type(code_of({0, 5, 2}), Cube::Type::SOLID);
+    batch.set_type(code_of({3, 1}), Cube::Type::EMPTY);
+    batch.set_type(code_of({3, 7, 7, 7}), Cube::Type::EMPTY);
+    batch.set_type(code_of({6, 6}), Cube::Type::SOLID);
+    batch.apply();
+    EXPECT_EQ(pre_order_types(root), types);
+    EXPECT_EQ(root.count_geometry_cubes(), 7);
+}
+
+TEST(EditBatch, RejectsCubesWithoutMortonCode) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    Cube parent = root;
+    for (std::size_t level = 0; level < MAX_MORTON_LEVEL; level++) {
+        parent.set_type(Cube::Type::OCTANT);
+        parent = parent[0];
+    }
+    parent.set_type(Cube::Type::OCTANT);
+    const Cube cube = parent[0];
+    ASSERT_EQ(cube.grid_level(), MAX_MORTON_LEVEL + 1);
+    EXPECT_EQ(parent.morton_code(), code_of(std::vector<std::size_t>(MAX_MORTON_LEVEL, 0)));
+    EXPECT_FALSE(cube.morton_code());
+    // the search stops at the deepest level with a code
+    EXPECT_EQ(root.cube_at({0.0F, 0.0F, 0.0F}, MAX_MORTON_LEVEL + 1)->index(), parent.index());
+
+    EditBatch batch(root);
+    EXPECT_FALSE(batch.set_type(cube, Cube::Type::EMPTY));
+    EXPECT_FALSE(batch.indent(cube, 0, true, 1));
+    batch.apply();
+    EXPECT_EQ(cube.type(), Cube::Type::SOLID);
+    EXPECT_TRUE(batch.set_type(parent, Cube::Type::EMPTY));
+    batch.apply();
+    EXPECT_EQ(parent.type(), Cube::Type::EMPTY);
+}
+
+TEST(EditBatch, MatchesSingleEdits) {
+    std::mt19937 random(3);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    std::uniform_int_distribution<std::size_t> level(0, 4);
+    std::uniform_int_distribution<int> type(0, 3);
+    for (int round = 0; round < 20; round++) {
+        Cube batched(8.0F, {0.0F, 0.0F, 0.0F});
+        Cube single(8.0F, {0.0F, 0.0F, 0.0F});
+        EditBatch batch(batched);
+        for (int edit = 0; edit < 50; edit++) {
+            std::vector<std::size_t> child_ids(level(random));
+            for (auto &id : child_ids) {
+                id = child_id(random);
+            }
+            const auto new_type = static_cast<Cube::Type>(type(random));
+            batch.set_type(code_of(child_ids), new_type);
+            // create the cube like the batch does
+            Cube cube = single;
+            for (const std::size_t id : child_ids) {
+                if (cube.type() != Cube::Type::OCTANT) {
+                    const Cube::Type leaf_type = cube.type();
+                    cube.set_type(Cube::Type::OCTANT);
+                    for (Cube child : cube.childs()) {
+                        child.set_type(leaf_type);
+                    }
+                }
+                cube = cube[id];
+            }
+            cube.set_type(new_type);
+        }
+        batch.apply();
+        EXPECT_EQ(pre_order_types(batched), pre_order_types(single));
+        EXPECT_EQ(batched.count_geometry_cubes(), single.count_geometry_cubes());
+    }
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
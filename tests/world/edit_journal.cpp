@@ -0,0 +1,161 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/edit_journal.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Types and indentations of all cubes in pre-order.
+std::vector<std::pair<Cube::Type, std::array<Indentation, Cube::EDGES>>> content(const Cube &cube) {
+    std::vector<std::pair<Cube::Type, std::array<Indentation, Cube::EDGES>>> result{
+        {cube.type(), cube.indentations()}};
+    if (cube.type() == Cube::Type::OCTANT) {
+        for (const Cube &child : cube.childs()) {
+            const auto child_content = content(child);
+            result.insert(result.end(), child_content.begin(), child_content.end());
+        }
+    }
+    return result;
+}
+
+/// Bytes of a record of EditJournal::set_indent(), including its size.
+constexpr std::size_t SET_INDENT_RECORD_BYTES{9 + 3 + sizeof(std::uint32_t)};
+
+TEST(EditJournal, UndoSetTypeRestoresSubtree) {
+    Cube root;
+    EditJournal journal(root, 1 << 20);
+    journal.set_type(root, Cube::Type::OCTANT);
+    journal.set_type(root[1], Cube::Type::OCTANT);
+    journal.set_type(root[1][4], Cube::Type::NORMAL);
+    journal.indent(root[1][4], 7, true, 2);
+    journal.set_type(root[1][6], Cube::Type::OCTANT);
+    journal.set_type(root[1][6][0], Cube::Type::EMPTY);
+    journal.set_type(root[1][6][3], Cube::Type::NORMAL);
+    journal.set_indent(root[1][6][3], 2, Indentation(3, 6));
+    const auto before = content(root);
+    const std::size_t geometry_cubes = root.count_geometry_cubes();
+
+    // deletes the whole subtree
+    journal.set_type(root[1], Cube::Type::EMPTY);
+    const auto after = content(root);
+    ASSERT_EQ(after.size(), 9);
+
+    ASSERT_TRUE(journal.undo());
+    EXPECT_EQ(content(root), before);
+    EXPECT_EQ(root.count_geometry_cubes(), geometry_cubes);
+    ASSERT_TRUE(journal.redo());
+    EXPECT_EQ(content(root), after);
+    EXPECT_FALSE(journal.redo());
+    ASSERT_TRUE(journal.undo());
+    EXPECT_EQ(content(root), before);
+
+    // back to the solid root cube
+    while (journal.undo()) {
+    }
+    EXPECT_EQ(root.type(), Cube::Type::SOLID);
+    EXPECT_EQ(journal.undo_count(), 0);
+    EXPECT_EQ(journal.redo_count(), 9);
+}
+
+TEST(EditJournal, UndoIndentations) {
+    Cube root;
+    root.set_type(Cube::Type::OCTANT);
+    root[2].set_type(Cube::Type::NORMAL);
+    EditJournal journal(root, 1 << 20);
+
+    std::vector<std::vector<std::pair<Cube::Type, std::array<Indentation, Cube::EDGES>>>> states{content(root)};
+    journal.set_indent(root[2], 0, Indentation(2, 5));
+    states.push_back(content(root));
+    journal.indent(root[2], 0, false, 1);
+    states.push_back(content(root));
+    journal.indent(root[2], 11, true, 4);
+    states.push_back(content(root));
+    journal.rotate(root[2], Cube::RotationAxis::Y, 1);
+    states.push_back(content(root));
+    journal.set_indent(root[2], 5, Indentation(8, 8));
+    states.push_back(content(root));
+    for (std::size_t i = 1; i < states.size(); i++) {
+        EXPECT_NE(states[i], states[i - 1]);
+    }
+
+    for (std::size_t i = states.size() - 1; i > 0; i--) {
+        ASSERT_TRUE(journal.undo());
+        EXPECT_EQ(content(root), states[i - 1]);
+    }
+    EXPECT_FALSE(journal.undo());
+    for (std::size_t i = 1; i < states.size(); i++) {
+        ASSERT_TRUE(journal.redo());
+        EXPECT_EQ(content(root), states[i]);
+    }
+}
+
+TEST(EditJournal, BudgetDropsUndoneRecordsFirst) {
+    Cube root;
+    root.set_type(Cube::Type::NORMAL);
+    EditJournal journal(root, 3 * SET_INDENT_RECORD_BYTES);
+    journal.set_indent(root, 0, Indentation(1, 8));
+    journal.set_indent(root, 1, Indentation(2, 8));
+    journal.set_indent(root, 2, Indentation(3, 8));
+    EXPECT_EQ(journal.memory_usage(), 3 * SET_INDENT_RECORD_BYTES);
+    ASSERT_TRUE(journal.undo());
+    ASSERT_TRUE(journal.undo());
+
+    // the last undone record is dropped first
+    journal.set_memory_budget(2 * SET_INDENT_RECORD_BYTES);
+    EXPECT_EQ(journal.undo_count(), 1);
+    EXPECT_EQ(journal.redo_count(), 1);
+    ASSERT_TRUE(journal.redo());
+    EXPECT_EQ(root.indentations()[1], Indentation(2, 8));
+    EXPECT_FALSE(journal.redo());
+    ASSERT_TRUE(journal.undo());
+
+    journal.set_memory_budget(SET_INDENT_RECORD_BYTES);
+    EXPECT_EQ(journal.undo_count(), 1);
+    EXPECT_EQ(journal.redo_count(), 0);
+    EXPECT_EQ(journal.memory_usage(), SET_INDENT_RECORD_BYTES);
+
+    // then the oldest applied record
+    journal.set_indent(root, 3, Indentation(4, 8));
+    EXPECT_EQ(journal.undo_count(), 1);
+    ASSERT_TRUE(journal.undo());
+    EXPECT_EQ(root.indentations()[3], Indentation());
+    EXPECT_EQ(root.indentations()[0], Indentation(1, 8));
+    EXPECT_FALSE(journal.undo());
+
+    journal.set_memory_budget(0);
+    EXPECT_EQ(journal.redo_count(), 0);
+    EXPECT_EQ(journal.memory_usage(), 0);
+}
+
+TEST(EditJournal, RejectsCubesWithoutMortonCode) {
+    Cube root;
+    Cube parent = root;
+    for (std::size_t level = 0; level < MAX_MORTON_LEVEL; level++) {
+        parent.set_type(Cube::Type::OCTANT);
+        parent = parent[7];
+    }
+    parent.set_type(Cube::Type::OCTANT);
+    const Cube cube = parent[7];
+    EditJournal journal(root, 1024);
+    EXPECT_FALSE(journal.set_type(cube, Cube::Type::NORMAL));
+    EXPECT_FALSE(journal.rotate(cube, Cube::RotationAxis::X, 1));
+    EXPECT_EQ(cube.type(), Cube::Type::SOLID);
+    EXPECT_EQ(journal.undo_count(), 0);
+
+    EXPECT_TRUE(journal.set_type(parent, Cube::Type::EMPTY));
+    ASSERT_TRUE(journal.undo());
+    EXPECT_EQ(parent.type(), Cube::Type::OCTANT);
+    EXPECT_EQ(parent[7].type(), Cube::Type::SOLID);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
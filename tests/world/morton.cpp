@@ -0,0 +1,58 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+TEST(Morton, EncodeDecodeRoundTrip) {
+    EXPECT_EQ(morton_code({0, 0, 0}, 0), 1);
+    EXPECT_EQ(morton_level(1), 0);
+    // x is the highest bit of a level
+    EXPECT_EQ(morton_code({1, 0, 0}, 1), 0b1100);
+    EXPECT_EQ(morton_code({0, 1, 0}, 1), 0b1010);
+    EXPECT_EQ(morton_code({0, 0, 1}, 1), 0b1001);
+    EXPECT_EQ(morton_code({2, 1, 3}, 2), 0b1'101'011);
+
+    std::mt19937 random(1);
+    for (std::size_t level = 0; level <= MAX_MORTON_LEVEL; level++) {
+        std::uniform_int_distribution<std::uint32_t> coordinate(0, (std::uint32_t{1} << level) - 1);
+        for (int i = 0; i < 100; i++) {
+            const glm::uvec3 cell(coordinate(random), coordinate(random), coordinate(random));
+            const MortonCode code = morton_code(cell, level);
+            EXPECT_EQ(morton_level(code), level);
+            EXPECT_EQ(morton_cell(code), cell) << "level " << level;
+        }
+    }
+    // the largest cell of the deepest level uses all bits of the code
+    const std::uint32_t last = (std::uint32_t{1} << MAX_MORTON_LEVEL) - 1;
+    const MortonCode code = morton_code({last, last, last}, MAX_MORTON_LEVEL);
+    EXPECT_EQ(code, (MortonCode{1} << (3 * MAX_MORTON_LEVEL + 1)) - 1);
+    EXPECT_EQ(morton_cell(code), glm::uvec3(last));
+}
+
+TEST(Morton, ChildAndParent) {
+    std::mt19937 random(2);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    MortonCode code = 1;
+    glm::uvec3 cell(0);
+    for (std::size_t level = 1; level <= MAX_MORTON_LEVEL; level++) {
+        const std::size_t id = child_id(random);
+        const MortonCode child = morton_child(code, id);
+        EXPECT_EQ(morton_level(child), level);
+        EXPECT_EQ(morton_parent(child), code);
+        // the child id is the offset of the child within the cells of the parent
+        cell = cell * 2U + glm::uvec3((id >> 2U) & 1U, (id >> 1U) & 1U, id & 1U);
+        EXPECT_EQ(morton_cell(child), cell) << "level " << level;
+        EXPECT_EQ(morton_code(cell, level), child);
+        code = child;
+    }
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,54 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+#include "inexor/vulkan-renderer/world/morton_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+TEST(MortonIndex, FindsCubesAndLeaves) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    root[3].set_type(Cube::Type::OCTANT);
+    root[3][5].set_type(Cube::Type::OCTANT);
+    root[6].set_type(Cube::Type::EMPTY);
+    MortonIndex index(root.pool(), 2);
+    EXPECT_EQ(index.level(), 2);
+
+    EXPECT_EQ(index.find(1), root.index());
+    EXPECT_EQ(index.find(morton_child(1, 6)), root[6].index());
+    const MortonCode parent = morton_child(1, 3);
+    EXPECT_EQ(index.find(morton_child(parent, 5)), root[3][5].index());
+    // a cube below a leaf cube is found as the leaf cube
+    EXPECT_EQ(index.find(morton_child(morton_child(1, 6), 2)), root[6].index());
+    // cubes deeper than the index are found as their parent at the level of the index
+    EXPECT_EQ(index.find(morton_child(morton_child(parent, 5), 1)), root[3][5].index());
+
+    // every cube up to the level of the index is found at its code
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        const Cube cube = root[3][child_id];
+        EXPECT_EQ(index.find(*cube.morton_code()), cube.index());
+        EXPECT_EQ(index.find(*cube.morton_code()), root.pool()->find(*cube.morton_code()));
+    }
+}
+
+TEST(MortonIndex, RebuiltAfterStructureChange) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    MortonIndex index(root.pool(), 3);
+    const MortonCode code = morton_child(morton_child(1, 2), 7);
+    EXPECT_EQ(index.find(code), root.index());
+
+    root.set_type(Cube::Type::OCTANT);
+    root[2].set_type(Cube::Type::OCTANT);
+    EXPECT_EQ(index.find(code), root[2][7].index());
+
+    root[2].set_type(Cube::Type::SOLID);
+    EXPECT_EQ(index.find(code), root[2].index());
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
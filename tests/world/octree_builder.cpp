@@ -0,0 +1,127 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/octree_builder.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+constexpr float ROOT_SIZE{16.0F};
+const glm::vec3 ROOT_POSITION{-2.0F, 0.0F, 5.0F};
+
+/// Type, indentations and geometry count of all cubes in pre-order.
+std::vector<std::tuple<Cube::Type, std::array<Indentation, Cube::EDGES>, std::size_t>> content(const Cube &cube) {
+    const CubePool &pool = *cube.pool();
+    std::vector<std::tuple<Cube::Type, std::array<Indentation, Cube::EDGES>, std::size_t>> result;
+    for (const TraversalNode &node : pre_order(pool, cube.index())) {
+        const Cube::Type type = pool.type(node.index);
+        result.emplace_back(type,
+                            type == Cube::Type::NORMAL ? pool.indentations(node.index)
+                                                       : std::array<Indentation, Cube::EDGES>{},
+                            pool.count_geometry_cubes(node.index));
+    }
+    return result;
+}
+
+/// Build the octree by setting every voxel on its own, followed by CubePool::compact().
+Cube build_by_edits(const VoxelGrid &grid) {
+    Cube root(ROOT_SIZE, ROOT_POSITION);
+    const std::uint32_t resolution = grid.resolution();
+    for (std::uint32_t x = 0; x < resolution; x++) {
+        for (std::uint32_t y = 0; y < resolution; y++) {
+            for (std::uint32_t z = 0; z < resolution; z++) {
+                Cube cube = root;
+                for (std::size_t level = grid.level(); level-- > 0;) {
+                    if (cube.type() != Cube::Type::OCTANT) {
+                        cube.set_type(Cube::Type::OCTANT);
+                    }
+                    cube = cube[((x >> level) & 1U) << 2U | ((y >> level) & 1U) << 1U | ((z >> level) & 1U)];
+                }
+                const glm::uvec3 cell{x, y, z};
+                cube.set_type(grid.type(cell));
+                if (grid.type(cell) == Cube::Type::NORMAL) {
+                    root.pool()->set_indentations(cube.index(), grid.indentations(cell));
+                }
+            }
+        }
+    }
+    (void)root.pool()->compact(CubePool::ROOT_INDEX);
+    return root;
+}
+
+/// Compare the builder with single edits, also after editing both octrees the same way.
+void expect_equal_to_edits(const VoxelGrid &grid) {
+    for (const std::size_t thread_count : {1, 4}) {
+        Cube built = OctreeBuilder(thread_count).build(grid, ROOT_SIZE, ROOT_POSITION);
+        Cube edited = build_by_edits(grid);
+        EXPECT_EQ(built.size(), ROOT_SIZE);
+        EXPECT_EQ(built.position(), ROOT_POSITION);
+        EXPECT_EQ(content(built), content(edited));
+
+        // the free lists of the built pool are used
+        for (Cube *cube : {&built, &edited}) {
+            cube->set_type(Cube::Type::OCTANT);
+            (*cube)[3].set_type(Cube::Type::NORMAL);
+            (*cube)[3].indent(5, true, 2);
+            (*cube)[6].set_type(Cube::Type::EMPTY);
+        }
+        EXPECT_EQ(content(built), content(edited));
+    }
+}
+
+TEST(OctreeBuilder, EqualToEdits) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> uid(0, Indentation::MAX_UID);
+    for (const std::size_t level : {1, 3, 4}) {
+        VoxelGrid grid(level);
+        const std::uint32_t resolution = grid.resolution();
+        for (std::uint32_t x = 0; x < resolution; x++) {
+            for (std::uint32_t y = 0; y < resolution; y++) {
+                for (std::uint32_t z = 0; z < resolution; z++) {
+                    // solid below a random surface, so whole octants are uniform
+                    const auto height = static_cast<std::uint32_t>(random() % (resolution + 1));
+                    if (z < height) {
+                        grid.set({x, y, z}, Cube::Type::SOLID);
+                    } else if (z == height && random() % 2 == 0) {
+                        std::array<Indentation, Cube::EDGES> indentations;
+                        for (auto &indentation : indentations) {
+                            indentation = Indentation(static_cast<std::uint8_t>(uid(random)));
+                        }
+                        grid.set({x, y, z}, Cube::Type::NORMAL, indentations);
+                    }
+                }
+            }
+        }
+        expect_equal_to_edits(grid);
+    }
+}
+
+TEST(OctreeBuilder, SingleVoxel) {
+    for (const Cube::Type type : {Cube::Type::EMPTY, Cube::Type::SOLID, Cube::Type::NORMAL}) {
+        VoxelGrid grid(0);
+        std::array<Indentation, Cube::EDGES> indentations{};
+        indentations[2] = Indentation(3, 7);
+        grid.set({0, 0, 0}, type, indentations);
+        expect_equal_to_edits(grid);
+    }
+}
+
+TEST(OctreeBuilder, EmptyGrid) {
+    const VoxelGrid grid(3);
+    const Cube cube = OctreeBuilder(4).build(grid, ROOT_SIZE, ROOT_POSITION);
+    EXPECT_EQ(cube.type(), Cube::Type::EMPTY);
+    EXPECT_EQ(cube.count_geometry_cubes(), 0);
+    expect_equal_to_edits(grid);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
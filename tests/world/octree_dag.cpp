@@ -0,0 +1,132 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/morton.hpp"
+#include "inexor/vulkan-renderer/world/octree_dag.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Types and indentations of all cubes in pre-order.
+std::vector<std::pair<Cube::Type, std::array<Indentation, Cube::EDGES>>> content(const Cube &cube) {
+    std::vector<std::pair<Cube::Type, std::array<Indentation, Cube::EDGES>>> result{
+        {cube.type(), cube.indentations()}};
+    if (cube.type() == Cube::Type::OCTANT) {
+        for (const Cube &child : cube.childs()) {
+            const auto child_content = content(child);
+            result.insert(result.end(), child_content.begin(), child_content.end());
+        }
+    }
+    return result;
+}
+
+/// An octree whose octants contain copies of the same two subtrees.
+Cube repeated_octree() {
+    Cube root(16.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    for (Cube child : root.childs()) {
+        child.set_type(Cube::Type::OCTANT);
+        child[0].set_type(Cube::Type::EMPTY);
+        child[5].set_type(Cube::Type::NORMAL);
+        child[5].indent(3, true, 2);
+    }
+    root[6][2].set_type(Cube::Type::OCTANT);
+    root[6][2][1].set_type(Cube::Type::NORMAL);
+    root[6][2][1].set_indent(9, Indentation(1, 4));
+    return root;
+}
+
+TEST(OctreeDag, SharesIdenticalSubtrees) {
+    const Cube cube = repeated_octree();
+    const OctreeDag dag(cube);
+    // empty, solid, two normal leaves, two kinds of octants at level 1 and 2, the root
+    EXPECT_EQ(dag.node_count(), 8);
+    EXPECT_EQ(dag.cube_count(), content(cube).size());
+    EXPECT_EQ(dag.child(dag.root(), 0), dag.child(dag.root(), 7));
+    EXPECT_NE(dag.child(dag.root(), 0), dag.child(dag.root(), 6));
+    EXPECT_GT(dag.compression_ratio(), 0.0);
+}
+
+TEST(OctreeDag, ToCubeEqualsOctree) {
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> type(0, 3);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    std::uniform_int_distribution<int> uid(0, Indentation::MAX_UID);
+    Cube cube(8.0F, {1.0F, 2.0F, 3.0F});
+    for (int edit = 0; edit < 300; edit++) {
+        Cube edited = cube;
+        while (edited.type() == Cube::Type::OCTANT) {
+            edited = edited[child_id(random)];
+        }
+        edited.set_type(static_cast<Cube::Type>(type(random)));
+        if (edited.type() == Cube::Type::NORMAL) {
+            edited.set_indent(static_cast<std::uint8_t>(child_id(random)),
+                              Indentation(static_cast<std::uint8_t>(uid(random))));
+        }
+    }
+    const OctreeDag dag(cube);
+    const Cube expanded = dag.to_cube(cube.size(), cube.position());
+    EXPECT_EQ(expanded.size(), cube.size());
+    EXPECT_EQ(expanded.position(), cube.position());
+    EXPECT_EQ(content(expanded), content(cube));
+    EXPECT_EQ(expanded.count_geometry_cubes(), cube.count_geometry_cubes());
+}
+
+TEST(OctreeDag, EditsMatchCubeEdits) {
+    Cube cube = repeated_octree();
+    OctreeDag dag(cube);
+    const MortonCode code = morton_child(morton_child(1, 3), 5);
+    dag.set_type(code, Cube::Type::OCTANT);
+    dag.set_type(morton_child(code, 4), Cube::Type::EMPTY);
+    cube[3][5].set_type(Cube::Type::OCTANT);
+    cube[3][5][4].set_type(Cube::Type::EMPTY);
+    std::array<Indentation, Cube::EDGES> indentations{};
+    indentations[1] = Indentation(2, 2);
+    dag.set_indentations(morton_child(1, 1), indentations);
+    cube[1].set_type(Cube::Type::NORMAL);
+    cube[1].set_indent(1, Indentation(2, 2));
+    EXPECT_EQ(content(dag.to_cube(cube.size(), cube.position())), content(cube));
+}
+
+TEST(OctreeDag, CollectGarbageRemapsIds) {
+    Cube cube = repeated_octree();
+    OctreeDag dag(cube);
+    // every edit copies the path, the old copies become garbage
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        dag.set_type(morton_child(morton_child(1, child_id), 5), Cube::Type::SOLID);
+        cube[child_id][5].set_type(Cube::Type::SOLID);
+    }
+    const std::size_t node_count = dag.node_count();
+    const std::uint64_t cube_count = dag.cube_count();
+    const auto expected = content(cube);
+    ASSERT_EQ(content(dag.to_cube(cube.size(), cube.position())), expected);
+
+    const std::size_t removed = dag.collect_garbage();
+    EXPECT_GT(removed, 0);
+    EXPECT_EQ(dag.node_count(), node_count - removed);
+    EXPECT_LT(dag.root(), dag.node_count());
+    EXPECT_EQ(dag.cube_count(), cube_count);
+    EXPECT_EQ(content(dag.to_cube(cube.size(), cube.position())), expected);
+    EXPECT_EQ(dag.collect_garbage(), 0);
+
+    // the remapped nodes are found again
+    std::array<OctreeDag::NodeId, Cube::SUB_CUBES> children{};
+    for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+        children[child_id] = dag.child(dag.root(), child_id);
+    }
+    EXPECT_EQ(dag.octant(children), dag.root());
+    EXPECT_EQ(dag.node_count(), node_count - removed);
+    dag.set_type(morton_child(1, 6), Cube::Type::EMPTY);
+    cube[6].set_type(Cube::Type::EMPTY);
+    EXPECT_EQ(content(dag.to_cube(cube.size(), cube.position())), content(cube));
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
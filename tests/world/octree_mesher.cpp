@@ -0,0 +1,277 @@
+#include "inexor/vulkan-renderer/camera.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/octree_mesher.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Random octants, solid and indented cubes.
+Cube random_octree(const std::uint32_t seed) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    std::uniform_int_distribution<int> type(0, 3);
+    std::uniform_int_distribution<int> steps(1, 3);
+    for (int edit = 0; edit < 80; edit++) {
+        Cube cube = root;
+        while (cube.type() == Cube::Type::OCTANT && cube.grid_level() < 4) {
+            cube = cube[child_id(random)];
+        }
+        cube.set_type(static_cast<Cube::Type>(type(random)));
+        if (cube.type() == Cube::Type::NORMAL) {
+            cube.indent(static_cast<std::uint8_t>(child_id(random)), random() % 2 == 0,
+                        static_cast<std::uint8_t>(steps(random)));
+        }
+    }
+    return root;
+}
+
+void expect_equal_regions(const OctreeMesher &mesher, const OctreeMesher &expected) {
+    ASSERT_EQ(mesher.regions().size(), expected.regions().size());
+    auto expected_region = expected.regions().begin();
+    for (const auto &[key, region] : mesher.regions()) {
+        EXPECT_EQ(key, expected_region->first);
+        EXPECT_EQ(region.grid_level, expected_region->second.grid_level);
+        EXPECT_EQ(region.position, expected_region->second.position);
+        EXPECT_EQ(region.size, expected_region->second.size);
+        EXPECT_EQ(region.polygons, expected_region->second.polygons) << "region " << key;
+        EXPECT_EQ(region.lods, expected_region->second.lods) << "region " << key;
+        ++expected_region;
+    }
+}
+
+TEST(OctreeMesher, UpdateEqualsRebuild) {
+    Cube root = random_octree(1);
+    OctreeMesher mesher(root, 2);
+    ASSERT_GT(mesher.polygon_count(), 0);
+    EXPECT_TRUE(mesher.update().empty());
+
+    // a single edit only remeshes its region
+    Cube cube = root;
+    while (cube.type() == Cube::Type::OCTANT) {
+        cube = cube[3];
+    }
+    cube.set_type(cube.type() == Cube::Type::SOLID ? Cube::Type::EMPTY : Cube::Type::SOLID);
+    const std::vector<OctreeMesher::ChangedRegion> changed = mesher.update();
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0].size, 2.0F);
+    for (int axis = 0; axis < 3; axis++) {
+        EXPECT_LE(changed[0].position[axis], cube.position()[axis]);
+        EXPECT_GE(changed[0].position[axis] + changed[0].size, cube.position()[axis] + cube.size());
+    }
+    expect_equal_regions(mesher, OctreeMesher(root, 2));
+
+    std::mt19937 random(2);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    std::uniform_int_distribution<int> type(0, 3);
+    for (int round = 0; round < 10; round++) {
+        for (int edit = 0; edit < 5; edit++) {
+            cube = root;
+            while (cube.type() == Cube::Type::OCTANT && random() % 4 != 0) {
+                cube = cube[child_id(random)];
+            }
+            cube.set_type(static_cast<Cube::Type>(type(random)));
+            if (cube.type() == Cube::Type::NORMAL) {
+                cube.indent(static_cast<std::uint8_t>(child_id(random)), true, 1);
+            }
+        }
+        static_cast<void>(mesher.update());
+        expect_equal_regions(mesher, OctreeMesher(root, 2));
+    }
+}
+
+/// Does any polygon lie in the plane x = 4.
+bool has_polygon_at_x4(const OctreeMesher &mesher) {
+    for (const auto &[key, region] : mesher.regions()) {
+        for (const Polygon &polygon : region.polygons) {
+            if (polygon[0].x == 4.0F && polygon[1].x == 4.0F && polygon[2].x == 4.0F) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+TEST(OctreeMesher, CullsFacesBetweenSolidNeighbors) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    for (Cube child : root.childs()) {
+        child.set_type(Cube::Type::EMPTY);
+    }
+    // child 4 is the neighbor of child 0 in positive x direction
+    root[0].set_type(Cube::Type::SOLID);
+    root[4].set_type(Cube::Type::SOLID);
+    for (const std::size_t region_level : {0, 1, 2}) {
+        const OctreeMesher mesher(root, region_level);
+        EXPECT_EQ(mesher.polygon_count(), 2 * 12 - 2 * 2) << "region level " << region_level;
+        EXPECT_FALSE(has_polygon_at_x4(mesher));
+    }
+
+    // across grid levels
+    root[4].set_type(Cube::Type::OCTANT);
+    OctreeMesher mesher(root, 1);
+    EXPECT_EQ(mesher.polygon_count(), 12 - 2 + 8 * 12 - 4 * 2 - 12 * 2 * 2);
+    EXPECT_FALSE(has_polygon_at_x4(mesher));
+
+    // a partially covered face stays visible
+    for (Cube child : root[4].childs()) {
+        child.set_type(Cube::Type::EMPTY);
+    }
+    root[4][0].set_type(Cube::Type::SOLID);
+    static_cast<void>(mesher.update());
+    EXPECT_EQ(mesher.polygon_count(), 12 + 12 - 2);
+    EXPECT_TRUE(has_polygon_at_x4(mesher));
+}
+
+/// Total area of the polygons by the axis aligned plane they are in, the other polygons by the plane key (3, 0).
+std::map<std::pair<int, float>, float> areas_by_plane(const OctreeMesher &mesher) {
+    std::map<std::pair<int, float>, float> areas;
+    for (const auto &[key, region] : mesher.regions()) {
+        for (const Polygon &polygon : region.polygons) {
+            const glm::vec3 cross = glm::cross(polygon[1] - polygon[0], polygon[2] - polygon[0]);
+            const float area = glm::length(cross) / 2.0F;
+            std::pair<int, float> plane{3, 0.0F};
+            for (int axis = 0; axis < 3; axis++) {
+                if (std::abs(cross[axis]) == 2.0F * area) {
+                    // the sign of the normal is the second face of the axis
+                    plane = {2 * axis + (cross[axis] > 0.0F ? 1 : 0), polygon[0][axis]};
+                }
+            }
+            areas[plane] += area;
+        }
+    }
+    return areas;
+}
+
+TEST(OctreeMesher, GreedyMeshingCoversSameArea) {
+    const Cube root = random_octree(3);
+    for (const std::size_t region_level : {0, 2}) {
+        const OctreeMesher mesher(root, region_level);
+        const OctreeMesher greedy(root, region_level, true);
+        EXPECT_LT(greedy.polygon_count(), mesher.polygon_count());
+        const auto areas = areas_by_plane(mesher);
+        const auto greedy_areas = areas_by_plane(greedy);
+        ASSERT_EQ(greedy_areas.size(), areas.size());
+        auto greedy_area = greedy_areas.begin();
+        for (const auto &[plane, area] : areas) {
+            EXPECT_EQ(greedy_area->first, plane);
+            EXPECT_NEAR(greedy_area->second, area, 1e-4F * area) << "face " << plane.first << ", " << plane.second;
+            ++greedy_area;
+        }
+    }
+
+    // the faces of a solid octant are merged into one rectangle each
+    Cube solid(8.0F, {0.0F, 0.0F, 0.0F});
+    solid.set_type(Cube::Type::OCTANT);
+    EXPECT_EQ(OctreeMesher(solid, 0, true).polygon_count(), CubePool::FACES * 2);
+}
+
+/// All polygons of all regions in the order of the regions.
+std::vector<Polygon> concatenated_polygons(const OctreeMesher &mesher) {
+    std::vector<Polygon> polygons;
+    for (const auto &[key, region] : mesher.regions()) {
+        polygons.insert(polygons.end(), region.polygons.begin(), region.polygons.end());
+    }
+    return polygons;
+}
+
+void expect_identical_bytes(const OctreeMesher &mesher, const OctreeMesher &expected) {
+    const std::vector<Polygon> polygons = concatenated_polygons(mesher);
+    const std::vector<Polygon> expected_polygons = concatenated_polygons(expected);
+    ASSERT_EQ(polygons.size(), expected_polygons.size());
+    EXPECT_EQ(std::memcmp(polygons.data(), expected_polygons.data(), polygons.size() * sizeof(Polygon)), 0);
+    expect_equal_regions(mesher, expected);
+}
+
+TEST(OctreeMesher, ThreadsDoNotChangeOutput) {
+    for (const bool greedy_meshing : {false, true}) {
+        // a mesher consumes the dirty flags, so every mesher gets its own octree
+        Cube root = random_octree(4);
+        Cube threaded_root = random_octree(4);
+        OctreeMesher mesher(root, 3, greedy_meshing, 1, 2);
+        OctreeMesher threaded(threaded_root, 3, greedy_meshing, 4, 2);
+        EXPECT_EQ(threaded.thread_count(), 4);
+        expect_identical_bytes(threaded, mesher);
+
+        for (Cube cube : {root, threaded_root}) {
+            cube[5].set_type(Cube::Type::SOLID);
+            cube[2].set_type(Cube::Type::OCTANT);
+            cube[2][1].set_type(Cube::Type::EMPTY);
+            cube[7].set_type(Cube::Type::OCTANT);
+            cube[7][3].set_type(Cube::Type::NORMAL);
+            cube[7][3].indent(4, true, 2);
+        }
+        const std::vector<OctreeMesher::ChangedRegion> changed = mesher.update();
+        EXPECT_EQ(threaded.update().size(), changed.size());
+        expect_identical_bytes(threaded, mesher);
+    }
+}
+
+TEST(OctreeMesher, SelectsLevelOfDetailByDistance) {
+    const OctreeMesher mesher(random_octree(5), 0, false, 1, 3);
+    ASSERT_EQ(mesher.regions().size(), 1);
+    const OctreeMesher::Region &region = mesher.regions().begin()->second;
+    ASSERT_EQ(region.lods.size(), 3);
+    // depth 0 replaces the whole region by one cube
+    EXPECT_LE(region.lods[0].size(), 12);
+    for (std::size_t depth = 1; depth < region.lods.size(); depth++) {
+        EXPECT_LE(region.lods[depth - 1].size(), region.lods[depth].size());
+    }
+    EXPECT_LE(region.lods.back().size(), region.polygons.size());
+
+    // the replacement cubes of depth d have the size 8 / 2^d
+    EXPECT_EQ(&OctreeMesher::select_lod(region, {4.0F, 4.0F, 4.0F}, 0.1F), &region.polygons);
+    EXPECT_EQ(&OctreeMesher::select_lod(region, {8.0F + 80.0F, 4.0F, 4.0F}, 0.1F), &region.lods[0]);
+    EXPECT_EQ(&OctreeMesher::select_lod(region, {8.0F + 40.0F, 4.0F, 4.0F}, 0.1F), &region.lods[1]);
+    EXPECT_EQ(&OctreeMesher::select_lod(region, {8.0F + 10.0F, 4.0F, 4.0F}, 0.1F), &region.polygons);
+}
+
+TEST(OctreeMesher, VisibleRegionsMergeAdjacentRanges) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    OctreeMesher mesher(root, 1);
+    ASSERT_EQ(mesher.regions().size(), Cube::SUB_CUBES);
+
+    // the whole octree is in front of the camera, which looks in positive y direction
+    Camera camera({4.0F, -20.0F, 4.0F}, 0.0F, 0.0F, 800.0F, 600.0F);
+    std::vector<OctreeMesher::RegionRange> ranges = mesher.visible_regions(camera.frustum_planes());
+    ASSERT_EQ(ranges.size(), 1);
+    EXPECT_EQ(ranges[0].first, 0);
+    EXPECT_EQ(ranges[0].last, Cube::SUB_CUBES);
+
+    // the children with y = 0 are behind the camera, the second bit of the child id is y
+    camera.set_position({4.0F, 6.0F, 4.0F});
+    camera.update(0.0F);
+    ranges = mesher.visible_regions(camera.frustum_planes());
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0].first, 2);
+    EXPECT_EQ(ranges[0].last, 4);
+    EXPECT_EQ(ranges[1].first, 6);
+    EXPECT_EQ(ranges[1].last, 8);
+
+    // empty regions split the ranges as well
+    root[3].set_type(Cube::Type::EMPTY);
+    static_cast<void>(mesher.update());
+    ranges = mesher.visible_regions(camera.frustum_planes());
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0].first, 2);
+    EXPECT_EQ(ranges[0].last, 3);
+    EXPECT_EQ(ranges[1].first, 6);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
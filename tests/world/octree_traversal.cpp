@@ -0,0 +1,71 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Octants nested below the first child of each other, down to the depth.
+Cube nested_octants(const std::size_t depth) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    Cube cube = root;
+    for (std::size_t level = 0; level < depth; level++) {
+        cube.set_type(Cube::Type::OCTANT);
+        cube = cube[0];
+    }
+    return root;
+}
+
+TEST(OctreeTraversal, DeeperThanFixedStack) {
+    constexpr std::size_t DEPTH{MAX_TRAVERSAL_DEPTH + 6};
+    const Cube root = nested_octants(DEPTH);
+    const CubePool &pool = *root.pool();
+
+    std::vector<std::size_t> pre_order_depths;
+    for (const TraversalNode &node : pre_order(pool, root.index())) {
+        pre_order_depths.push_back(node.depth);
+        EXPECT_EQ(node.position, pool.position(node.index));
+    }
+    ASSERT_EQ(pre_order_depths.size(), 1 + Cube::SUB_CUBES * DEPTH);
+    // the first children are visited before their siblings
+    for (std::size_t depth = 0; depth <= DEPTH; depth++) {
+        EXPECT_EQ(pre_order_depths[depth], depth);
+    }
+
+    std::vector<CubePool::Index> post_order_indices;
+    std::size_t max_depth = 0;
+    for (const TraversalNode &node : post_order(pool, root.index())) {
+        post_order_indices.push_back(node.index);
+        max_depth = std::max(max_depth, node.depth);
+    }
+    ASSERT_EQ(post_order_indices.size(), pre_order_depths.size());
+    EXPECT_EQ(max_depth, DEPTH);
+    EXPECT_EQ(post_order_indices.back(), root.index());
+
+    // the polygon cache is updated by a traversal as well
+    EXPECT_EQ(root.count_geometry_cubes(), (Cube::SUB_CUBES - 1) * DEPTH + 1);
+    std::size_t polygon_count = 0;
+    for (const PolygonSpan &polygons : root.polygons(true)) {
+        polygon_count += polygons.size();
+    }
+    EXPECT_GT(polygon_count, 0);
+}
+
+TEST(OctreeTraversal, SkipChildren) {
+    const Cube root = nested_octants(MAX_TRAVERSAL_DEPTH + 2);
+    std::size_t count = 0;
+    visit_pre_order(*root.pool(), root.index(), [&](const TraversalNode &node) {
+        count++;
+        return node.depth < MAX_TRAVERSAL_DEPTH + 1;
+    });
+    EXPECT_EQ(count, 1 + Cube::SUB_CUBES * (MAX_TRAVERSAL_DEPTH + 1));
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,124 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_versions.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// The types and indentations of all cubes in pre-order.
+void content(const Cube &cube, std::vector<std::uint32_t> &result) {
+    result.push_back(static_cast<std::uint32_t>(cube.type()));
+    if (cube.type() == Cube::Type::NORMAL) {
+        for (const Indentation &indentation : cube.indentations()) {
+            result.push_back(indentation.uid());
+        }
+    }
+    if (cube.type() == Cube::Type::OCTANT) {
+        for (std::size_t child_id = 0; child_id < Cube::SUB_CUBES; child_id++) {
+            content(cube[child_id], result);
+        }
+    }
+}
+
+std::vector<std::uint32_t> content(const Cube &cube) {
+    std::vector<std::uint32_t> result;
+    content(cube, result);
+    return result;
+}
+
+/// Polygons of all cubes, updates the polygon caches.
+std::vector<Polygon> polygons(const Cube &cube) {
+    std::vector<Polygon> result;
+    for (const PolygonSpan &span : cube.polygons(true)) {
+        result.insert(result.end(), span.begin(), span.end());
+    }
+    return result;
+}
+
+/// Change a random cube of the octree.
+void random_edit(const Cube &root, std::mt19937 &random) {
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    std::uniform_int_distribution<int> type(0, 3);
+    Cube cube = root;
+    while (cube.type() == Cube::Type::OCTANT && cube.grid_level() < 3) {
+        cube = cube[child_id(random)];
+    }
+    cube.set_type(static_cast<Cube::Type>(type(random)));
+    if (cube.type() == Cube::Type::NORMAL) {
+        cube.indent(static_cast<std::uint8_t>(child_id(random)), true, 1);
+    }
+}
+
+TEST(OctreeVersions, SnapshotIsUnchangedByLaterVersions) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    root[1].set_type(Cube::Type::OCTANT);
+    OctreeVersions versions(root);
+    const OctreeVersions::Version first = versions.acquire();
+    EXPECT_EQ(first.number, 1);
+    const std::vector<std::uint32_t> first_content = content(first.root);
+    const std::vector<Polygon> first_polygons = polygons(first.root);
+
+    std::mt19937 random(1);
+    for (std::uint64_t number = 2; number < 20; number++) {
+        for (int edit = 0; edit < 10; edit++) {
+            random_edit(versions.root(), random);
+        }
+        EXPECT_EQ(versions.publish(), number);
+        EXPECT_EQ(content(first.root), first_content);
+        EXPECT_EQ(polygons(first.root), first_polygons);
+        EXPECT_EQ(versions.retired_versions(), 1);
+    }
+    const OctreeVersions::Version latest = versions.acquire();
+    EXPECT_EQ(latest.number, versions.version());
+    EXPECT_EQ(content(latest.root), content(versions.root()));
+    EXPECT_NE(content(latest.root), first_content);
+}
+
+TEST(OctreeVersions, ReaderThreadHoldsSnapshot) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    OctreeVersions versions(root);
+    std::atomic<bool> writing{true};
+    std::size_t checks = 0;
+    std::thread reader([&] {
+        const OctreeVersions::Version held = versions.acquire();
+        const std::vector<std::uint32_t> held_content = content(held.root);
+        const std::vector<Polygon> held_polygons = polygons(held.root);
+        while (writing || checks == 0) {
+            // the reader updates the polygon caches of its copy while the writer changes the working octree
+            EXPECT_EQ(content(held.root), held_content);
+            EXPECT_EQ(polygons(held.root), held_polygons);
+            // a newer version does not change while it is read either
+            const OctreeVersions::Version latest = versions.acquire();
+            EXPECT_GE(latest.number, held.number);
+            const std::vector<std::uint32_t> latest_content = content(latest.root);
+            (void)polygons(latest.root);
+            EXPECT_EQ(content(latest.root), latest_content);
+            checks++;
+        }
+    });
+    std::mt19937 random(2);
+    for (int version = 0; version < 200; version++) {
+        for (int edit = 0; edit < 5; edit++) {
+            random_edit(versions.root(), random);
+        }
+        (void)versions.publish();
+    }
+    writing = false;
+    reader.join();
+    EXPECT_GT(checks, 0);
+    EXPECT_EQ(versions.version(), 201);
+    EXPECT_EQ(versions.retired_versions(), 0);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,72 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/polygon_batch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+struct BatchCube {
+    Cube::Type type;
+    glm::vec3 position;
+    float size;
+    std::array<Indentation, Cube::EDGES> indentations;
+};
+
+/// Compare every cube of a batch with CubePool::build_polygons().
+void expect_equal_to_build_polygons(const std::vector<BatchCube> &cubes) {
+    PolygonBatch batch;
+    for (const BatchCube &cube : cubes) {
+        batch.add(cube.type, cube.position, cube.size, cube.indentations);
+    }
+    batch.build();
+    ASSERT_EQ(batch.size(), cubes.size());
+    for (std::size_t cube = 0; cube < cubes.size(); cube++) {
+        const BatchCube &added = cubes[cube];
+        const CubePolygons expected =
+            CubePool::build_polygons(added.type, added.position, added.size, added.indentations);
+        const CubePolygons polygons = batch.polygons(cube);
+        ASSERT_EQ(polygons.size(), expected.size()) << "cube " << cube;
+        for (std::size_t polygon = 0; polygon < polygons.size(); polygon++) {
+            EXPECT_EQ(polygons[polygon], expected[polygon]) << "cube " << cube << ", polygon " << polygon;
+        }
+    }
+}
+
+TEST(PolygonBatch, EqualToBuildPolygons) {
+    std::mt19937 random(9);
+    std::uniform_int_distribution<int> uid(0, Indentation::MAX_UID);
+    std::uniform_real_distribution<float> coordinate(-100.0F, 100.0F);
+    std::uniform_int_distribution<int> size_exponent(-3, 4);
+    std::vector<BatchCube> cubes;
+    for (int i = 0; i < 203; i++) {
+        BatchCube cube{random() % 8 == 0 ? Cube::Type::SOLID : Cube::Type::NORMAL,
+                       {coordinate(random), coordinate(random), coordinate(random)},
+                       std::ldexp(1.0F, size_exponent(random)),
+                       {}};
+        if (cube.type == Cube::Type::NORMAL) {
+            for (Indentation &indentation : cube.indentations) {
+                indentation = Indentation(static_cast<std::uint8_t>(uid(random)));
+            }
+        }
+        cubes.push_back(cube);
+    }
+    // With SSE2 the cubes are built in blocks of four, the last three cubes by the scalar path.
+    expect_equal_to_build_polygons(cubes);
+    // Only the scalar path.
+    for (std::size_t count = 1; count < 4; count++) {
+        expect_equal_to_build_polygons({cubes.end() - static_cast<std::ptrdiff_t>(count), cubes.end()});
+    }
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
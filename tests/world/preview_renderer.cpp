@@ -0,0 +1,85 @@
+#include "inexor/vulkan-renderer/camera.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/preview_renderer.hpp"
+#include "inexor/vulkan-renderer/world/ray_cast.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Random octants, solid and indented cubes, with an empty first child for a camera inside of the octree.
+Cube random_octree() {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    std::mt19937 random(5);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    std::uniform_int_distribution<int> type(0, 3);
+    std::uniform_int_distribution<int> steps(1, 3);
+    for (int edit = 0; edit < 60; edit++) {
+        Cube cube = root;
+        while (cube.type() == Cube::Type::OCTANT) {
+            cube = cube[child_id(random)];
+        }
+        cube.set_type(static_cast<Cube::Type>(type(random)));
+        if (cube.type() == Cube::Type::NORMAL) {
+            cube.indent(static_cast<std::uint8_t>(child_id(random)), random() % 2 == 0,
+                        static_cast<std::uint8_t>(steps(random)));
+        }
+    }
+    root[0].set_type(Cube::Type::EMPTY);
+    return root;
+}
+
+/// Compare every pixel of the image with a ray cast through its center.
+void expect_hits_equal_to_ray_cast(const Cube &cube, const Camera &camera) {
+    // An odd number of packets per row and column, so if the camera looks along a plane of two axes, the packets in
+    // the middle of the image contain rays with different signs, which are traversed separately.
+    constexpr std::uint32_t WIDTH{30};
+    constexpr std::uint32_t HEIGHT{22};
+    PreviewRenderer renderer(2);
+    renderer.set_background_color({1.0F, 0.0F, 0.0F});
+    renderer.set_geometry_color({0.0F, 1.0F, 0.0F});
+    const PreviewImage image = renderer.render(cube, camera, WIDTH, HEIGHT);
+    ASSERT_EQ(image.pixels.size(), std::size_t{4} * WIDTH * HEIGHT);
+
+    const glm::vec3 front = glm::normalize(camera.front());
+    const glm::vec3 right = glm::normalize(glm::cross(front, camera.up()));
+    const glm::vec3 up = glm::cross(right, front);
+    const float screen_height = std::tan(glm::radians(camera.fov()) / 2.0F);
+    const float screen_width = screen_height * static_cast<float>(WIDTH) / static_cast<float>(HEIGHT);
+    std::size_t hit_count = 0;
+    for (std::uint32_t y = 0; y < HEIGHT; y++) {
+        for (std::uint32_t x = 0; x < WIDTH; x++) {
+            const float screen_x = 2.0F * (static_cast<float>(x) + 0.5F) / static_cast<float>(WIDTH) - 1.0F;
+            const float screen_y = 1.0F - 2.0F * (static_cast<float>(y) + 0.5F) / static_cast<float>(HEIGHT);
+            const glm::vec3 direction =
+                glm::normalize(front + right * (screen_x * screen_width) + up * (screen_y * screen_height));
+            const bool hit = ray_cast(cube, camera.position(), direction, camera.far_plane()).has_value();
+            // the green channel is only set by geometry
+            EXPECT_EQ(image.pixels[4 * (std::size_t{y} * WIDTH + x) + 1] != 0, hit) << "pixel " << x << ", " << y;
+            hit_count += hit ? 1 : 0;
+        }
+    }
+    // both hits and misses are compared
+    EXPECT_GT(hit_count, 0);
+    EXPECT_LT(hit_count, std::size_t{WIDTH} * HEIGHT);
+}
+
+TEST(PreviewRenderer, HitsEqualRayCast) {
+    const Cube cube = random_octree();
+    // outside of the octree, looking down at it along the plane x = 4
+    expect_hits_equal_to_ray_cast(cube, Camera({4.0F, -6.0F, 6.0F}, 0.0F, -30.0F, 30.0F, 22.0F));
+    // from a corner, all directions are negative in the middle of the image
+    expect_hits_equal_to_ray_cast(cube, Camera({12.0F, 12.0F, 12.0F}, 225.0F, -35.0F, 30.0F, 22.0F));
+    // inside of the octree
+    expect_hits_equal_to_ray_cast(cube, Camera({1.0F, 1.2F, 0.9F}, 45.0F, 20.0F, 30.0F, 22.0F));
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
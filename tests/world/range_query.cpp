@@ -0,0 +1,196 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+#include "inexor/vulkan-renderer/world/range_query.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Random octants, solid and indented cubes.
+Cube random_octree(const std::uint32_t seed) {
+    Cube root(8.0F, {0.0F, 0.0F, 0.0F});
+    root.set_type(Cube::Type::OCTANT);
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<std::size_t> child_id(0, Cube::SUB_CUBES - 1);
+    std::uniform_int_distribution<int> type(0, 3);
+    std::uniform_int_distribution<int> steps(1, 3);
+    for (int edit = 0; edit < 200; edit++) {
+        Cube cube = root;
+        while (cube.type() == Cube::Type::OCTANT && cube.grid_level() < 4) {
+            cube = cube[child_id(random)];
+        }
+        cube.set_type(static_cast<Cube::Type>(type(random)));
+        if (cube.type() == Cube::Type::NORMAL) {
+            cube.indent(static_cast<std::uint8_t>(child_id(random)), random() % 2 == 0,
+                        static_cast<std::uint8_t>(steps(random)));
+        }
+    }
+    return root;
+}
+
+/// The geometry cubes within the shape, found by testing all leaf cubes.
+template <typename Shape>
+std::vector<CubePool::Index> brute_force_cubes(const Cube &root, const Shape &shape) {
+    const CubePool &pool = *root.pool();
+    std::vector<CubePool::Index> cubes;
+    visit_pre_order(pool, root.index(), [&](const TraversalNode &node) {
+        if (pool.type(node.index) != Cube::Type::OCTANT && pool.type(node.index) != Cube::Type::EMPTY &&
+            intersects(shape, node.position, node.size)) {
+            cubes.push_back(node.index);
+        }
+        return true;
+    });
+    return cubes;
+}
+
+template <typename Shape>
+std::vector<CubePool::Index> queried_cubes(const Cube &root, const Shape &shape) {
+    std::vector<CubePool::Index> cubes;
+    query_cubes(root, shape, [&](const TraversalNode &node) { cubes.push_back(node.index); });
+    return cubes;
+}
+
+float area(const Polygon &triangle) {
+    return glm::length(glm::cross(triangle[1] - triangle[0], triangle[2] - triangle[0])) / 2.0F;
+}
+
+bool contains(const Box &box, const glm::vec3 &point) {
+    constexpr float EPSILON{1e-4F};
+    for (int axis = 0; axis < 3; axis++) {
+        if (point[axis] < box.min[axis] - EPSILON || point[axis] > box.max[axis] + EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(RangeQuery, CubesInBoxAndSphere) {
+    const Cube root = random_octree(1);
+    std::mt19937 random(2);
+    std::uniform_real_distribution<float> coordinate(-1.0F, 9.0F);
+    std::uniform_real_distribution<float> extent(0.0F, 4.0F);
+    std::size_t found = 0;
+    for (int query = 0; query < 50; query++) {
+        const glm::vec3 corner(coordinate(random), coordinate(random), coordinate(random));
+        const Box box{corner, corner + glm::vec3(extent(random), extent(random), extent(random))};
+        const std::vector<CubePool::Index> box_cubes = queried_cubes(root, box);
+        EXPECT_EQ(box_cubes, brute_force_cubes(root, box)) << "query " << query;
+
+        const Sphere sphere{corner, extent(random)};
+        const std::vector<CubePool::Index> sphere_cubes = queried_cubes(root, sphere);
+        EXPECT_EQ(sphere_cubes, brute_force_cubes(root, sphere)) << "query " << query;
+        found += box_cubes.size() + sphere_cubes.size();
+    }
+    EXPECT_GT(found, 0);
+}
+
+TEST(RangeQuery, IntersectsCube) {
+    EXPECT_TRUE(intersects(Box{{1.0F, 1.0F, 1.0F}, {2.0F, 2.0F, 2.0F}}, {0.0F, 0.0F, 0.0F}, 4.0F));
+    // touching
+    EXPECT_TRUE(intersects(Box{{4.0F, 0.0F, 0.0F}, {5.0F, 1.0F, 1.0F}}, {0.0F, 0.0F, 0.0F}, 4.0F));
+    EXPECT_FALSE(intersects(Box{{4.5F, 0.0F, 0.0F}, {5.0F, 1.0F, 1.0F}}, {0.0F, 0.0F, 0.0F}, 4.0F));
+    EXPECT_TRUE(intersects(Sphere{{5.0F, 2.0F, 2.0F}, 1.0F}, {0.0F, 0.0F, 0.0F}, 4.0F));
+    // the sphere is near the corner of the bounding box, but not near the cube
+    EXPECT_FALSE(intersects(Sphere{{4.8F, 4.8F, 4.8F}, 1.0F}, {0.0F, 0.0F, 0.0F}, 4.0F));
+}
+
+TEST(RangeQuery, PolygonsClippedToBox) {
+    const Cube root = random_octree(3);
+    const CubePool &pool = *root.pool();
+    const Box box{{1.5F, 2.25F, 0.5F}, {6.0F, 5.5F, 4.75F}};
+    std::vector<CubePool::Index> cubes;
+    std::size_t triangles = 0;
+    query_polygons(root, box, [&](const TraversalNode &node, const Polygon &triangle) {
+        if (cubes.empty() || cubes.back() != node.index) {
+            cubes.push_back(node.index);
+        }
+        for (const glm::vec3 &corner : triangle) {
+            EXPECT_TRUE(contains(box, corner)) << corner.x << " " << corner.y << " " << corner.z;
+        }
+        triangles++;
+    });
+    EXPECT_GT(triangles, 0);
+    // the polygons of the cubes are visited together and only if the cube is within the box
+    const std::vector<CubePool::Index> expected = brute_force_cubes(root, box);
+    EXPECT_TRUE(std::includes(expected.begin(), expected.end(), cubes.begin(), cubes.end()));
+
+    // a box around the whole octree does not clip anything
+    const Box all{{-1.0F, -1.0F, -1.0F}, {9.0F, 9.0F, 9.0F}};
+    float clipped_area = 0.0F;
+    query_polygons(root, all, [&](const TraversalNode &, const Polygon &triangle) { clipped_area += area(triangle); });
+    float full_area = 0.0F;
+    CubePolygons built_polygons;
+    visit_pre_order(pool, root.index(), [&](const TraversalNode &node) {
+        if (pool.type(node.index) != Cube::Type::OCTANT && pool.type(node.index) != Cube::Type::EMPTY) {
+            for (const Polygon &triangle : cube_polygons(pool, node, built_polygons)) {
+                full_area += area(triangle);
+            }
+        }
+        return true;
+    });
+    EXPECT_NEAR(clipped_area, full_area, full_area * 1e-5F);
+}
+
+TEST(RangeQuery, ClipTriangle) {
+    const Polygon triangle{glm::vec3(0.0F, 0.0F, 0.0F), glm::vec3(4.0F, 0.0F, 0.0F), glm::vec3(0.0F, 4.0F, 0.0F)};
+    std::array<Polygon, MAX_CLIPPED_TRIANGLES> clipped;
+    // the box cuts off the corner at the origin and the tip at (0, 4, 0)
+    const Box box{{1.0F, -1.0F, -1.0F}, {5.0F, 2.0F, 1.0F}};
+    const std::size_t count = clip(triangle, box, clipped);
+    ASSERT_GT(count, 0);
+    float clipped_area = 0.0F;
+    for (std::size_t i = 0; i < count; i++) {
+        for (const glm::vec3 &corner : clipped[i]) {
+            EXPECT_TRUE(contains(box, corner));
+        }
+        clipped_area += area(clipped[i]);
+    }
+    // the part of the triangle with x >= 1 and y <= 2: the triangle with x >= 1 minus the one with y > 2
+    EXPECT_NEAR(clipped_area, 4.5F - 0.5F, 1e-5F);
+
+    EXPECT_EQ(clip(triangle, Box{{5.0F, 5.0F, 5.0F}, {6.0F, 6.0F, 6.0F}}, clipped), 0);
+    ASSERT_EQ(clip(triangle, Box{{-1.0F, -1.0F, -1.0F}, {5.0F, 5.0F, 5.0F}}, clipped), 1);
+    EXPECT_NEAR(area(clipped[0]), area(triangle), 1e-5F);
+}
+
+TEST(RangeQuery, PolygonsInSphere) {
+    const Cube root = random_octree(4);
+    const CubePool &pool = *root.pool();
+    const Sphere sphere{{4.0F, 3.5F, 4.5F}, 2.5F};
+    std::vector<Polygon> triangles;
+    query_polygons(root, sphere,
+                   [&](const TraversalNode &, const Polygon &triangle) { triangles.push_back(triangle); });
+    std::vector<Polygon> expected;
+    CubePolygons built_polygons;
+    visit_pre_order(pool, root.index(), [&](const TraversalNode &node) {
+        if (pool.type(node.index) != Cube::Type::OCTANT && pool.type(node.index) != Cube::Type::EMPTY) {
+            for (const Polygon &triangle : cube_polygons(pool, node, built_polygons)) {
+                if (intersects(sphere, triangle)) {
+                    expected.push_back(triangle);
+                }
+            }
+        }
+        return true;
+    });
+    EXPECT_GT(expected.size(), 0);
+    EXPECT_EQ(triangles, expected);
+
+    const Polygon triangle{glm::vec3(0.0F, 0.0F, 0.0F), glm::vec3(4.0F, 0.0F, 0.0F), glm::vec3(0.0F, 4.0F, 0.0F)};
+    EXPECT_TRUE(intersects(Sphere{{1.0F, 1.0F, 0.5F}, 1.0F}, triangle));
+    // near the hypotenuse and above the plane of the triangle, but not near the triangle
+    EXPECT_FALSE(intersects(Sphere{{3.0F, 3.0F, 0.0F}, 1.0F}, triangle));
+    EXPECT_TRUE(intersects(Sphere{{2.5F, 2.5F, 0.0F}, 1.0F}, triangle));
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,84 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_pool.hpp"
+#include "inexor/vulkan-renderer/world/ray_cast.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <optional>
+#include <random>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Distance along the ray to the polygon, without culling.
+std::optional<float> intersect(const glm::vec3 &origin, const glm::vec3 &direction, const Polygon &polygon) {
+    const glm::vec3 edge1 = polygon[1] - polygon[0];
+    const glm::vec3 edge2 = polygon[2] - polygon[0];
+    const glm::vec3 p = glm::cross(direction, edge2);
+    const float determinant = glm::dot(edge1, p);
+    if (std::abs(determinant) < 1e-7F) {
+        return std::nullopt;
+    }
+    const glm::vec3 s = origin - polygon[0];
+    const float u = glm::dot(s, p) / determinant;
+    const glm::vec3 q = glm::cross(s, edge1);
+    const float v = glm::dot(direction, q) / determinant;
+    if (u < 0.0F || v < 0.0F || u + v > 1.0F) {
+        return std::nullopt;
+    }
+    return glm::dot(edge2, q) / determinant;
+}
+
+TEST(RayCast, SolidPolygonIsTheHitTriangle) {
+    Cube cube(2.0F, {0.0F, 0.0F, 0.0F});
+    const CubePolygons polygons = CubePool::build_polygons(Cube::Type::SOLID, cube.position(), cube.size(), {});
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(0.01F, 1.99F);
+    for (int i = 0; i < 1000; i++) {
+        const glm::vec3 target{coordinate(random), coordinate(random), coordinate(random)};
+        const glm::vec3 origin = target + glm::normalize(glm::vec3{coordinate(random) - 1.0F, coordinate(random) - 1.0F,
+                                                                   coordinate(random) - 1.0F}) *
+                                              5.0F;
+        const glm::vec3 direction = target - origin;
+        const std::optional<RayHit> hit = ray_cast(cube, origin, direction);
+        ASSERT_TRUE(hit);
+        // the closest polygon found by brute force
+        std::optional<float> closest;
+        std::size_t closest_polygon = 0;
+        for (std::size_t polygon = 0; polygon < polygons.size(); polygon++) {
+            const std::optional<float> distance = intersect(origin, direction, polygons[polygon]);
+            if (distance && *distance >= 0.0F && (!closest || *distance < *closest)) {
+                closest = distance;
+                closest_polygon = polygon;
+            }
+        }
+        ASSERT_TRUE(closest);
+        EXPECT_NEAR(hit->distance, *closest, 1e-4F);
+        EXPECT_EQ(hit->face, closest_polygon / 2);
+        // points on the diagonal belong to both polygons
+        const std::optional<float> other = intersect(origin, direction, polygons[closest_polygon ^ 1U]);
+        if (!other || std::abs(*other - *closest) > 1e-4F) {
+            EXPECT_EQ(hit->polygon, closest_polygon);
+        }
+    }
+}
+
+TEST(RayCast, ClosestEdge) {
+    Cube cube(2.0F, {0.0F, 0.0F, 0.0F});
+    // face x = 0 close to the edge along z at y = 0
+    std::optional<RayHit> hit = ray_cast(cube, {-1.0F, 0.1F, 1.0F}, {1.0F, 0.0F, 0.0F});
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit->face, 0);
+    EXPECT_EQ(hit->edge, 2);
+    // face z = 1 close to the edge along x at y = 2
+    hit = ray_cast(cube, {1.0F, 1.9F, 3.0F}, {0.0F, 0.0F, -1.0F});
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit->face, 5);
+    EXPECT_EQ(hit->edge, 6);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
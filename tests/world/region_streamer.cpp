@@ -0,0 +1,127 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/region_streamer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+constexpr float REGION_SIZE{8.0F};
+
+/// A temporary directory with the files of the regions (0, 0, 0), (1, 0, 0) and (2, 0, 0).
+class RegionStreamerTest : public ::testing::Test {
+protected:
+    const std::filesystem::path m_directory{std::filesystem::temp_directory_path() / "inexor_region_streamer_test"};
+
+    void SetUp() override {
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+        Cube root(REGION_SIZE, {0.0F, 0.0F, 0.0F});
+        root.set_type(Cube::Type::OCTANT);
+        root[1].set_type(Cube::Type::EMPTY);
+        root[4].set_type(Cube::Type::NORMAL);
+        root[4].indent(2, true, 3);
+        const RegionStreamer streamer(m_directory, REGION_SIZE, 0, 0);
+        for (std::int32_t x = 0; x < 3; x++) {
+            streamer.save({x, 0, 0}, root);
+        }
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_directory);
+    }
+};
+
+/// Update until all requested regions are loaded.
+RegionStreamer::Changes update_all(RegionStreamer &streamer, const glm::vec3 &camera_position,
+                                   const float load_distance) {
+    RegionStreamer::Changes all_changes;
+    do {
+        std::this_thread::yield();
+        const RegionStreamer::Changes changes = streamer.update(camera_position, load_distance);
+        all_changes.loaded.insert(all_changes.loaded.end(), changes.loaded.begin(), changes.loaded.end());
+        all_changes.unloaded.insert(all_changes.unloaded.end(), changes.unloaded.begin(), changes.unloaded.end());
+        all_changes.failed.insert(all_changes.failed.end(), changes.failed.begin(), changes.failed.end());
+    } while (streamer.pending_count() > 0);
+    return all_changes;
+}
+
+TEST_F(RegionStreamerTest, LoadsAndUnloadsAroundCamera) {
+    RegionStreamer streamer(m_directory, REGION_SIZE, std::numeric_limits<std::size_t>::max(), 0, 2);
+    RegionStreamer::Changes changes = update_all(streamer, {4.0F, 4.0F, 4.0F}, 2.0F);
+    ASSERT_EQ(changes.loaded.size(), 1);
+    EXPECT_EQ(changes.loaded[0], (RegionStreamer::RegionCoordinate{0, 0, 0}));
+    EXPECT_TRUE(changes.failed.empty());
+    ASSERT_EQ(streamer.regions().size(), 1);
+    const RegionStreamer::Region &region = streamer.regions().begin()->second;
+    EXPECT_EQ(region.root.position(), glm::vec3(0.0F));
+    EXPECT_EQ(region.root.count_geometry_cubes(), 7);
+    EXPECT_GT(region.mesher->polygon_count(), 0);
+    const std::size_t region_memory_usage = region.memory_usage;
+    EXPECT_EQ(streamer.memory_usage(), region_memory_usage);
+
+    // the region (1, 0, 0) is out of range
+    changes = update_all(streamer, {20.0F, 4.0F, 4.0F}, 2.0F);
+    ASSERT_EQ(changes.loaded.size(), 1);
+    EXPECT_EQ(changes.loaded[0], (RegionStreamer::RegionCoordinate{2, 0, 0}));
+    ASSERT_EQ(changes.unloaded.size(), 1);
+    EXPECT_EQ(changes.unloaded[0], (RegionStreamer::RegionCoordinate{0, 0, 0}));
+    ASSERT_EQ(streamer.regions().size(), 1);
+    EXPECT_EQ(streamer.regions().begin()->second.root.position(), glm::vec3(16.0F, 0.0F, 0.0F));
+    EXPECT_EQ(streamer.memory_usage(), region_memory_usage);
+}
+
+TEST_F(RegionStreamerTest, KeepsMemoryBudget) {
+    std::size_t region_memory_usage = 0;
+    {
+        RegionStreamer streamer(m_directory, REGION_SIZE, std::numeric_limits<std::size_t>::max(), 0);
+        static_cast<void>(update_all(streamer, {4.0F, 4.0F, 4.0F}, 1.0F));
+        region_memory_usage = streamer.memory_usage();
+    }
+    ASSERT_GT(region_memory_usage, 0);
+
+    // before any region is loaded, only the estimated number of regions is requested
+    const std::size_t budget = region_memory_usage * 3 / 2;
+    RegionStreamer streamer(m_directory, REGION_SIZE, budget, region_memory_usage, 2);
+    static_cast<void>(streamer.update({12.0F, 4.0F, 4.0F}, 10.0F));
+    EXPECT_EQ(streamer.pending_count(), 1);
+    const RegionStreamer::Changes changes = update_all(streamer, {12.0F, 4.0F, 4.0F}, 10.0F);
+    ASSERT_EQ(changes.loaded.size(), 1);
+    EXPECT_EQ(changes.loaded[0], (RegionStreamer::RegionCoordinate{1, 0, 0}));
+    EXPECT_LE(streamer.memory_usage(), budget);
+
+    // a smaller budget unloads the farthest regions
+    RegionStreamer small_streamer(m_directory, REGION_SIZE, region_memory_usage, region_memory_usage / 8);
+    static_cast<void>(update_all(small_streamer, {12.0F, 4.0F, 4.0F}, 10.0F));
+    EXPECT_LE(small_streamer.memory_usage(), region_memory_usage);
+    EXPECT_EQ(small_streamer.regions().count({1, 0, 0}), 1);
+}
+
+TEST_F(RegionStreamerTest, UnreadableRegionsAreEmpty) {
+    RegionStreamer streamer(m_directory, REGION_SIZE, std::numeric_limits<std::size_t>::max(), 0);
+    // a file which is not an octree
+    std::ofstream(streamer.region_path({1, 0, 0}), std::ios::binary) << "broken";
+    RegionStreamer::Changes changes = update_all(streamer, {12.0F, 4.0F, 4.0F}, 2.0F);
+    ASSERT_EQ(changes.failed.size(), 1);
+    EXPECT_EQ(changes.failed[0], (RegionStreamer::RegionCoordinate{1, 0, 0}));
+    ASSERT_EQ(streamer.regions().count({1, 0, 0}), 1);
+    EXPECT_EQ(streamer.regions().at({1, 0, 0}).root.type(), Cube::Type::EMPTY);
+
+    // the file system fails to check a name which is too long, the region fails instead of the loader thread
+    RegionStreamer long_name_streamer(m_directory / std::string(1000, 'x'), REGION_SIZE,
+                                      std::numeric_limits<std::size_t>::max(), 0);
+    changes = update_all(long_name_streamer, {4.0F, 4.0F, 4.0F}, 2.0F);
+    ASSERT_EQ(changes.failed.size(), 1);
+    EXPECT_EQ(changes.failed[0], (RegionStreamer::RegionCoordinate{0, 0, 0}));
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world
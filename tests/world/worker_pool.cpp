@@ -0,0 +1,64 @@
+#include "inexor/vulkan-renderer/world/worker_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+
+TEST(WorkerPool, RunsEveryIterationOnce) {
+    WorkerPool workers(4);
+    EXPECT_EQ(workers.thread_count(), 4);
+    EXPECT_EQ(WorkerPool(0).thread_count(), 1);
+    // the threads are reused by every call
+    for (const std::size_t count : {0, 1, 3, 1000}) {
+        std::vector<std::atomic<int>> calls(count);
+        workers.parallel_for(count, [&](const std::size_t i) { calls[i]++; });
+        for (std::size_t i = 0; i < count; i++) {
+            EXPECT_EQ(calls[i], 1) << "iteration " << i << " of " << count;
+        }
+    }
+}
+
+TEST(WorkerPool, RethrowsFirstException) {
+    WorkerPool workers(3);
+    std::atomic<std::size_t> calls{0};
+    EXPECT_THROW(workers.parallel_for(1000,
+                                      [&](const std::size_t i) {
+                                          calls++;
+                                          if (i == 10) {
+                                              throw std::runtime_error("iteration 10");
+                                          }
+                                      }),
+                 std::runtime_error);
+    EXPECT_LT(calls, 1000);
+    // the pool is usable afterwards
+    calls = 0;
+    workers.parallel_for(100, [&](const std::size_t) { calls++; });
+    EXPECT_EQ(calls, 100);
+}
+
+TEST(WorkerPool, SharedByThreads) {
+    WorkerPool workers(3);
+    std::atomic<std::size_t> calls{0};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&] {
+            for (int call = 0; call < 50; call++) {
+                workers.parallel_for(20, [&](const std::size_t) { calls++; });
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(calls, 4 * 50 * 20);
+}
+
+} // namespace
+} // namespace inexor::vulkan_renderer::world